@@ -0,0 +1,174 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <yave/assets/FolderAssetStore.h>
+#include <yave/assets/PackedAssetStore.h>
+#include <yave/utils/filesystem.h>
+
+#include <y/io2/Buffer.h>
+#include <y/io2/File.h>
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <algorithm>
+
+// Imports many copies of the same payloads in a folder store and measures how much actually reaches the disk,
+// then checks that duplicates stay independent and can be found by content after reopening and converting the store
+
+using namespace yave;
+
+static constexpr usize unique_count = 100;
+static constexpr usize copy_count = 20;
+static constexpr usize payload_size = 64 * 1024;
+static const core::String folder_root = "bench_dedup_store";
+static const core::String pack_root = "bench_dedup_store.pack";
+
+static std::unique_ptr<io2::Buffer> payload(usize index) {
+    core::Vector<u8> data(payload_size, u8(0));
+    for(usize i = 0; i != payload_size; ++i) {
+        data[i] = u8(index * 13 + i / 7);
+    }
+    auto buffer = std::make_unique<io2::Buffer>();
+    buffer->write_array(data.data(), data.size()).unwrap();
+    buffer->reset();
+    return buffer;
+}
+
+static bool check_payload(const AssetStore& store, AssetId id, usize index) {
+    auto reader = store.data(id);
+    if(!reader) {
+        return false;
+    }
+    core::Vector<byte> data;
+    reader.unwrap()->read_all(data).unwrap();
+    if(data.size() != payload_size) {
+        return false;
+    }
+    for(usize i = 0; i != payload_size; ++i) {
+        if(u8(data[i]) != u8(index * 13 + i / 7)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static core::String asset_name(usize index, usize copy) {
+    return fmt("copy_%/asset_%", copy, index);
+}
+
+// Hard linked files are only counted once
+static u64 disk_usage(const core::String& root) {
+    u64 total = 0;
+    core::Vector<fs::path> counted;
+    for(const auto& entry : fs::directory_iterator(fs::path(root.data()))) {
+        if(!entry.is_regular_file() || entry.path().extension() != ".asset") {
+            continue;
+        }
+        const bool shared = std::any_of(counted.begin(), counted.end(), [&](const fs::path& p) { return fs::equivalent(p, entry.path()); });
+        if(!shared) {
+            total += entry.file_size();
+            counted << entry.path();
+        }
+    }
+    return total;
+}
+
+static void check_lookup(const AssetStore& store, const core::Vector<AssetId>& ids) {
+    for(usize i = 0; i != unique_count; ++i) {
+        auto data = payload(i);
+        const AssetId id = store.find_by_content(*data).unwrap();
+        y_always_assert(data->tell() == 0, "Reader was not rewound");
+        y_always_assert(check_payload(store, id, i), "Wrong asset found");
+        y_always_assert(i || id != ids[0], "Rewritten asset was found");
+    }
+    y_always_assert(store.find_by_content(*payload(unique_count)).is_error(), "Unknown content was found");
+}
+
+int main() {
+    const FileSystemModel* fs = FileSystemModel::local_filesystem();
+    fs->remove(folder_root).ignore();
+    fs->remove(pack_root).ignore();
+
+    core::Vector<AssetId> ids;
+    {
+        FolderAssetStore store(folder_root);
+        core::Chrono chrono;
+        for(usize copy = 0; copy != copy_count; ++copy) {
+            for(usize i = 0; i != unique_count; ++i) {
+                ids << store.import(*payload(i), asset_name(i, copy), AssetType::Mesh).unwrap();
+            }
+        }
+        log_msg(fmt("import: % ms", chrono.elapsed().to_millis()));
+
+        const u64 imported = u64(unique_count) * copy_count * payload_size;
+        const u64 stored = disk_usage(folder_root);
+        log_msg(fmt("imported % KB, stored % KB", imported / 1024, stored / 1024));
+        y_always_assert(stored == u64(unique_count) * payload_size, "Duplicates were not shared");
+
+        chrono.reset();
+        for(usize i = 0; i != unique_count; ++i) {
+            y_always_assert(store.find_by_content(*payload(i)).is_ok(), "Content not found");
+        }
+        log_msg(fmt("find_by_content: % us per lookup", chrono.elapsed().to_micros() / unique_count));
+
+        // Writing to a shared asset must not change its duplicates
+        y_always_assert(store.write(ids[0], *payload(unique_count + 1)).is_ok(), "Unable to write");
+        y_always_assert(check_payload(store, ids[0], unique_count + 1), "Write was lost");
+        for(usize copy = 1; copy != copy_count; ++copy) {
+            y_always_assert(check_payload(store, ids[copy * unique_count], 0), "Duplicate was modified");
+        }
+
+        // Removing a shared asset must not remove its duplicates
+        y_always_assert(store.remove(ids[1]).is_ok(), "Unable to remove");
+        y_always_assert(check_payload(store, ids[unique_count + 1], 1), "Duplicate was removed");
+
+        check_lookup(store, ids);
+    }
+
+    {
+        const FolderAssetStore store(folder_root);
+        check_lookup(store, ids);
+    }
+
+    {
+        // Any change to the root folder makes the index stale, hashes are then read back from the descs
+        const core::String dummy = fs->join(folder_root, "dummy");
+        y_always_assert(io2::File::create(dummy).is_ok() && fs->remove(dummy).is_ok(), "Unable to touch store");
+
+        const FolderAssetStore store(folder_root);
+        check_lookup(store, ids);
+
+        PackedAssetStore packed(pack_root);
+        y_always_assert(packed.import_store(store).is_ok(), "Unable to convert store");
+        check_lookup(packed, ids);
+    }
+
+    {
+        const PackedAssetStore store(pack_root);
+        check_lookup(store, ids);
+    }
+
+    fs->remove(folder_root).ignore();
+    fs->remove(pack_root).ignore();
+
+    return 0;
+}
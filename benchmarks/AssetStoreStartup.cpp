@@ -0,0 +1,184 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <yave/assets/FolderAssetStore.h>
+#include <yave/assets/PackedAssetStore.h>
+
+#include <y/io2/Buffer.h>
+#include <y/io2/File.h>
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+// Compares opening a folder store against a packed store holding the same assets,
+// then checks that the packed store survives writes, renames, removals and compaction
+
+using namespace yave;
+
+static constexpr usize asset_count = 50000;
+static constexpr usize folder_count = 100;
+static const core::String folder_root = "bench_store";
+static const core::String pack_root = "bench_store.pack";
+
+static std::unique_ptr<io2::Buffer> payload(usize index, usize size) {
+    auto buffer = std::make_unique<io2::Buffer>();
+    for(usize i = 0; i != size; ++i) {
+        buffer->write_one(u8(index * 7 + i)).unwrap();
+    }
+    buffer->reset();
+    return buffer;
+}
+
+static bool check_payload(const AssetStore& store, AssetId id, usize index, usize size) {
+    auto reader = store.data(id);
+    if(!reader) {
+        return false;
+    }
+    core::Vector<byte> data;
+    reader.unwrap()->read_all(data).unwrap();
+    if(data.size() != size) {
+        return false;
+    }
+    for(usize i = 0; i != size; ++i) {
+        if(u8(data[i]) != u8(index * 7 + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static core::String asset_name(usize index) {
+    return fmt("folder_%/asset_%", index % folder_count, index);
+}
+
+static usize asset_size(usize index) {
+    return 16 + index % 200;
+}
+
+static void check_store(const AssetStore& store, const core::Vector<AssetId>& ids) {
+    for(usize i = 0; i != asset_count; ++i) {
+        y_always_assert(store.id(asset_name(i)).unwrap() == ids[i], "Wrong id");
+        y_always_assert(store.asset_type(ids[i]).unwrap() == AssetType::Mesh, "Wrong type");
+        y_always_assert(check_payload(store, ids[i], i, asset_size(i)), "Wrong data");
+    }
+}
+
+int main() {
+    const FileSystemModel* fs = FileSystemModel::local_filesystem();
+    fs->remove(folder_root).ignore();
+    fs->remove(pack_root).ignore();
+
+    core::Vector<AssetId> ids;
+    {
+        FolderAssetStore store(folder_root);
+        core::Chrono chrono;
+        for(usize i = 0; i != asset_count; ++i) {
+            ids << store.import(*payload(i, asset_size(i)), asset_name(i), AssetType::Mesh).unwrap();
+        }
+        log_msg(fmt("folder store import: % ms", chrono.elapsed().to_millis()));
+    }
+
+    {
+        // Any change to the root folder makes the index stale
+        const core::String dummy = fs->join(folder_root, "dummy");
+        y_always_assert(io2::File::create(dummy).is_ok() && fs->remove(dummy).is_ok(), "Unable to touch store");
+
+        core::Chrono chrono;
+        const FolderAssetStore store(folder_root);
+        log_msg(fmt("folder store open (full scan): % ms", chrono.elapsed().to_millis()));
+        check_store(store, ids);
+    }
+
+    {
+        core::Chrono chrono;
+        const FolderAssetStore store(folder_root);
+        log_msg(fmt("folder store open (index): % ms", chrono.elapsed().to_millis()));
+        check_store(store, ids);
+
+        chrono.reset();
+        PackedAssetStore packed(pack_root);
+        y_always_assert(packed.import_store(store).is_ok(), "Unable to convert store");
+        log_msg(fmt("conversion: % ms", chrono.elapsed().to_millis()));
+    }
+
+    {
+        // The index must not be saved over changes made by someone else while the store was open
+        FolderAssetStore store(folder_root);
+        y_always_assert(store.write(ids[0], *payload(0, asset_size(0))).is_ok(), "Unable to write");
+
+        const core::String dummy = fs->join(folder_root, "dummy");
+        y_always_assert(io2::File::create(dummy).is_ok() && fs->remove(dummy).is_ok(), "Unable to touch store");
+    }
+    y_always_assert(!fs->exists(fs->join(fs->join(folder_root, ".cache"), "index")).unwrap_or(true), "Stale index was saved");
+
+    {
+        core::Chrono chrono;
+        const PackedAssetStore store(pack_root);
+        log_msg(fmt("packed store open: % ms", chrono.elapsed().to_millis()));
+        check_store(store, ids);
+    }
+
+    {
+        PackedAssetStore store(pack_root);
+        for(usize i = 0; i != asset_count; i += 10) {
+            y_always_assert(store.write(ids[i], *payload(i + 1, asset_size(i + 1))).is_ok(), "Unable to write");
+        }
+        for(usize i = 1; i < asset_count; i += 1000) {
+            y_always_assert(store.rename(asset_name(i), asset_name(i) + "_renamed").is_ok(), "Unable to rename");
+        }
+        y_always_assert(store.remove(ids[2]).is_ok(), "Unable to remove");
+        y_always_assert(store.filesystem()->create_directory("empty/folder").is_ok(), "Unable to create folder");
+        log_msg(fmt("wasted: % KB of % KB", store.wasted_size() / 1024, store.pack_size() / 1024));
+    }
+
+    {
+        core::Chrono chrono;
+        PackedAssetStore store(pack_root);
+        log_msg(fmt("packed store open with journal: % ms", chrono.elapsed().to_millis()));
+
+        auto check_edits = [&] {
+            for(usize i = 0; i != asset_count; ++i) {
+                const bool renamed = i % 1000 == 1;
+                const core::String name = renamed ? asset_name(i) + "_renamed" : asset_name(i);
+                if(i == 2) {
+                    y_always_assert(store.id(name).is_error() && store.data(ids[i]).is_error(), "Asset was not removed");
+                    continue;
+                }
+                const usize index = i % 10 ? i : i + 1;
+                y_always_assert(store.id(name).unwrap() == ids[i], "Wrong id");
+                y_always_assert(check_payload(store, ids[i], index, asset_size(index)), "Wrong data");
+            }
+            y_always_assert(store.filesystem()->is_directory("empty/folder").unwrap(), "Folder was lost");
+        };
+        check_edits();
+
+        const usize pack_size = store.pack_size();
+        y_always_assert(store.compact().is_ok(), "Unable to compact");
+        y_always_assert(store.pack_size() < pack_size && !store.wasted_size(), "Compaction did not reclaim space");
+        log_msg(fmt("compacted from % KB to % KB", pack_size / 1024, store.pack_size() / 1024));
+        check_edits();
+    }
+
+    fs->remove(folder_root).ignore();
+    fs->remove(pack_root).ignore();
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/ecs/EntityWorld.h>
+#include <yave/ecs/EntityScene.h>
+
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <random>
+
+// Compares instantiating prefabs one entity and one component at a time against the batch API
+
+using namespace yave;
+
+namespace {
+
+struct Position {
+    math::Vec3 value;
+    y_reflect(Position, value)
+};
+
+struct Velocity {
+    math::Vec3 value;
+    y_reflect(Velocity, value)
+};
+
+struct Health {
+    float value = 100.0f;
+    y_reflect(Health, value)
+};
+
+struct Label {
+    core::String name;
+    y_reflect(Label, name)
+};
+
+}
+
+static ecs::EntityScene create_scene(usize entity_count) {
+    std::mt19937 rng(1);
+    core::Vector<ecs::EntityPrefab> prefabs;
+    for(usize i = 0; i != entity_count; ++i) {
+        ecs::EntityPrefab prefab;
+        prefab.add(Position{math::Vec3(float(i), 0.0f, 0.0f)});
+        if(rng() % 2) {
+            prefab.add(Velocity{math::Vec3(0.0f, 1.0f, 0.0f)});
+        }
+        if(rng() % 4) {
+            prefab.add(Health{float(rng() % 100)});
+        }
+        if(rng() % 8 == 0) {
+            prefab.add(Label{fmt("entity %", i)});
+        }
+        prefabs.emplace_back(std::move(prefab));
+    }
+    return ecs::EntityScene(std::move(prefabs));
+}
+
+template<typename F>
+static double time_best(F&& func) {
+    const usize iterations = 5;
+    double best = std::numeric_limits<double>::max();
+    for(usize i = 0; i != iterations; ++i) {
+        ecs::EntityWorld world;
+        core::Chrono chrono;
+        func(world);
+        best = std::min(best, chrono.elapsed().to_millis());
+    }
+    return best;
+}
+
+static void check_same(const ecs::EntityWorld& a, const ecs::EntityWorld& b) {
+    y_always_assert(a.entity_count() == b.entity_count(), "Entity count mismatch");
+    y_always_assert(a.component_ids<Position>().size() == b.component_ids<Position>().size(), "Component count mismatch");
+    y_always_assert(a.component_ids<Velocity>().size() == b.component_ids<Velocity>().size(), "Component count mismatch");
+    y_always_assert(a.component_ids<Health>().size() == b.component_ids<Health>().size(), "Component count mismatch");
+    y_always_assert(a.component_ids<Label>().size() == b.component_ids<Label>().size(), "Component count mismatch");
+    for(const ecs::EntityId id : a.component_ids<Label>()) {
+        y_always_assert(a.component<Label>(id)->name == b.component<Label>(id)->name, "Component mismatch");
+    }
+}
+
+int main() {
+    const usize entity_count = 100000;
+
+    const ecs::EntityScene scene = create_scene(entity_count);
+
+    {
+        ecs::EntityWorld serial;
+        ecs::EntityWorld batched;
+        for(const ecs::EntityPrefab& prefab : scene.prefabs()) {
+            serial.create_entity(prefab);
+        }
+        batched.instantiate(scene);
+        check_same(serial, batched);
+    }
+
+    const double serial_scene = time_best([&](ecs::EntityWorld& world) {
+        for(const ecs::EntityPrefab& prefab : scene.prefabs()) {
+            world.create_entity(prefab);
+        }
+    });
+    const double batched_scene = time_best([&](ecs::EntityWorld& world) {
+        world.instantiate(scene);
+    });
+
+    const ecs::EntityPrefab& prefab = scene.prefabs()[0];
+    const double serial_prefab = time_best([&](ecs::EntityWorld& world) {
+        for(usize i = 0; i != entity_count; ++i) {
+            world.create_entity(prefab);
+        }
+    });
+    const double batched_prefab = time_best([&](ecs::EntityWorld& world) {
+        world.create_entities(prefab, entity_count);
+    });
+
+    log_msg(fmt("% entity scene", entity_count));
+    log_msg(fmt("    create_entity: % ms", serial_scene));
+    log_msg(fmt("    instantiate:   % ms (x%)", batched_scene, serial_scene / batched_scene));
+    log_msg(fmt("% copies of a prefab", entity_count));
+    log_msg(fmt("    create_entity:   % ms", serial_prefab));
+    log_msg(fmt("    create_entities: % ms (x%)", batched_prefab, serial_prefab / batched_prefab));
+
+    return 0;
+}
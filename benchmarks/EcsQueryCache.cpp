@@ -0,0 +1,123 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/ecs/EntityWorld.h>
+
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+// Compares matching a query from scratch every time against a cached query kept by the world
+
+using namespace yave;
+
+namespace {
+
+struct Position {
+    math::Vec3 value;
+    y_reflect(Position, value)
+};
+
+struct Velocity {
+    math::Vec3 value;
+    y_reflect(Velocity, value)
+};
+
+struct Mass {
+    float value = 1.0f;
+    y_reflect(Mass, value)
+};
+
+}
+
+template<typename F>
+static double time_per_iteration(usize iterations, F&& func) {
+    core::Chrono chrono;
+    for(usize i = 0; i != iterations; ++i) {
+        func();
+    }
+    return chrono.elapsed().to_micros() / iterations;
+}
+
+int main() {
+    const usize entity_count = 100000;
+    const usize iterations = 200;
+
+    ecs::EntityWorld world;
+    core::Vector<ecs::EntityId> ids;
+    for(usize i = 0; i != entity_count; ++i) {
+        const ecs::EntityId id = (i % 3) ?
+            world.create_entity(ecs::StaticArchetype<Position, Velocity, Mass>()) :
+            world.create_entity(ecs::StaticArchetype<Position, Mass>());
+        if(i % 10 == 0) {
+            world.add_tag(id, ecs::tags::hidden);
+        }
+        ids << id;
+    }
+
+    const std::array tags = {ecs::tags::not_hidden};
+
+    usize checksum = 0;
+    const double cold = time_per_iteration(iterations, [&] {
+        auto query = world.query<Position, Velocity, Mass>(tags);
+        checksum += query.size();
+    });
+
+    const double cached = time_per_iteration(iterations, [&] {
+        checksum += world.cached_query<Position, Velocity, Mass>(tags).size();
+    });
+
+    // Worst case for the cache: the world changes between every query
+    usize index = 0;
+    const double invalidated = time_per_iteration(iterations, [&] {
+        const ecs::EntityId id = ids[index++ % ids.size()];
+        if(world.has_tag(id, ecs::tags::hidden)) {
+            world.remove_tag(id, ecs::tags::hidden);
+        } else {
+            world.add_tag(id, ecs::tags::hidden);
+        }
+        checksum += world.cached_query<Position, Velocity, Mass>(tags).size();
+    });
+
+    // Cached queries are views of the cached match list: nothing is copied, and they are only valid until it is matched again
+    {
+        auto before = world.cached_query<Position, Velocity, Mass>(tags);
+        auto again = world.cached_query<Position, Velocity, Mass>(tags);
+        y_always_assert(before.is_view() && before.ids().data() == again.ids().data(), "Cached query was copied");
+
+        const usize before_size = before.size();
+        const ecs::EntityId first = before.ids()[0];
+        world.add_tag(first, ecs::tags::hidden);
+
+        const auto after = world.cached_query<Position, Velocity, Mass>(tags);
+        y_always_assert(after.size() + 1 == before_size, "Cached query was not matched again");
+        world.remove_tag(first, ecs::tags::hidden);
+    }
+
+    log_msg(fmt("% entities, % matching:", entity_count, world.cached_query<Position, Velocity, Mass>(tags).size()));
+    log_msg(fmt("    cold:        % us per query", cold));
+    log_msg(fmt("    cached:      % us per query (x%)", cached, cold / cached));
+    log_msg(fmt("    invalidated: % us per query", invalidated));
+    log_msg(fmt("    (checksum %)", checksum));
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/ecs/EntityWorld.h>
+
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <random>
+#include <algorithm>
+
+// Compares the batched query matching against the one id at a time reference
+
+using namespace yave;
+
+namespace {
+
+struct Position {
+    math::Vec3 value;
+    y_reflect(Position, value)
+};
+
+struct Velocity {
+    math::Vec3 value;
+    y_reflect(Velocity, value)
+};
+
+struct Mass {
+    float value = 1.0f;
+    y_reflect(Mass, value)
+};
+
+struct Frozen {
+    float time = 0.0f;
+    y_reflect(Frozen, time)
+};
+
+}
+
+using Matches = core::Vector<ecs::QueryUtils::SetMatch>;
+
+static double time_matching(bool batched, const Matches& matches, core::Span<ecs::EntityId> ids, core::Vector<ecs::EntityId>& result) {
+    const usize iterations = 20;
+    core::Chrono chrono;
+    for(usize i = 0; i != iterations; ++i) {
+        if(batched) {
+            ecs::QueryUtils::matching(matches, ids, result);
+        } else {
+            ecs::QueryUtils::matching_scalar(matches, ids, result);
+        }
+    }
+    return chrono.elapsed().to_millis() / iterations;
+}
+
+static void bench(const char* name, const Matches& matches, core::Span<ecs::EntityId> ids) {
+    core::Vector<ecs::EntityId> scalar_result;
+    core::Vector<ecs::EntityId> batched_result;
+    const double scalar = time_matching(false, matches, ids, scalar_result);
+    const double batched = time_matching(true, matches, ids, batched_result);
+
+    y_always_assert(scalar_result == batched_result, "Batched matching doesn't match the reference");
+
+    log_msg(fmt("%: % matches", name, batched_result.size()));
+    log_msg(fmt("    scalar:  % ms", scalar));
+    log_msg(fmt("    batched: % ms (x%)", batched, scalar / batched));
+}
+
+int main() {
+    const usize entity_count = 1000000;
+
+    ecs::EntityWorld world;
+    std::mt19937 rng(1);
+    for(usize i = 0; i != entity_count; ++i) {
+        const ecs::EntityId id = world.create_entity(ecs::StaticArchetype<Position>());
+        if(rng() % 4) {
+            world.add_component<Velocity>(id);
+        }
+        if(rng() % 2) {
+            world.add_component<Mass>(id);
+        }
+        if(rng() % 8 == 0) {
+            world.add_component<Frozen>(id);
+        }
+        if(rng() % 16 == 0) {
+            world.add_tag(id, ecs::tags::hidden);
+        }
+        if(rng() % 64 == 0) {
+            world.add_tag(id, ecs::tags::selected);
+        }
+    }
+
+    // Ids are matched against the other sets the same way queries do: starting from the smallest inclusive set
+    const core::Span<ecs::EntityId> ids = world.component_ids<Position>();
+
+    // Worlds that have seen a lot of adds and removes don't iterate their sets in index order
+    core::Vector<ecs::EntityId> shuffled_ids(ids);
+    std::shuffle(shuffled_ids.begin(), shuffled_ids.end(), rng);
+
+    const ecs::QueryUtils::SetMatch velocity = {&world.component_set<Velocity>(), true};
+    const ecs::QueryUtils::SetMatch mass = {&world.component_set<Mass>(), true};
+    const ecs::QueryUtils::SetMatch not_frozen = {&world.component_set<Frozen>(), false};
+    const ecs::QueryUtils::SetMatch not_hidden = {world.tag_set(ecs::tags::hidden), false};
+    const ecs::QueryUtils::SetMatch not_selected = {world.tag_set(ecs::tags::selected), false};
+
+    log_msg(fmt("% entities", entity_count));
+    for(const auto& [order, order_ids] : {std::pair{"sequential", ids}, std::pair{"shuffled", core::Span<ecs::EntityId>(shuffled_ids)}}) {
+        log_msg(fmt("% ids:", order));
+        bench("2 predicates", Matches({velocity, not_hidden}), order_ids);
+        bench("3 predicates", Matches({velocity, mass, not_hidden}), order_ids);
+        bench("5 predicates", Matches({velocity, mass, not_frozen, not_hidden, not_selected}), order_ids);
+    }
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/ecs/EntityWorld.h>
+
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <random>
+
+// Snapshot and restore of a world, as done when entering and leaving play mode in the editor
+
+using namespace yave;
+
+namespace {
+
+struct Transform {
+    math::Vec3 position;
+    math::Vec3 scale;
+    y_reflect(Transform, position, scale)
+};
+
+struct Velocity {
+    math::Vec3 velocity;
+    y_reflect(Velocity, velocity)
+};
+
+struct Name {
+    core::String name;
+    y_reflect(Name, name)
+};
+
+struct Health {
+    float health = 100.0f;
+    y_reflect(Health, health)
+};
+
+}
+
+static ecs::EntityWorld create_world(usize entity_count) {
+    ecs::EntityWorld world;
+    std::mt19937 rng(1);
+
+    const core::Vector<ecs::EntityId> ids = world.create_entities(entity_count);
+    for(const ecs::EntityId id : ids) {
+        world.add_component<Transform>(id);
+        if(rng() % 2) {
+            world.add_component<Velocity>(id);
+        }
+        if(rng() % 4 == 0) {
+            world.add_component<Name>(id)->name = fmt_to_owned("entity_%", id.index());
+        }
+        if(rng() % 8 == 0) {
+            world.add_component<Health>(id);
+        }
+        if(rng() % 16 == 0) {
+            world.add_tag(id, "enemy");
+        }
+    }
+    world.tick();
+    return world;
+}
+
+template<typename F>
+static double time_ms(usize iterations, F&& func) {
+    core::Chrono chrono;
+    for(usize i = 0; i != iterations; ++i) {
+        func();
+    }
+    return chrono.elapsed().to_millis() / iterations;
+}
+
+int main() {
+    const usize entity_count = 100000;
+    const usize iterations = 20;
+
+    ecs::EntityWorld world = create_world(entity_count);
+
+    const double copy_snapshot = time_ms(iterations, [&] {
+        const ecs::WorldSnapshot snapshot = world.snapshot();
+        unused(snapshot);
+    });
+
+    const ecs::WorldSnapshot snapshot = world.snapshot();
+    const double copy_restore = time_ms(iterations, [&] {
+        // Makes sure the world doesn't share anything with the snapshot
+        world.query<ecs::Mutate<Transform>, ecs::Mutate<Velocity>, ecs::Mutate<Name>, ecs::Mutate<Health>>();
+        world.restore(snapshot);
+    });
+
+    // Only the transforms change between two snapshots
+    const double cow_snapshot = time_ms(iterations, [&] {
+        world.query<ecs::Mutate<Transform>>();
+        const ecs::WorldSnapshot cow = world.snapshot(ecs::SnapshotMode::CopyOnWrite);
+        unused(cow);
+    });
+
+    const ecs::WorldSnapshot cow = world.snapshot(ecs::SnapshotMode::CopyOnWrite);
+    const double cow_restore = time_ms(iterations, [&] {
+        world.query<ecs::Mutate<Transform>>();
+        world.restore(cow);
+    });
+
+    // What snapshots had to go through before: one prefab per entity
+    const double prefab_snapshot = time_ms(1, [&] {
+        core::Vector<ecs::EntityPrefab> prefabs;
+        for(const ecs::EntityId id : world.ids()) {
+            prefabs.emplace_back(world.create_prefab(id));
+        }
+    });
+
+    log_msg(fmt("% entities:", world.entity_count()));
+    log_msg(fmt("    prefabs:             % ms", prefab_snapshot));
+    log_msg(fmt("    snapshot:            % ms", copy_snapshot));
+    log_msg(fmt("    restore:             % ms", copy_restore));
+    log_msg(fmt("    snapshot (cow):      % ms", cow_snapshot));
+    log_msg(fmt("    restore (cow):       % ms", cow_restore));
+
+    return 0;
+}
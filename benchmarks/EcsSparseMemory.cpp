@@ -0,0 +1,133 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/ecs/EntityWorld.h>
+
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <random>
+#include <utility>
+
+// Memory used by the sparse arrays of a world with many component types spread over a large range of entity indices
+
+using namespace yave;
+
+namespace {
+
+struct Transform {
+    math::Vec3 position;
+    y_reflect(Transform, position)
+};
+
+template<usize I>
+struct Rare {
+    u32 value = I;
+    y_reflect(Rare, value)
+};
+
+static constexpr usize rare_type_count = 60;
+static constexpr usize rare_entity_count = 3;
+static const std::array<const char*, 4> tags = {"hot", "cold", "dirty", "pinned"};
+
+}
+
+struct SetMemory {
+    usize flat = 0;
+    usize paged = 0;
+
+    void add(const ecs::SparseIdSetBase& set) {
+        u32 max_index = 0;
+        for(const ecs::EntityId id : set.ids()) {
+            max_index = std::max(max_index, id.index());
+        }
+        // A flat sparse array covers every index up to the highest one in the set
+        flat += set.is_empty() ? 0 : usize(max_index + 1) * sizeof(ecs::SparseIdSetBase::index_type);
+        // Tag sets also keep a bit per entity index, up to the highest one they ever held
+        paged += set.sparse_memory_usage() + set.presence_bits().size() * sizeof(u64);
+    }
+};
+
+template<usize... Is>
+static void add_rare_components(ecs::EntityWorld& world, core::Span<ecs::EntityId> ids, std::mt19937& rng, std::index_sequence<Is...>) {
+    const auto add = [&](auto tag) {
+        using component_type = typename decltype(tag)::type;
+        for(usize i = 0; i != rare_entity_count; ++i) {
+            world.add_component<component_type>(ids[rng() % ids.size()]);
+        }
+    };
+    (add(std::common_type<Rare<Is>>{}), ...);
+}
+
+template<usize... Is>
+static void add_rare_memory(const ecs::EntityWorld& world, SetMemory& memory, std::index_sequence<Is...>) {
+    (memory.add(world.component_set<Rare<Is>>()), ...);
+}
+
+template<usize... Is>
+static usize count_rare(const ecs::EntityWorld& world, std::index_sequence<Is...>) {
+    return (world.query<Transform, Rare<Is>>().size() + ...);
+}
+
+int main() {
+    const usize entity_count = 1000000;
+    const auto rare_types = std::make_index_sequence<rare_type_count>();
+
+    ecs::EntityWorld world;
+    std::mt19937 rng(1);
+
+    const core::Vector<ecs::EntityId> ids = world.create_entities(entity_count);
+    for(const ecs::EntityId id : ids) {
+        world.add_component<Transform>(id);
+    }
+
+    add_rare_components(world, ids, rng, rare_types);
+    for(const char* tag : tags) {
+        for(usize i = 0; i != rare_entity_count; ++i) {
+            world.add_tag(ids[rng() % ids.size()], tag);
+        }
+    }
+    world.tick();
+
+    SetMemory memory;
+    memory.add(world.component_set<Transform>());
+    add_rare_memory(world, memory, rare_types);
+    for(const char* tag : tags) {
+        memory.add(*world.tag_set(tag));
+    }
+
+    const usize iterations = 20;
+    usize matched = 0;
+    core::Chrono chrono;
+    for(usize i = 0; i != iterations; ++i) {
+        matched += count_rare(world, rare_types);
+    }
+    const double query_time = chrono.elapsed().to_millis() / iterations;
+
+    log_msg(fmt("% entities, % rare component types, % tags:", entity_count, rare_type_count, tags.size()));
+    log_msg(fmt("    flat sparse arrays:  % KB", memory.flat / 1024));
+    log_msg(fmt("    paged sparse arrays: % KB (x%)", memory.paged / 1024, double(memory.flat) / double(memory.paged)));
+    log_msg(fmt("    % rare queries: % ms (% matches)", rare_type_count, query_time, matched / iterations));
+
+    return 0;
+}
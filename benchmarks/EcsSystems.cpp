@@ -0,0 +1,139 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/ecs/EntityWorld.h>
+
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <cmath>
+
+// Headless world with synthetic systems, compares serial and parallel system scheduling
+
+using namespace yave;
+
+namespace {
+
+struct Position {
+    math::Vec3 value;
+    y_reflect(Position, value)
+};
+
+struct Velocity {
+    math::Vec3 value = math::Vec3(1.0f);
+    y_reflect(Velocity, value)
+};
+
+struct Mass {
+    float value = 1.0f;
+    y_reflect(Mass, value)
+};
+
+struct Health {
+    float value = 50.0f;
+    y_reflect(Health, value)
+};
+
+struct Color {
+    math::Vec4 value;
+    y_reflect(Color, value)
+};
+
+// Enough work per entity for the scheduling to not be the only thing measured
+static float burn(float x) {
+    for(usize i = 0; i != 16; ++i) {
+        x = std::sqrt(std::abs(x) + 1.0f) * 0.99f;
+    }
+    return x;
+}
+
+template<typename... Args>
+class SyntheticSystem : public ecs::System {
+    public:
+        template<typename F>
+        SyntheticSystem(const char* name, bool declare, F&& func) : ecs::System(name), _func(y_fwd(func)) {
+            if(declare) {
+                declare_access<Args...>();
+            }
+        }
+
+        void update(ecs::EntityWorld& world, float dt) override {
+            auto query = world.query<Args...>();
+            for(auto&& components : query.components()) {
+                std::apply([&](auto&... c) { _func(dt, c...); }, components);
+            }
+        }
+
+    private:
+        std::function<void(float, ecs::traits::component_type_t<Args>&...)> _func;
+};
+
+}
+
+static void add_systems(ecs::EntityWorld& world, bool declare) {
+    world.add_system<SyntheticSystem<ecs::Mutate<Position>, Velocity>>("Integrate", declare, [](float dt, Position& p, const Velocity& v) {
+        p.value += v.value * burn(dt);
+    });
+    world.add_system<SyntheticSystem<ecs::Mutate<Velocity>, Mass>>("Damping", declare, [](float dt, Velocity& v, const Mass& m) {
+        v.value *= burn(dt) / m.value;
+    });
+    world.add_system<SyntheticSystem<ecs::Mutate<Health>>>("Heal", declare, [](float dt, Health& h) {
+        h.value = std::min(100.0f, h.value + burn(dt));
+    });
+    world.add_system<SyntheticSystem<ecs::Mutate<Color>, Health>>("Tint", declare, [](float, Color& c, const Health& h) {
+        c.value = math::Vec4(burn(h.value) * 0.01f);
+    });
+    world.add_system<SyntheticSystem<ecs::Mutate<Mass>>>("Decay", declare, [](float dt, Mass& m) {
+        m.value = std::max(0.1f, m.value - burn(dt) * 0.001f);
+    });
+}
+
+static double run(bool parallel, usize entity_count, usize frames) {
+    ecs::EntityWorld world;
+    for(usize i = 0; i != entity_count; ++i) {
+        world.create_entity(ecs::StaticArchetype<Position, Velocity, Mass, Health, Color>());
+    }
+
+    add_systems(world, parallel);
+
+    core::Chrono chrono;
+    for(usize i = 0; i != frames; ++i) {
+        world.update(1.0f / 60.0f);
+    }
+    return chrono.elapsed().to_millis() / frames;
+}
+
+int main() {
+    const usize entity_count = 100000;
+    const usize frames = 50;
+
+    const double serial = run(false, entity_count, frames);
+    const double parallel = run(true, entity_count, frames);
+
+    log_msg(fmt("% entities, 5 systems:", entity_count));
+    log_msg(fmt("    serial:    % ms per frame", serial));
+    log_msg(fmt("    parallel:  % ms per frame (x%)", parallel, serial / parallel));
+
+    return 0;
+}
+
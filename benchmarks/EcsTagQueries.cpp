@@ -0,0 +1,127 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/ecs/EntityWorld.h>
+
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <limits>
+
+// Small queries filtered by tags, like the ones done by the renderer every frame
+
+using namespace yave;
+
+namespace {
+
+struct Light {
+    math::Vec3 color;
+    y_reflect(Light, color)
+};
+
+struct Shadow {
+    u32 resolution = 1024;
+    y_reflect(Shadow, resolution)
+};
+
+// A real world has many more component types
+template<usize I>
+struct Filler {
+    u32 value = I;
+    y_reflect(Filler, value)
+};
+
+static constexpr usize filler_type_count = 48;
+
+}
+
+template<usize... Is>
+static void add_fillers(ecs::EntityWorld& world, ecs::EntityId id, std::index_sequence<Is...>) {
+    (world.add_component<Filler<Is>>(id), ...);
+}
+
+// Best of a few runs, tag lookups are small compared to the noise
+template<typename F>
+static double time_us(usize iterations, F&& func) {
+    double best = std::numeric_limits<double>::max();
+    for(usize run = 0; run != 5; ++run) {
+        usize matched = 0;
+        core::Chrono chrono;
+        for(usize i = 0; i != iterations; ++i) {
+            matched += func();
+        }
+        y_always_assert(matched, "Nothing matched");
+        best = std::min(best, chrono.elapsed().to_micros() / iterations);
+    }
+    return best;
+}
+
+int main() {
+    const usize entity_count = 64;
+    const usize iterations = 100000;
+
+    ecs::EntityWorld world;
+    add_fillers(world, world.create_entity(), std::make_index_sequence<filler_type_count>());
+    for(usize i = 0; i != entity_count; ++i) {
+        const ecs::EntityId id = world.create_entity();
+        if(i % 4 == 0) {
+            world.add_component<Light>(id);
+            if(i % 8 == 0) {
+                world.add_component<Shadow>(id);
+            }
+        }
+        if(i % 5 == 0) {
+            world.add_tag(id, ecs::tags::hidden);
+        }
+        world.add_tag(id, fmt("group_%", i % 20));
+    }
+
+    const double handle = time_us(iterations, [&] {
+        const std::array tags = {ecs::tags::not_hidden};
+        return world.query<Light>(tags).size();
+    });
+
+    const double string = time_us(iterations, [&] {
+        const std::array tags = {ecs::Tag(core::String("!hidden"))};
+        return world.query<Light>(tags).size();
+    });
+
+    const ecs::Tag shadow_tag = ecs::Tag("@Shadow");
+    const double component_handle = time_us(iterations, [&] {
+        const std::array tags = {shadow_tag, ecs::tags::not_hidden};
+        return world.query<Light>(tags).size();
+    });
+
+    const double component_string = time_us(iterations, [&] {
+        const std::array tags = {ecs::Tag(core::String("@Shadow")), ecs::tags::not_hidden};
+        return world.query<Light>(tags).size();
+    });
+
+    log_msg(fmt("% entities, % component types, % queries:", entity_count, filler_type_count + 2, iterations));
+    log_msg(fmt("    tag handles:          % us per query", handle));
+    log_msg(fmt("    tag names:            % us per query", string));
+    log_msg(fmt("    component tag handle: % us per query", component_handle));
+    log_msg(fmt("    component tag name:   % us per query", component_string));
+
+    return 0;
+}
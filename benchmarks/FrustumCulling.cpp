@@ -0,0 +1,133 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/camera/Camera.h>
+
+#include <y/core/Chrono.h>
+#include <y/core/Vector.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <random>
+
+// Compares the batched SoA frustum culling against one intersection() call per box
+
+using namespace yave;
+
+static constexpr usize box_count = 100000;
+static constexpr usize iterations = 50;
+
+struct Boxes {
+    core::Vector<AABB> aabbs;
+    std::array<core::Vector<float>, 3> center;
+    std::array<core::Vector<float>, 3> half_extent;
+    core::Vector<float> radius;
+
+    AABBBatch batch(bool spheres) const {
+        AABBBatch batch;
+        for(usize k = 0; k != 3; ++k) {
+            batch.center[k] = center[k];
+            batch.half_extent[k] = half_extent[k];
+        }
+        if(spheres) {
+            batch.radius = radius;
+        }
+        return batch;
+    }
+};
+
+static Boxes generate_boxes() {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> size(0.1f, 20.0f);
+
+    Boxes boxes;
+    for(usize i = 0; i != box_count; ++i) {
+        const AABB aabb = AABB::from_center_extent(math::Vec3(pos(rng), pos(rng), pos(rng) * 0.1f), math::Vec3(size(rng), size(rng), size(rng)));
+        boxes.aabbs << aabb;
+        for(usize k = 0; k != 3; ++k) {
+            boxes.center[k] << aabb.center()[k];
+            boxes.half_extent[k] << aabb.half_extent()[k];
+        }
+        boxes.radius << aabb.half_extent().length();
+    }
+    return boxes;
+}
+
+static void bench(const char* name, const Frustum& frustum, const Boxes& boxes, float far_dist) {
+    core::Vector<u32> reference(Frustum::cull_mask_size(box_count), 0u);
+    core::Vector<u32> mask(Frustum::cull_mask_size(box_count), 0u);
+    core::Vector<u32> sphere_mask(Frustum::cull_mask_size(box_count), 0u);
+
+    core::Chrono chrono;
+    for(usize it = 0; it != iterations; ++it) {
+        std::fill(reference.begin(), reference.end(), 0u);
+        for(usize i = 0; i != box_count; ++i) {
+            if(frustum.intersection(boxes.aabbs[i], far_dist) != Intersection::Outside) {
+                reference[i / 32] |= 1u << (i % 32);
+            }
+        }
+    }
+    const double scalar = chrono.reset().to_millis() / iterations;
+
+    for(usize it = 0; it != iterations; ++it) {
+        frustum.cull(boxes.batch(false), mask, far_dist);
+    }
+    const double batched = chrono.reset().to_millis() / iterations;
+
+    for(usize it = 0; it != iterations; ++it) {
+        frustum.cull(boxes.batch(true), sphere_mask, far_dist);
+    }
+    const double spheres = chrono.reset().to_millis() / iterations;
+
+    y_always_assert(mask == reference, "Batched culling doesn't match the reference");
+
+    // Sphere tests round differently, boxes right on a plane might flip
+    usize sphere_mismatches = 0;
+    for(usize i = 0; i != box_count; ++i) {
+        sphere_mismatches += Frustum::is_visible(sphere_mask, i) != Frustum::is_visible(reference, i);
+    }
+    y_always_assert(sphere_mismatches * 10000 < box_count, "Sphere culling doesn't match the reference");
+
+    usize visible = 0;
+    for(usize i = 0; i != box_count; ++i) {
+        visible += Frustum::is_visible(reference, i);
+    }
+
+    log_msg(fmt("%: % / % visible", name, visible, box_count));
+    log_msg(fmt("    scalar:  % ms", scalar));
+    log_msg(fmt("    batched: % ms (x%)", batched, scalar / batched));
+    log_msg(fmt("    spheres: % ms (x%), % mismatches", spheres, scalar / spheres, sphere_mismatches));
+}
+
+int main() {
+    const Boxes boxes = generate_boxes();
+
+    Camera camera;
+    camera.set_proj(math::perspective(math::to_rad(60.0f), 16.0f / 9.0f, 0.1f));
+    camera.set_view(math::look_at(math::Vec3(0.0f, 0.0f, 10.0f), math::Vec3(100.0f, 50.0f, 0.0f), math::Vec3(0.0f, 0.0f, 1.0f)));
+
+    bench("infinite", camera.frustum(), boxes, -1.0f);
+    bench("far plane", camera.frustum(), boxes, 300.0f);
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/meshes/MeshData.h>
+
+#include <y/serde3/archives.h>
+#include <y/io2/File.h>
+#include <y/io2/MappedFile.h>
+#include <y/io2/BufferedReader.h>
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <random>
+#include <cstdio>
+
+#ifdef Y_OS_LINUX
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+// Compares loading meshes by copying them out of the file against borrowing them from a mapping
+
+using namespace yave;
+
+static constexpr usize vertex_count = 1 << 20;
+static constexpr usize mesh_count = 16;
+static const core::String file_name = "bench_mesh_loading.bin";
+
+static double resident_mb() {
+#ifdef Y_OS_LINUX
+    if(std::FILE* statm = std::fopen("/proc/self/statm", "r")) {
+        usize size = 0;
+        usize resident = 0;
+        const int read = std::fscanf(statm, "%zu %zu", &size, &resident);
+        std::fclose(statm);
+        if(read == 2) {
+            return double(resident * usize(sysconf(_SC_PAGESIZE))) / (1024.0 * 1024.0);
+        }
+    }
+#endif
+    return 0.0;
+}
+
+static double peak_resident_mb() {
+#ifdef Y_OS_LINUX
+    rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+    return double(usage.ru_maxrss) / 1024.0;
+#else
+    return 0.0;
+#endif
+}
+
+static MeshData create_mesh() {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+
+    core::Vector<PackedVertex> vertices;
+    for(usize i = 0; i != vertex_count; ++i) {
+        vertices << PackedVertex{math::Vec3(dist(rng), dist(rng), dist(rng)), u32(rng()), u32(rng()), math::Vec2(dist(rng), dist(rng))};
+    }
+
+    core::Vector<IndexedTriangle> triangles;
+    for(usize i = 0; i != vertex_count * 2; ++i) {
+        triangles << IndexedTriangle{u32(rng() % vertex_count), u32(rng() % vertex_count), u32(rng() % vertex_count)};
+    }
+
+    return MeshData(vertices, triangles);
+}
+
+template<typename F>
+static void bench(const char* name, F&& open_reader) {
+    const double resident_before = resident_mb();
+
+    core::Vector<MeshData> meshes;
+    core::Chrono chrono;
+    for(usize i = 0; i != mesh_count; ++i) {
+        io2::ReaderPtr reader = open_reader();
+        serde3::ReadableArchive arc(*reader);
+        meshes.emplace_back();
+        y_always_assert(arc.deserialize(meshes.last()).is_ok(), "Unable to load mesh");
+    }
+    const double load_time = chrono.elapsed().to_millis() / mesh_count;
+
+    // Touch everything, like an upload would
+    u64 checksum = 0;
+    for(const MeshData& mesh : meshes) {
+        for(const IndexedTriangle& tri : mesh.triangles()) {
+            checksum += tri[0];
+        }
+        y_always_assert(mesh.vertices().size() == vertex_count, "Mesh was not loaded correctly");
+    }
+    const double touch_time = chrono.elapsed().to_millis() / mesh_count - load_time;
+
+    log_msg(fmt("%:", name));
+    log_msg(fmt("    load:     % ms per mesh", load_time));
+    log_msg(fmt("    read:     % ms per mesh", touch_time));
+    log_msg(fmt("    resident: +% MB for % meshes (checksum %)", resident_mb() - resident_before, mesh_count, checksum % 1000));
+}
+
+int main() {
+    {
+        const MeshData mesh = create_mesh();
+        auto file = io2::File::create(file_name);
+        y_always_assert(file.is_ok(), "Unable to create file");
+        serde3::WritableArchive arc(file.unwrap());
+        y_always_assert(arc.serialize(mesh).is_ok(), "Unable to write mesh");
+    }
+
+    log_msg(fmt("% meshes of % vertices and % triangles", mesh_count, vertex_count, vertex_count * 2));
+
+    // The mapped case goes first so the peak is not dominated by the copies
+    bench("mapped (borrowed)", [] {
+        return io2::ReaderPtr(std::make_unique<io2::MappedFile>(std::move(io2::MappedFile::open(file_name).unwrap())));
+    });
+    log_msg(fmt("peak resident: % MB", peak_resident_mb()));
+
+    bench("buffered file (copied)", [] {
+        return io2::ReaderPtr(std::make_unique<io2::BufferedReader>(std::make_unique<io2::File>(std::move(io2::File::open(file_name).unwrap()))));
+    });
+    log_msg(fmt("peak resident: % MB", peak_resident_mb()));
+
+    bench("file (copied)", [] {
+        return io2::ReaderPtr(std::make_unique<io2::File>(std::move(io2::File::open(file_name).unwrap())));
+    });
+    log_msg(fmt("peak resident: % MB", peak_resident_mb()));
+
+    std::remove(file_name.data());
+
+    return 0;
+}
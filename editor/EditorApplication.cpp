@@ -31,11 +31,13 @@ SOFTWARE.
 #include "UndoStack.h"
 
 #include <yave/assets/FolderAssetStore.h>
+#include <yave/assets/PackedAssetStore.h>
 #include <yave/assets/AssetLoader.h>
 #include <yave/utils/DirectDraw.h>
 #include <yave/utils/PendingOpsQueue.h>
 
 #include <y/io2/File.h>
+#include <y/io2/MappedFile.h>
 #include <y/serde3/archives.h>
 #include <y/utils/log.h>
 
@@ -57,6 +59,23 @@ editor_action(ICON_FA_FOLDER " Load", []{ application()->load_world(); }, "File"
 
 EditorApplication* EditorApplication::_instance = nullptr;
 
+static std::shared_ptr<AssetStore> create_asset_store() {
+    const EditorSettings& settings = app_settings().editor;
+    if(!settings.use_packed_asset_store) {
+        return std::make_shared<FolderAssetStore>(settings.asset_store);
+    }
+
+    const bool convert = !FileSystemModel::local_filesystem()->exists(settings.packed_asset_store).unwrap_or(true);
+    auto store = std::make_shared<PackedAssetStore>(settings.packed_asset_store);
+    if(convert) {
+        log_msg(fmt("Converting % to packed asset store", settings.asset_store));
+        if(!store->import_store(FolderAssetStore(settings.asset_store))) {
+            log_msg("Unable to convert asset store", Log::Error);
+        }
+    }
+    return store;
+}
+
 EditorApplication* EditorApplication::instance() {
     y_debug_assert(_instance);
     return _instance;
@@ -69,7 +88,7 @@ EditorApplication::EditorApplication(ImGuiPlatform* platform) : _platform(platfo
     _resources = std::make_unique<EditorResources>();
     _ui = std::make_unique<UiManager>();
 
-    _asset_store = std::make_shared<FolderAssetStore>(app_settings().editor.asset_store);
+    _asset_store = create_asset_store();
     _loader = std::make_unique<AssetLoader>(_asset_store, AssetLoadingFlags::SkipFailedDependenciesBit, 4);
     _thumbmail_renderer = std::make_unique<ThumbmailRenderer>(*_loader);
 
@@ -164,7 +183,7 @@ void EditorApplication::save_world_deferred() const {
 void EditorApplication::load_world_deferred() {
     y_profile();
 
-    auto file = io2::File::open(app_settings().editor.world_file);
+    auto file = io2::MappedFile::open(app_settings().editor.world_file);
     if(!file) {
         log_msg("Unable to open file", Log::Error);
         return;
@@ -25,6 +25,7 @@ SOFTWARE.
 #include <editor/components/EditorComponent.h>
 
 #include <yave/ecs/EntityScene.h>
+#include <yave/ecs/CommandBuffer.h>
 #include <yave/assets/AssetLoader.h>
 #include <yave/utils/FileSystemModel.h>
 
@@ -36,6 +37,7 @@ SOFTWARE.
 #include <yave/components/TransformableComponent.h>
 
 #include <yave/systems/AssetLoaderSystem.h>
+#include <yave/systems/HierarchySystem.h>
 #include <yave/systems/OctreeSystem.h>
 #include <yave/systems/ScriptSystem.h>
 #include <yave/systems/ASUpdateSystem.h>
@@ -52,20 +54,20 @@ editor_action("Remove all entities", [] { current_world().clear(); })
 
 EditorWorld::EditorWorld(AssetLoader& loader) {
     add_required_component<EditorComponent>();
+    add_component_group<TransformableComponent, StaticMeshComponent>();
     add_system<AssetLoaderSystem>(loader);
+    add_system<HierarchySystem>();
     add_system<OctreeSystem>();
     add_system<ScriptSystem>();
     // add_system<ASUpdateSystem>();
 }
 
 void EditorWorld::clear() {
-    core::Vector<ecs::EntityId> all_entities;
+    ecs::CommandBuffer buffer;
     for(const ecs::EntityId id : ids()) {
-        all_entities << id;
-    }
-    for(const ecs::EntityId id : all_entities) {
-        remove_entity(id);
+        buffer.remove_entity(id);
     }
+    buffer.play_back(*this);
 }
 
 void EditorWorld::flush_reload() {
@@ -164,8 +166,8 @@ void EditorWorld::add_scene(AssetId asset, ecs::EntityId parent) {
     y_profile();
 
     if(const auto scene = asset_loader().load_res<ecs::EntityScene>(asset)) {
-        for(const auto& prefab : scene.unwrap()->prefabs()) {
-            set_parent(create_entity(prefab), parent);
+        for(const ecs::EntityId id : instantiate(*scene.unwrap())) {
+            set_parent(id, parent);
         }
     }
 }
@@ -29,6 +29,7 @@ SOFTWARE.
 #include <yave/graphics/framebuffer/Framebuffer.h>
 #include <yave/window/Monitor.h>
 
+#include <y/core/FrameArena.h>
 #include <y/io2/File.h>
 #include <y/utils/log.h>
 
@@ -387,6 +388,8 @@ void ImGuiPlatform::exec(OnGuiFunc func) {
 
         y_profile_zone("exec once");
 
+        core::frame_arena().reset();
+
         ImGui::GetIO().DeltaTime = std::max(math::epsilon<float>, float(_frame_timer.reset().to_secs()));
         ImGui::GetIO().DisplaySize = _main_window->window.size();
 
@@ -35,9 +35,13 @@ struct EditorSettings {
     core::String world_file = "../world.yw3";
     core::String asset_store = "../store";
 
+    // The folder store is converted the first time the packed store is opened
+    bool use_packed_asset_store = false;
+    core::String packed_asset_store = "../store.pack";
+
     float max_fps = 60.0f;
 
-    y_reflect(EditorSettings, world_file, asset_store, max_fps)
+    y_reflect(EditorSettings, world_file, asset_store, use_packed_asset_store, packed_asset_store, max_fps)
 };
 
 struct CameraSettings {
@@ -339,12 +339,14 @@ struct StaticMeshComponentWidget : public ComponentPanelWidget<StaticMeshCompone
                             if(StaticMeshComponent* static_mesh = current_world().component<StaticMeshComponent>(id)) {
                                 undo_stack().push_before_dirty(id);
                                 static_mesh->mesh() = mesh.unwrap();
+                                current_world().mark_changed<StaticMeshComponent>(id);
                             }
                         }
                         return true;
                     });
             } else if(clear) {
                 static_mesh->mesh() = AssetPtr<StaticMesh>();
+                current_world().mark_changed<StaticMeshComponent>(id);
                 undo_stack().make_dirty();
             }
 
@@ -370,12 +372,14 @@ struct StaticMeshComponentWidget : public ComponentPanelWidget<StaticMeshCompone
                                     if(StaticMeshComponent* static_mesh = current_world().component<StaticMeshComponent>(id)) {
                                         undo_stack().push_before_dirty(id);
                                         static_mesh->materials()[i] = mat.unwrap();
+                                        current_world().mark_changed<StaticMeshComponent>(id);
                                     }
                                 }
                                 return true;
                             });
                     } else if(clear) {
                         materials[i] = AssetPtr<Material>();
+                        current_world().mark_changed<StaticMeshComponent>(id);
                         undo_stack().make_dirty();
                     }
                 }
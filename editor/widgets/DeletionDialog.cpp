@@ -25,6 +25,8 @@ SOFTWARE.
 #include <editor/EditorWorld.h>
 #include <editor/components/EditorComponent.h>
 
+#include <yave/ecs/CommandBuffer.h>
+
 #include <external/imgui/yave_imgui.h>
 
 namespace editor {
@@ -48,14 +50,16 @@ void DeletionDialog::on_gui() {
 
     if(ImGui::Button("Ok")) {
         y_profile_zone("deleting entities");
+        ecs::CommandBuffer buffer;
         for(ecs::EntityId id : component->children()) {
             if(_delete_children) {
-                world.remove_entity(id);
+                buffer.remove_entity(id);
             } else {
                 world.set_parent(id, ecs::EntityId());
             }
         }
-        world.remove_entity(_id);
+        buffer.remove_entity(_id);
+        buffer.play_back(world);
         close();
     }
 
@@ -238,7 +238,7 @@ static void populate_context_menu(EditorWorld& world, ecs::EntityId id = ecs::En
     }
 }
 
-static void display_tag_buttons(ecs::EntityId id, EditorWorld& world, core::Span<std::pair<const char*, core::String>> tag_buttons) {
+static void display_tag_buttons(ecs::EntityId id, EditorWorld& world, core::Span<std::pair<const char*, ecs::Tag>> tag_buttons) {
     for(const auto& [icon, tag] : tag_buttons) {
         const bool tagged = world.has_tag(id, tag);
         if(tagged) {
@@ -25,6 +25,7 @@ SOFTWARE.
 #include <editor/Widget.h>
 
 #include <yave/ecs/ComponentRuntimeInfo.h>
+#include <yave/ecs/tags.h>
 
 #include <y/core/Vector.h>
 #include <y/core/HashMap.h>
@@ -45,7 +46,7 @@ class EntityView final : public Widget {
     private:
         ecs::EntityId _context_menu_entity;
 
-        core::Vector<std::pair<const char*, core::String>> _tag_buttons;
+        core::Vector<std::pair<const char*, ecs::Tag>> _tag_buttons;
         core::FlatHashMap<ecs::EntityId, bool> _open_nodes;
 };
 
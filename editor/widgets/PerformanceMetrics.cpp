@@ -27,6 +27,8 @@ SOFTWARE.
 #include <yave/graphics/memory/DeviceMemoryAllocator.h>
 #include <yave/graphics/device/LifetimeManager.h>
 
+#include <y/core/FrameArena.h>
+
 #include <external/imgui/yave_imgui.h>
 
 namespace editor {
@@ -206,6 +208,17 @@ void PerformanceMetrics::draw_memory() {
         ImGui::ProgressBar(used_sets / float(total_sets), ImVec2(0, 0), fmt_c_str("% / % sets", used_sets, total_sets));
     }
 
+    {
+        ImGui::Spacing();
+        ImGui::Separator();
+
+        const core::FrameArena::Stats frame = core::frame_arena().stats();
+        const core::FrameArena::Stats scratch = core::scratch_arena().stats();
+
+        ImGui::Text("Frame arena: %.2lfMB peak, %.2lfMB reserved in %u blocks", to_mb(u64(frame.high_water_mark)), to_mb(u64(frame.reserved)), u32(frame.block_count));
+        ImGui::Text("Scratch arena: %.2lfMB peak, %.2lfMB reserved in %u blocks", to_mb(u64(scratch.high_water_mark)), to_mb(u64(scratch.reserved)), u32(scratch.block_count));
+    }
+
     ImGui::Spacing();
     ImGui::Separator();
     ImGui::Checkbox("Show heaps", &_show_heaps);
@@ -0,0 +1,118 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/core/HashMap.h>
+#include <y/core/Vector.h>
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <y/math/random.h>
+
+#include <unordered_map>
+
+using namespace y;
+
+static constexpr usize element_count = 1000000;
+static constexpr usize churn_count = 4000000;
+
+struct Timings {
+    double insert = 0.0;
+    double hit = 0.0;
+    double miss = 0.0;
+    double churn = 0.0;
+};
+
+template<typename Map>
+static Timings run(core::Span<u64> keys, core::Span<u64> missing) {
+    Timings timings;
+    Map map;
+
+    {
+        core::Chrono chrono;
+        for(usize i = 0; i != keys.size(); ++i) {
+            map[keys[i]] = i;
+        }
+        timings.insert = chrono.elapsed().to_millis();
+    }
+
+    usize sum = 0;
+    {
+        core::Chrono chrono;
+        for(const u64 k : keys) {
+            sum += map.find(k)->second;
+        }
+        timings.hit = chrono.elapsed().to_millis();
+    }
+
+    usize found = 0;
+    {
+        core::Chrono chrono;
+        for(const u64 k : missing) {
+            found += map.find(k) != map.end();
+        }
+        timings.miss = chrono.elapsed().to_millis();
+    }
+
+    // Erases the oldest key and inserts a new one: the number of elements stays the same
+    {
+        core::Chrono chrono;
+        for(usize i = 0; i != churn_count; ++i) {
+            map.erase(keys[i % keys.size()] + (i / keys.size()));
+            map[keys[i % keys.size()] + (i / keys.size()) + 1] = i;
+        }
+        timings.churn = chrono.elapsed().to_millis();
+    }
+
+    y_always_assert(sum == keys.size() * (keys.size() - 1) / 2, "Invalid map");
+    y_always_assert(!found, "Invalid map");
+    y_always_assert(map.size() == keys.size(), "Invalid map");
+
+    return timings;
+}
+
+static void print(const char* name, const Timings& timings) {
+    log_msg(fmt("    %:", name));
+    log_msg(fmt("        insert:  % ms", timings.insert));
+    log_msg(fmt("        hit:     % ms", timings.hit));
+    log_msg(fmt("        miss:    % ms", timings.miss));
+    log_msg(fmt("        churn:   % ms", timings.churn));
+}
+
+int main() {
+    // Keys are spread out so that key + n never collides with another key for the churn
+    math::FastRandom rng(1);
+    core::Vector<u64> keys;
+    core::Vector<u64> missing;
+    for(usize i = 0; i != element_count; ++i) {
+        const u64 k = (u64(rng()) << 32 | rng()) & ~u64(0xFF);
+        keys << k;
+        missing << (k | 0x80);
+    }
+
+    log_msg(fmt("% u64 keys, % erase/insert:", element_count, churn_count));
+    print("core::FlatHashMap", run<core::FlatHashMap<u64, usize>>(keys, missing));
+    print("core::FlatHashMap (StoreHash)", run<core::FlatHashMap<u64, usize, Hash<u64>, std::equal_to<u64>, true>>(keys, missing));
+    print("std::unordered_map", run<std::unordered_map<u64, usize, Hash<u64>>>(keys, missing));
+
+    return 0;
+}
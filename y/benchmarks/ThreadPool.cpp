@@ -0,0 +1,199 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/concurrent/StaticThreadPool.h>
+
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <list>
+#include <mutex>
+#include <condition_variable>
+
+using namespace y;
+
+// Single mutex pool that StaticThreadPool used to be, kept as a reference
+class LockedThreadPool : NonMovable {
+    using Func = std::function<void()>;
+
+    struct Task {
+        Func function;
+        std::shared_ptr<std::atomic<u32>> wait_for;
+        std::shared_ptr<std::atomic<u32>> on_done;
+    };
+
+    public:
+        using Group = std::shared_ptr<std::atomic<u32>>;
+
+        LockedThreadPool(usize thread_count) {
+            for(usize i = 0; i != thread_count; ++i) {
+                _threads.emplace_back([this] { worker(); });
+            }
+        }
+
+        ~LockedThreadPool() {
+            while(process_one(std::unique_lock(_lock))) {
+            }
+
+            {
+                _run = false;
+                const std::unique_lock lock(_lock);
+                _condition.notify_all();
+            }
+
+            for(auto& thread : _threads) {
+                thread.join();
+            }
+        }
+
+        void schedule(Func&& func, Group* on_done = nullptr, Group wait_for = nullptr) {
+            {
+                const std::unique_lock lock(_lock);
+                if(on_done) {
+                    if(!*on_done) {
+                        *on_done = std::make_shared<std::atomic<u32>>(0);
+                    }
+                    ++(**on_done);
+                }
+                _queue.push_back(Task{std::move(func), std::move(wait_for), on_done ? *on_done : nullptr});
+            }
+            _condition.notify_one();
+        }
+
+    private:
+        bool process_one(std::unique_lock<std::mutex> lock) {
+            ++_working;
+            y_defer(--_working);
+
+            for(auto it = _queue.begin(); it != _queue.end(); ++it) {
+                if(!it->wait_for || *it->wait_for == 0) {
+                    Task task = std::move(*it);
+                    _queue.erase(it);
+
+                    lock.unlock();
+
+                    task.function();
+                    if(task.on_done && --(*task.on_done) == 0) {
+                        _condition.notify_one();
+                    }
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void worker() {
+            while(_run) {
+                std::unique_lock lock(_lock);
+                _condition.wait(lock, [&] { return !_queue.empty() || !_run; });
+                process_one(std::move(lock));
+            }
+        }
+
+        std::mutex _lock;
+        std::condition_variable _condition;
+        std::list<Task> _queue;
+        std::atomic<u32> _working = 0;
+        std::atomic<bool> _run = true;
+        core::Vector<std::thread> _threads;
+};
+
+
+static void spin(usize iterations) {
+    volatile usize acc = 0;
+    for(usize i = 0; i != iterations; ++i) {
+        acc = acc + i;
+    }
+}
+
+static constexpr usize task_count = 100000;
+static constexpr usize task_cost = 200;
+
+template<typename Pool>
+static double bench_independent(usize threads) {
+    core::Chrono chrono;
+    {
+        Pool pool(threads);
+        for(usize i = 0; i != task_count; ++i) {
+            pool.schedule([] { spin(task_cost); });
+        }
+    }
+    return chrono.elapsed().to_millis();
+}
+
+template<typename Pool>
+static double bench_nested(usize threads) {
+    core::Chrono chrono;
+    {
+        Pool pool(threads);
+        const usize outer = 256;
+        for(usize i = 0; i != outer; ++i) {
+            pool.schedule([&pool] {
+                for(usize j = 0; j != task_count / outer; ++j) {
+                    pool.schedule([] { spin(task_cost); });
+                }
+            });
+        }
+    }
+    return chrono.elapsed().to_millis();
+}
+
+template<typename Pool, typename Group>
+static double bench_dependencies(usize threads) {
+    core::Chrono chrono;
+    {
+        Pool pool(threads);
+        // A few long chains interleaved, blocked tasks pile up in the queue
+        const usize chains = 16;
+        const usize length = 2000;
+        core::Vector<Group> groups(chains, Group());
+        for(usize i = 0; i != length; ++i) {
+            for(usize c = 0; c != chains; ++c) {
+                Group next = Group();
+                pool.schedule([] { spin(task_cost); }, &next, groups[c]);
+                groups[c] = next;
+            }
+        }
+    }
+    return chrono.elapsed().to_millis();
+}
+
+int main() {
+    log_msg(fmt("% tasks of % iterations", task_count, task_cost));
+
+    for(usize threads = 1; threads <= 64; threads *= 2) {
+        log_msg(fmt("% threads:", threads));
+        log_msg(fmt("    independent:   locked % ms, work stealing % ms",
+            bench_independent<LockedThreadPool>(threads),
+            bench_independent<concurrent::StaticThreadPool>(threads)));
+        log_msg(fmt("    nested:        locked % ms, work stealing % ms",
+            bench_nested<LockedThreadPool>(threads),
+            bench_nested<concurrent::StaticThreadPool>(threads)));
+        log_msg(fmt("    dependencies:  locked % ms, work stealing % ms",
+            bench_dependencies<LockedThreadPool, LockedThreadPool::Group>(threads),
+            bench_dependencies<concurrent::StaticThreadPool, concurrent::DependencyGroup>(threads)));
+    }
+
+    return 0;
+}
+
@@ -0,0 +1,74 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/concurrent/parallel.h>
+
+#include <y/core/Vector.h>
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <cmath>
+
+using namespace y;
+
+static constexpr usize element_count = 1000000;
+
+static float transform(float x) {
+    return std::sqrt(std::abs(std::sin(x) * std::cos(x * 0.5f))) + x * 0.25f;
+}
+
+int main() {
+    core::Vector<float> input(element_count, 0.0f);
+    for(usize i = 0; i != element_count; ++i) {
+        input[i] = float(i) * 0.001f;
+    }
+
+    core::Vector<float> output(element_count, 0.0f);
+
+    const usize runs = 10;
+
+    double serial = 0.0;
+    for(usize r = 0; r != runs; ++r) {
+        core::Chrono chrono;
+        for(usize i = 0; i != element_count; ++i) {
+            output[i] = transform(input[i]);
+        }
+        serial += chrono.elapsed().to_millis();
+    }
+
+    double parallel = 0.0;
+    for(usize r = 0; r != runs; ++r) {
+        core::Chrono chrono;
+        concurrent::parallel_for(0, element_count, 1024, [&](usize i) {
+            output[i] = transform(input[i]);
+        });
+        parallel += chrono.elapsed().to_millis();
+    }
+
+    log_msg(fmt("% element transform on % threads:", element_count, concurrent::default_thread_pool().concurency()));
+    log_msg(fmt("    serial:        % ms", serial / runs));
+    log_msg(fmt("    parallel_for:  % ms (x%)", parallel / runs, serial / parallel));
+
+    return 0;
+}
+
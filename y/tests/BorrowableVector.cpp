@@ -0,0 +1,183 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/core/BorrowableVector.h>
+#include <y/serde3/archives.h>
+#include <y/io2/Buffer.h>
+#include <y/io2/File.h>
+#include <y/io2/MappedFile.h>
+#include <y/test/test.h>
+
+#include <cstdio>
+
+namespace {
+using namespace y;
+using namespace y::core;
+
+struct Vec3f {
+    float x, y, z;
+};
+
+struct Owned {
+    u8 tag = 0;
+    Vector<Vec3f> points;
+    Vector<u32> indices;
+
+    y_reflect(Owned, tag, points, indices)
+};
+
+// Same format as Owned
+struct Borrowed {
+    using serde3_hash_as = Owned;
+
+    u8 tag = 0;
+    BorrowableVector<Vec3f> points;
+    BorrowableVector<u32> indices;
+
+    y_reflect(Borrowed, tag, points, indices)
+};
+
+template<typename T>
+static bool write_file(const String& name, const T& t) {
+    auto file = io2::File::create(name);
+    if(!file) {
+        return false;
+    }
+    serde3::WritableArchive arc(file.unwrap());
+    return arc.serialize(t).is_ok();
+}
+
+template<typename T>
+static bool check_content(const T& t) {
+    if(t.tag != 7 || t.points.size() != 100 || t.indices.size() != 300) {
+        return false;
+    }
+    for(usize i = 0; i != t.points.size(); ++i) {
+        if(t.points[i].x != float(i) || t.points[i].z != -float(i)) {
+            return false;
+        }
+    }
+    for(usize i = 0; i != t.indices.size(); ++i) {
+        if(t.indices[i] != i * 3) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static Owned create_data() {
+    Owned data;
+    data.tag = 7;
+    for(usize i = 0; i != 100; ++i) {
+        data.points.push_back(Vec3f{float(i), 1.0f, -float(i)});
+    }
+    for(u32 i = 0; i != 300; ++i) {
+        data.indices.push_back(i * 3);
+    }
+    return data;
+}
+
+y_test_func("BorrowableVector basics") {
+    const Vector<u32> values = {1, 2, 3, 4};
+    auto owner = std::make_shared<int>();
+
+    BorrowableVector<u32> vec(values, owner);
+    y_test_assert(vec.is_borrowed());
+    y_test_assert(vec.data() == values.data());
+    y_test_assert(owner.use_count() == 2);
+
+    vec.to_owned().push_back(5);
+    y_test_assert(!vec.is_borrowed());
+    y_test_assert(owner.use_count() == 1);
+    y_test_assert(vec.size() == 5 && vec[0] == 1 && vec[4] == 5);
+
+    vec.resize(2);
+    y_test_assert(vec.size() == 2 && vec[1] == 2);
+
+    vec.make_empty();
+    y_test_assert(vec.is_empty());
+}
+
+y_test_func("BorrowableVector borrows from mapped archives") {
+    const String name = "y_test_borrowable.bin";
+
+    Borrowed data;
+    {
+        Owned owned = create_data();
+        data.tag = owned.tag;
+        data.points = std::move(owned.points);
+        data.indices = std::move(owned.indices);
+    }
+    y_test_assert(write_file(name, data));
+
+    {
+        auto file = io2::MappedFile::open(name);
+        y_test_assert(file);
+
+        Borrowed mapped;
+        serde3::ReadableArchive arc(file.unwrap());
+        y_test_assert(arc.deserialize(mapped));
+        y_test_assert(check_content(mapped));
+        y_test_assert(mapped.points.is_borrowed());
+        y_test_assert(mapped.indices.is_borrowed());
+
+        // The mapping outlives the reader
+        file.unwrap() = io2::MappedFile();
+        y_test_assert(check_content(mapped));
+
+        Owned as_owned;
+        serde3::ReadableArchive owned_arc(std::make_unique<io2::MappedFile>(std::move(io2::MappedFile::open(name).unwrap())));
+        y_test_assert(owned_arc.deserialize(as_owned));
+        y_test_assert(check_content(as_owned));
+    }
+
+    {
+        auto file = io2::File::open(name);
+        y_test_assert(file);
+
+        Borrowed copied;
+        serde3::ReadableArchive arc(file.unwrap());
+        y_test_assert(arc.deserialize(copied));
+        y_test_assert(check_content(copied));
+        y_test_assert(!copied.points.is_borrowed());
+    }
+
+    std::remove(name.data());
+}
+
+y_test_func("BorrowableVector reads unaligned archives") {
+    const String name = "y_test_borrowable_compat.bin";
+    y_test_assert(write_file(name, create_data()));
+
+    auto file = io2::MappedFile::open(name);
+    y_test_assert(file);
+
+    Borrowed data;
+    serde3::ReadableArchive arc(file.unwrap());
+    const auto r = arc.deserialize(data);
+    y_test_assert(r && r.unwrap() == serde3::Success::Full);
+    y_test_assert(check_content(data));
+
+    file.unwrap() = io2::MappedFile();
+    std::remove(name.data());
+}
+}
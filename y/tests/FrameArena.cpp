@@ -0,0 +1,193 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/core/FrameArena.h>
+#include <y/core/ScratchPad.h>
+#include <y/test/test.h>
+
+#include <thread>
+#include <vector>
+
+namespace {
+using namespace y;
+using namespace y::core;
+
+static bool is_aligned(const void* ptr, usize alignment) {
+    return !(reinterpret_cast<usize>(ptr) % alignment);
+}
+
+y_test_func("FrameArena grow") {
+    FrameArena arena(1024);
+
+    Vector<u32*> ptrs;
+    for(u32 i = 0; i != 1000; ++i) {
+        u32* ptr = arena.allocate_typed<u32>(16);
+        y_test_assert(is_aligned(ptr, alignof(u32)));
+        std::fill_n(ptr, 16, i);
+        ptrs << ptr;
+    }
+
+    for(u32 i = 0; i != 1000; ++i) {
+        y_test_assert(std::all_of(ptrs[i], ptrs[i] + 16, [=](u32 k) { return k == i; }));
+    }
+
+    const FrameArena::Stats stats = arena.stats();
+    y_test_assert(stats.block_count > 1);
+    y_test_assert(stats.allocated >= 1000 * 16 * sizeof(u32));
+    y_test_assert(stats.reserved >= stats.allocated);
+
+    arena.reset();
+
+    const FrameArena::Stats reset_stats = arena.stats();
+    y_test_assert(reset_stats.block_count == 1);
+    y_test_assert(reset_stats.allocated == 0);
+    y_test_assert(reset_stats.reserved == stats.reserved);
+    y_test_assert(reset_stats.high_water_mark == stats.allocated);
+
+    void* big = arena.allocate(stats.allocated);
+    y_test_assert(big);
+    y_test_assert(arena.stats().block_count == 1);
+}
+
+y_test_func("FrameArena alignment") {
+    FrameArena arena(256);
+    for(usize i = 0; i != 64; ++i) {
+        const usize alignment = usize(1) << (i % 8);
+        void* ptr = arena.allocate(i + 1, alignment);
+        y_test_assert(is_aligned(ptr, alignment));
+    }
+    y_test_assert(arena.allocate(0) == nullptr);
+}
+
+y_test_func("FrameArena marker") {
+    FrameArena arena(128);
+
+    arena.allocate(100);
+    const FrameArena::Marker marker = arena.mark();
+    const usize allocated = arena.stats().allocated;
+
+    void* first = arena.allocate(64);
+    for(usize i = 0; i != 32; ++i) {
+        arena.allocate(100);
+    }
+
+    arena.rewind(marker);
+    y_test_assert(arena.stats().allocated == allocated);
+    y_test_assert(arena.allocate(64) == first);
+}
+
+y_test_func("FrameArena pop") {
+    FrameArena arena(256);
+
+    Vector<std::pair<void*, usize>> allocs;
+    for(usize i = 0; i != 100; ++i) {
+        const usize size = 1 + (i * 37) % 200;
+        allocs.emplace_back(arena.allocate(size), size);
+    }
+
+    while(!allocs.is_empty()) {
+        const auto [ptr, size] = allocs.pop();
+        arena.pop(ptr, size);
+    }
+
+    y_test_assert(arena.stats().allocated == 0);
+}
+
+y_test_func("FrameArena try_free") {
+    FrameArena arena;
+
+    void* a = arena.allocate(64);
+    void* b = arena.allocate(64);
+    y_test_assert(!arena.try_free(a, 64));
+    y_test_assert(arena.try_free(b, 64));
+    y_test_assert(arena.try_free(a, 64));
+    y_test_assert(arena.stats().allocated == 0);
+    y_test_assert(arena.stats().high_water_mark == 128);
+}
+
+y_test_func("FrameArena concurrent") {
+    FrameArena arena(4096);
+
+    const usize thread_count = 8;
+    const usize alloc_count = 4096;
+
+    std::vector<std::vector<u64*>> allocs(thread_count);
+    std::vector<std::thread> threads;
+    for(usize t = 0; t != thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            for(usize i = 0; i != alloc_count; ++i) {
+                u64* ptr = arena.allocate_typed<u64>(1 + i % 7);
+                std::fill_n(ptr, 1 + i % 7, u64(t * alloc_count + i));
+                allocs[t].push_back(ptr);
+            }
+        });
+    }
+
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    for(usize t = 0; t != thread_count; ++t) {
+        for(usize i = 0; i != alloc_count; ++i) {
+            const u64* ptr = allocs[t][i];
+            y_test_assert(std::all_of(ptr, ptr + 1 + i % 7, [=](u64 k) { return k == t * alloc_count + i; }));
+        }
+    }
+
+    arena.reset();
+    y_test_assert(arena.stats().block_count == 1);
+}
+
+y_test_func("FrameArena FrameVector") {
+    FrameArena arena(64);
+
+    FrameVector<usize> vec{FrameAllocator<usize>(arena)};
+    for(usize i = 0; i != 10000; ++i) {
+        vec << i;
+    }
+
+    for(usize i = 0; i != 10000; ++i) {
+        y_test_assert(vec[i] == i);
+    }
+
+    FrameVector<usize> moved = std::move(vec);
+    y_test_assert(moved.size() == 10000);
+    y_test_assert(vec.is_empty());
+    y_test_assert(arena.stats().allocated >= 10000 * sizeof(usize));
+}
+
+y_test_func("ScratchPad large") {
+    // Bigger than the scratch arena's first block
+    ScratchPad<u32> a(64 * 1024);
+    {
+        ScratchVector<u32> b(64 * 1024);
+        for(u32 i = 0; i != b.capacity(); ++i) {
+            b.push_back(i);
+        }
+        std::fill(a.begin(), a.end(), 7);
+        y_test_assert(b[1234] == 1234);
+    }
+    ScratchPad<u32> c(16);
+    y_test_assert(a[1234] == 7);
+    y_test_assert(c.size() == 16);
+}
+
+}
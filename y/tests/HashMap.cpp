@@ -187,10 +187,14 @@ y_test_func("HashMap fuzz") {
     const auto m0 = fuzz<std::unordered_map<i32, i32>>(fuzz_count, seed);
 
     const auto m2 = fuzz<FlatHashMap<i32, i32>>(fuzz_count, seed);
+    const auto m5 = fuzz<FlatHashMap<i32, i32, Hash<i32>, std::equal_to<i32>, true>>(fuzz_count, seed);
+    const auto m6 = fuzz<FlatHashMap<i32, i32, BadHash<64>>>(fuzz_count, seed);
     /*const auto m3 = fuzz<FlatHashMap<i32, i32>>(fuzz_count, seed);
     const auto m4 = fuzz<HashMap<i32, i32>>(fuzz_count, seed);*/
 
     y_test_assert(to_vector(m0) == to_vector(m2));
+    y_test_assert(to_vector(m0) == to_vector(m5));
+    y_test_assert(to_vector(m0) == to_vector(m6));
     /*y_test_assert(to_vector(m0) == to_vector(m3));
     y_test_assert(to_vector(m0) == to_vector(m4));*/
 }
@@ -254,6 +258,100 @@ y_test_func("HashMap value dtors") {
     y_test_assert(counter == max_key);
 }
 
+y_test_func("HashMap erase churn") {
+    static constexpr int live_count = 1000;
+
+    DefaultImpl<int, int> map;
+    for(int i = 0; i != live_count; ++i) {
+        map.emplace(i, i);
+    }
+
+    const usize buckets = map.bucket_count();
+
+    // Keeps the same number of elements while always erasing and inserting different keys
+    for(int i = 0; i != 100 * live_count; ++i) {
+        map.erase(i);
+        y_test_assert(map.emplace(i + live_count, i).second);
+        y_test_assert(map.size() == live_count);
+    }
+
+    // Tombstones get cleaned up instead of making the map grow or probe forever
+    y_test_assert(map.bucket_count() == buckets);
+    y_test_assert(map.tombstone_count() < map.bucket_count());
+
+    for(int i = 0; i != 100 * live_count; ++i) {
+        y_test_assert(!map.contains(i));
+    }
+    for(int i = 100 * live_count; i != 101 * live_count; ++i) {
+        const auto it = map.find(i);
+        y_test_assert(it != map.end());
+        y_test_assert(it->second == i - live_count);
+    }
+
+    usize count = 0;
+    for(const auto& [k, v] : map) {
+        y_test_assert(k == v + live_count);
+        ++count;
+    }
+    y_test_assert(count == live_count);
+
+    map.rehash();
+    y_test_assert(map.tombstone_count() == 0);
+    y_test_assert(map.find(101 * live_count - 1)->second == 100 * live_count - 1);
+}
+
+y_test_func("HashMap group collisions") {
+    static constexpr int max_key = 2000;
+
+    // Every key falls in the same few groups and has the same control byte as many others
+    DefaultImpl<int, core::String, BadHash<3>> map;
+    for(int i = 0; i != max_key; ++i) {
+        map[i] = fmt("%", i);
+    }
+
+    for(int i = 0; i < max_key; i += 2) {
+        map.erase(i);
+    }
+
+    y_test_assert(map.size() == max_key / 2);
+    for(int i = 0; i != max_key; ++i) {
+        const auto it = map.find(i);
+        if(i % 2) {
+            y_test_assert(it != map.end());
+            y_test_assert(it->second == fmt("%", i));
+        } else {
+            y_test_assert(it == map.end());
+        }
+    }
+
+    map.make_empty();
+    y_test_assert(map.is_empty());
+    y_test_assert(map.begin() == map.end());
+    y_test_assert(map.tombstone_count() == 0);
+
+    map[7] = "7";
+    y_test_assert(map.size() == 1);
+    y_test_assert(map.find(7)->second == "7");
+}
+
+y_test_func("HashMap stored hash") {
+    static constexpr int max_key = 1000;
+
+    FlatHashMap<core::String, int, Hash<core::String>, std::equal_to<core::String>, true> map;
+    for(int i = 0; i != max_key; ++i) {
+        y_test_assert(map.insert({fmt("%", i), i}).second);
+    }
+    for(int i = 0; i < max_key; i += 3) {
+        map.erase(fmt("%", i));
+    }
+    map.rehash();
+
+    for(int i = 0; i != max_key; ++i) {
+        const auto it = map.find(fmt("%", i));
+        y_test_assert((it == map.end()) == (i % 3 == 0));
+        y_test_assert(it == map.end() || it->second == i);
+    }
+}
 
 }
 
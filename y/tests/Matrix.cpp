@@ -21,6 +21,8 @@ SOFTWARE.
 **********************************/
 
 #include <y/math/Matrix.h>
+#include <y/math/batch.h>
+#include <y/math/random.h>
 #include <y/test/test.h>
 
 namespace {
@@ -98,5 +100,91 @@ y_test_func("Matrix sub") {
     using M = Matrix<1, 2>;
     y_test_assert(mat.sub(0, 2) == M(4, 5));
 }
+
+template<usize N, usize M>
+static bool approx_eq(const Matrix<N, M, float>& a, const Matrix<N, M, double>& b, double eps = 1e-4) {
+    for(usize i = 0; i != M; ++i) {
+        for(usize j = 0; j != N; ++j) {
+            if(std::abs(a[i][j] - b[i][j]) > eps * std::max(1.0, std::abs(b[i][j]))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool approx_eq(const Vec3& a, const Vec3& b, float eps = 1e-4f) {
+    return (a - b).abs().max_component() <= eps * std::max(1.0f, b.abs().max_component());
 }
 
+y_test_func("Matrix4 float matches double") {
+    FastRandom rng;
+    const auto rand_float = [&] { return float(rng() % 2001) / 100.0f - 10.0f; };
+
+    for(usize k = 0; k != 1000; ++k) {
+        Matrix4<float> a;
+        Matrix4<float> b;
+        Vec4 v;
+        for(usize i = 0; i != 4; ++i) {
+            v[i] = rand_float();
+            for(usize j = 0; j != 4; ++j) {
+                a[i][j] = rand_float();
+                b[i][j] = rand_float();
+            }
+        }
+
+        const Matrix4<double> da = a;
+        const Matrix4<double> db = b;
+        y_test_assert(a.transposed() == Matrix4<float>(da.transposed()));
+        y_test_assert(approx_eq(a * b, da * db));
+        const Vec4 av = a * v;
+        const Vec<4, double> dav = da * Vec<4, double>(v);
+        for(usize i = 0; i != 4; ++i) {
+            y_test_assert(std::abs(av[i] - dav[i]) < 1e-3);
+        }
+        if(std::abs(da.determinant()) > 1.0) {
+            y_test_assert(approx_eq(a.inverse(), da.inverse(), 1e-3));
+        }
+    }
+
+    y_test_assert(Matrix4<float>().inverse() == Matrix4<float>());
+}
+
+y_test_func("Matrix batch transform") {
+    Matrix4<float> tr(0.0f, -2.0f, 0.0f, 1.0f,
+                      2.0f, 0.0f, 0.0f, 2.0f,
+                      0.0f, 0.0f, 3.0f, 3.0f,
+                      0.0f, 0.0f, 0.0f, 1.0f);
+
+    const Vec3 points[] = {Vec3(0.0f), Vec3(1.0f, 2.0f, 3.0f), Vec3(-4.0f, 5.0f, -6.0f)};
+    Vec3 out[3];
+
+    transform_points(tr, points, out);
+    for(usize i = 0; i != 3; ++i) {
+        y_test_assert(approx_eq(out[i], (tr * Vec4(points[i], 1.0f)).to<3>()));
+    }
+
+    transform_directions(tr, points, out);
+    for(usize i = 0; i != 3; ++i) {
+        y_test_assert(approx_eq(out[i], (tr * Vec4(points[i], 0.0f)).to<3>()));
+    }
+
+    const Vec3 min[] = {Vec3(-1.0f), Vec3(0.0f, 1.0f, 2.0f)};
+    const Vec3 max[] = {Vec3(1.0f), Vec3(4.0f, 2.0f, 3.0f)};
+    Vec3 out_min[2];
+    Vec3 out_max[2];
+    transform_aabbs(tr, min, max, out_min, out_max);
+    for(usize i = 0; i != 2; ++i) {
+        Vec3 ref_min(std::numeric_limits<float>::max());
+        Vec3 ref_max(-std::numeric_limits<float>::max());
+        for(usize c = 0; c != 8; ++c) {
+            const Vec3 corner(c & 1 ? max[i].x() : min[i].x(), c & 2 ? max[i].y() : min[i].y(), c & 4 ? max[i].z() : min[i].z());
+            const Vec3 p = (tr * Vec4(corner, 1.0f)).to<3>();
+            ref_min = ref_min.min(p);
+            ref_max = ref_max.max(p);
+        }
+        y_test_assert(approx_eq(out_min[i], ref_min));
+        y_test_assert(approx_eq(out_max[i], ref_max));
+    }
+}
+}
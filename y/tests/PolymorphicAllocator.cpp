@@ -0,0 +1,182 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/memory/containers.h>
+#include <y/memory/MonotonicAllocator.h>
+#include <y/memory/PoolAllocator.h>
+#include <y/core/String.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace y;
+using namespace y::memory;
+
+class CountingAllocator final : public PolymorphicAllocatorBase {
+    public:
+        void* allocate(usize size, usize alignment) override {
+            ++allocations;
+            allocated += size;
+            return default_allocator().allocate(size, alignment);
+        }
+
+        void deallocate(void* ptr, usize size, usize alignment) override {
+            ++deallocations;
+            allocated -= size;
+            default_allocator().deallocate(ptr, size, alignment);
+        }
+
+        usize allocations = 0;
+        usize deallocations = 0;
+        usize allocated = 0;
+};
+
+y_test_func("PolymorphicAllocator Vector") {
+    CountingAllocator allocator;
+    {
+        memory::Vector<int> vec(allocator);
+        for(int i = 0; i != 1000; ++i) {
+            vec << i;
+        }
+        y_test_assert(allocator.allocations > 0);
+        y_test_assert(allocator.allocated >= 1000 * sizeof(int));
+
+        memory::Vector<int> moved = std::move(vec);
+        y_test_assert(&moved.get_allocator().allocator() == &allocator);
+        y_test_assert(&vec.get_allocator().allocator() == &default_allocator());
+
+        const memory::Vector<int> copy(moved);
+        y_test_assert(&copy.get_allocator().allocator() == &default_allocator());
+        y_test_assert(copy.size() == 1000 && copy[999] == 999);
+    }
+    y_test_assert(allocator.allocated == 0);
+    y_test_assert(allocator.allocations == allocator.deallocations);
+}
+
+y_test_func("PolymorphicAllocator String") {
+    CountingAllocator allocator;
+    {
+        core::String str("a string long enough to not fit in the small string buffer", allocator);
+        y_test_assert(str.is_long());
+        y_test_assert(&str.allocator() == &allocator);
+        y_test_assert(allocator.allocations == 1);
+
+        for(usize i = 0; i != 100; ++i) {
+            str += "more";
+        }
+        y_test_assert(&str.allocator() == &allocator);
+        y_test_assert(str.ends_with("moremore"));
+        y_test_assert(str.size() == 58 + 400);
+
+        const core::String copy = str;
+        y_test_assert(copy == str);
+        y_test_assert(&copy.allocator() == &default_allocator());
+
+        core::String moved = std::move(str);
+        y_test_assert(&moved.allocator() == &allocator);
+
+        // Copy assignment keeps the allocator of the destination
+        const core::String bigger(core::String(moved) + moved);
+        moved = bigger;
+        y_test_assert(moved == bigger);
+        y_test_assert(&moved.allocator() == &allocator);
+
+        const core::String small("small", allocator);
+        y_test_assert(!small.is_long());
+        y_test_assert(&small.allocator() == &default_allocator());
+    }
+    y_test_assert(allocator.allocated == 0);
+    y_test_assert(allocator.allocations == allocator.deallocations);
+}
+
+y_test_func("PolymorphicAllocator FlatHashMap") {
+    CountingAllocator allocator;
+    {
+        memory::FlatHashMap<usize, core::String> map(allocator);
+        for(usize i = 0; i != 1000; ++i) {
+            map[i] = fmt_to_owned("%", i);
+        }
+        for(usize i = 0; i != 1000; i += 2) {
+            map.erase(i);
+        }
+        y_test_assert(allocator.allocations > 0);
+
+        memory::FlatHashMap<usize, core::String> moved = std::move(map);
+        y_test_assert(moved.size() == 500);
+        y_test_assert(moved.find(7)->second == "7");
+        y_test_assert(!moved.contains(8));
+    }
+    y_test_assert(allocator.allocated == 0);
+    y_test_assert(allocator.allocations == allocator.deallocations);
+}
+
+y_test_func("MonotonicAllocator") {
+    MonotonicAllocator allocator(1024);
+    {
+        memory::Vector<memory::Vector<usize>> vecs(allocator);
+        for(usize i = 0; i != 100; ++i) {
+            auto& vec = vecs.emplace_back(PolymorphicAllocator<usize>(allocator));
+            for(usize k = 0; k != i; ++k) {
+                vec << k;
+            }
+        }
+        for(usize i = 0; i != 100; ++i) {
+            y_test_assert(vecs[i].size() == i);
+            y_test_assert(&vecs[i].get_allocator().allocator() == &allocator);
+        }
+    }
+
+    y_test_assert(allocator.stats().block_count > 1);
+    allocator.release();
+    y_test_assert(allocator.stats().block_count == 1);
+    y_test_assert(allocator.stats().allocated == 0);
+}
+
+y_test_func("PoolAllocator") {
+    CountingAllocator upstream;
+    {
+        PoolAllocator pool(upstream);
+
+        core::Vector<std::pair<void*, usize>> allocs;
+        for(usize i = 0; i != 1000; ++i) {
+            const usize size = 1 + (i * 97) % 5000;
+            void* ptr = pool.allocate(size, 8);
+            y_test_assert(!(reinterpret_cast<usize>(ptr) % max_alignment));
+            std::memset(ptr, int(i), size);
+            allocs.emplace_back(ptr, size);
+        }
+
+        const usize chunks = pool.chunk_count();
+        for(const auto& [ptr, size] : allocs) {
+            pool.deallocate(ptr, size, 8);
+        }
+        for(auto& [ptr, size] : allocs) {
+            ptr = pool.allocate(size, 8);
+        }
+        y_test_assert(pool.chunk_count() == chunks);
+
+        for(const auto& [ptr, size] : allocs) {
+            pool.deallocate(ptr, size, 8);
+        }
+    }
+    y_test_assert(upstream.allocated == 0);
+}
+
+}
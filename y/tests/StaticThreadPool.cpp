@@ -0,0 +1,171 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/test/test.h>
+
+#include <y/concurrent/StaticThreadPool.h>
+
+#include <atomic>
+
+namespace {
+using namespace y;
+using namespace y::concurrent;
+
+y_test_func("StaticThreadPool basics") {
+    std::atomic<usize> counter = 0;
+    {
+        StaticThreadPool pool(4);
+        for(usize i = 0; i != 1000; ++i) {
+            pool.schedule([&] { ++counter; });
+        }
+    }
+    y_test_assert(counter == 1000);
+}
+
+y_test_func("StaticThreadPool nested scheduling") {
+    std::atomic<usize> counter = 0;
+    {
+        StaticThreadPool pool(4);
+        for(usize i = 0; i != 64; ++i) {
+            pool.schedule([&] {
+                for(usize j = 0; j != 64; ++j) {
+                    pool.schedule([&] { ++counter; });
+                }
+            });
+        }
+    }
+    y_test_assert(counter == 64 * 64);
+}
+
+y_test_func("StaticThreadPool dependencies") {
+    StaticThreadPool pool(4);
+
+    std::atomic<usize> first = 0;
+    std::atomic<bool> ok = true;
+
+    DependencyGroup deps;
+    for(usize i = 0; i != 100; ++i) {
+        pool.schedule([&] { ++first; }, &deps);
+    }
+
+    DependencyGroup chain = deps;
+    for(usize i = 0; i != 100; ++i) {
+        DependencyGroup next;
+        pool.schedule([&] { ok = ok && first == 100; }, &next, chain);
+        chain = next;
+    }
+
+    auto future = pool.schedule_with_future([&] { return usize(first); }, nullptr, chain);
+    y_test_assert(future.get() == 100);
+    y_test_assert(ok);
+    y_test_assert(chain.is_ready());
+}
+
+y_test_func("StaticThreadPool wait") {
+    StaticThreadPool pool(2);
+
+    std::atomic<usize> counter = 0;
+    DependencyGroup deps;
+    for(usize i = 0; i != 100; ++i) {
+        pool.schedule([&] { ++counter; }, &deps);
+    }
+
+    DependencyGroup chained;
+    for(usize i = 0; i != 100; ++i) {
+        pool.schedule([&] { ++counter; }, &chained, deps);
+    }
+
+    pool.wait(chained);
+    y_test_assert(counter == 200);
+    y_test_assert(chained.is_ready());
+
+    DependencyGroup last;
+    pool.schedule([&] { ++counter; }, &last, chained);
+    last.wait();
+    y_test_assert(counter == 201);
+}
+
+y_test_func("StaticThreadPool wait from worker") {
+    StaticThreadPool pool(1);
+
+    std::atomic<usize> counter = 0;
+    DependencyGroup outer;
+    pool.schedule([&] {
+        // Would deadlock if the only worker couldn't help
+        DependencyGroup inner;
+        for(usize i = 0; i != 10; ++i) {
+            pool.schedule([&] { ++counter; }, &inner);
+        }
+        pool.wait(inner);
+        ++counter;
+    }, &outer);
+
+    pool.wait(outer);
+    y_test_assert(counter == 11);
+}
+
+y_test_func("StaticThreadPool reused group") {
+    StaticThreadPool pool(4);
+
+    // Dependencies are added while the previous ones are being solved, which reopens the group
+    for(usize i = 0; i != 2000; ++i) {
+        std::atomic<usize> counter = 0;
+        DependencyGroup deps;
+        for(usize k = 0; k != 4; ++k) {
+            pool.schedule([&] { ++counter; }, &deps);
+        }
+
+        std::atomic<bool> early = false;
+        DependencyGroup after;
+        pool.schedule([&] { early = counter != 4; }, &after, deps);
+
+        pool.wait(deps);
+        y_test_assert(counter == 4);
+        pool.wait(after);
+        y_test_assert(!early);
+    }
+}
+
+y_test_func("StaticThreadPool schedule_n") {
+    StaticThreadPool pool(4);
+
+    std::atomic<usize> counter = 0;
+    DependencyGroup deps;
+    pool.schedule_n([&] { ++counter; }, 64, &deps);
+    pool.wait(deps);
+    y_test_assert(counter == 64);
+}
+
+y_test_func("StaticThreadPool inline") {
+    StaticThreadPool pool(0);
+
+    usize counter = 0;
+    DependencyGroup deps;
+    pool.schedule([&] { ++counter; }, &deps);
+    pool.schedule([&] { counter *= 2; }, nullptr, deps);
+
+    y_test_assert(counter == 2);
+    y_test_assert(pool.is_empty());
+}
+
+}
+
@@ -0,0 +1,187 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/io2/Buffer.h>
+#include <y/io2/BufferedReader.h>
+#include <y/io2/BufferedWriter.h>
+#include <y/io2/File.h>
+#include <y/io2/MappedFile.h>
+#include <y/test/test.h>
+#include <y/utils/xxh64.h>
+
+#include <cstdio>
+
+namespace {
+using namespace y;
+using namespace y::io2;
+
+static std::unique_ptr<Buffer> make_buffer(usize size) {
+    auto buffer = std::make_unique<Buffer>();
+    for(u32 i = 0; i != size; ++i) {
+        buffer->write_one(i).unwrap();
+    }
+    buffer->reset();
+    return buffer;
+}
+
+y_test_func("BufferedReader read") {
+    const usize count = 10000;
+    BufferedReader reader(make_buffer(count), 100);
+
+    for(u32 i = 0; i != count; ++i) {
+        y_test_assert(reader.tell() == i * sizeof(u32));
+        y_test_assert(reader.read_one<u32>().unwrap() == i);
+    }
+    y_test_assert(reader.at_end());
+    y_test_assert(reader.read_one<u32>().is_error());
+}
+
+y_test_func("BufferedReader large read and seek") {
+    const usize count = 10000;
+    BufferedReader reader(make_buffer(count), 128);
+
+    y_test_assert(reader.read_one<u32>().unwrap() == 0);
+
+    core::Vector<u32> data(1000, 0u);
+    y_test_assert(reader.read_array(data.data(), data.size()));
+    for(u32 i = 0; i != data.size(); ++i) {
+        y_test_assert(data[i] == i + 1);
+    }
+
+    reader.seek(5000 * sizeof(u32));
+    y_test_assert(reader.read_one<u32>().unwrap() == 5000);
+    reader.seek(5010 * sizeof(u32));
+    y_test_assert(reader.read_one<u32>().unwrap() == 5010);
+    reader.seek(4990 * sizeof(u32));
+    y_test_assert(reader.read_one<u32>().unwrap() == 4990);
+    y_test_assert(reader.remaining() == (count - 4991) * sizeof(u32));
+
+    core::Vector<byte> all;
+    y_test_assert(reader.read_all(all).unwrap() == (count - 4991) * sizeof(u32));
+    y_test_assert(reader.at_end());
+}
+
+y_test_func("BufferedWriter write") {
+    auto buffer = std::make_unique<Buffer>();
+    const Buffer* data = buffer.get();
+
+    BufferedWriter writer(std::move(buffer), 100);
+    for(u32 i = 0; i != 1000; ++i) {
+        y_test_assert(writer.tell() == i * sizeof(u32));
+        writer.write_one(i).unwrap();
+    }
+    y_test_assert(data->size() < 1000 * sizeof(u32));
+
+    writer.seek(0);
+    writer.write_one(u32(7)).unwrap();
+
+    const core::Vector<u32> large(500, 9u);
+    writer.seek(1000 * sizeof(u32));
+    writer.write_array(large.data(), large.size()).unwrap();
+
+    y_test_assert(writer.flush());
+    y_test_assert(data->size() == 1500 * sizeof(u32));
+
+    const u32* values = reinterpret_cast<const u32*>(data->data());
+    y_test_assert(values[0] == 7);
+    for(u32 i = 1; i != 1000; ++i) {
+        y_test_assert(values[i] == i);
+    }
+    y_test_assert(values[1499] == 9);
+}
+
+y_test_func("MappedFile read") {
+    const core::String name = "y_test_mapped_file.bin";
+    {
+        auto file = File::create(name);
+        y_test_assert(file);
+        for(u32 i = 0; i != 1000; ++i) {
+            file.unwrap().write_one(i).unwrap();
+        }
+    }
+
+    {
+        auto r = MappedFile::open(name);
+        y_test_assert(r);
+        MappedFile file = std::move(r.unwrap());
+        y_test_assert(file.size() == 1000 * sizeof(u32));
+
+        for(u32 i = 0; i != 1000; ++i) {
+            y_test_assert(file.read_one<u32>().unwrap() == i);
+        }
+        y_test_assert(file.at_end());
+        y_test_assert(file.read_one<u32>().is_error());
+
+        file.seek(10 * sizeof(u32));
+        y_test_assert(reinterpret_cast<const u32*>(file.data())[10] == 10);
+        y_test_assert(file.read_one<u32>().unwrap() == 10);
+    }
+
+    std::remove(name.data());
+    y_test_assert(MappedFile::open(name).is_error());
+}
+
+y_test_func("MappedFile slice of appended file") {
+    const core::String name = "y_test_mapped_slice.bin";
+    std::remove(name.data());
+    for(u32 i = 0; i != 1000; ++i) {
+        auto file = File::open_append(name);
+        y_test_assert(file);
+        file.unwrap().write_one(i).unwrap();
+    }
+
+    {
+        MappedFile slice;
+        {
+            MappedFile file = std::move(MappedFile::open(name).unwrap());
+            y_test_assert(file.size() == 1000 * sizeof(u32));
+            slice = file.slice(100 * sizeof(u32), 10 * sizeof(u32));
+        }
+
+        y_test_assert(slice.size() == 10 * sizeof(u32));
+        for(u32 i = 0; i != 10; ++i) {
+            y_test_assert(slice.read_one<u32>().unwrap() == 100 + i);
+        }
+        y_test_assert(slice.at_end());
+        y_test_assert(slice.read_one<u32>().is_error());
+    }
+
+    std::remove(name.data());
+}
+
+y_test_func("File copy hash") {
+    const core::String name = "y_test_copy_hash.bin";
+    const usize count = 100000;
+
+    auto buffer = make_buffer(count);
+    const u64 hash = File::copy(*buffer, name).unwrap();
+    y_test_assert(hash == xxh64(buffer->data(), buffer->size()));
+
+    {
+        MappedFile file = std::move(MappedFile::open(name).unwrap());
+        y_test_assert(file.size() == count * sizeof(u32));
+        y_test_assert(xxh64(file.data(), file.size()) == hash);
+    }
+
+    std::remove(name.data());
+}
+}
@@ -0,0 +1,105 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/test/test.h>
+
+#include <y/concurrent/parallel.h>
+#include <y/concurrent/TaskGraph.h>
+
+#include <y/core/Vector.h>
+
+namespace {
+using namespace y;
+using namespace y::concurrent;
+
+y_test_func("parallel_for basics") {
+    core::Vector<u32> values(100000, 0u);
+    parallel_for(0, values.size(), 64, [&](usize i) {
+        values[i] += u32(i);
+    });
+
+    for(usize i = 0; i != values.size(); ++i) {
+        y_test_assert(values[i] == u32(i));
+    }
+}
+
+y_test_func("parallel_for small ranges") {
+    for(usize size = 0; size != 16; ++size) {
+        for(usize grain = 0; grain != 4; ++grain) {
+            core::Vector<u32> values(size, 0u);
+            parallel_for(values, grain, [](u32& v) { ++v; });
+            for(const u32 v : values) {
+                y_test_assert(v == 1);
+            }
+        }
+    }
+}
+
+y_test_func("parallel_for nested") {
+    std::atomic<usize> counter = 0;
+    parallel_for(0, 64, 1, [&](usize) {
+        parallel_for(0, 1000, 16, [&](usize) {
+            ++counter;
+        });
+    });
+    y_test_assert(counter == 64 * 1000);
+}
+
+y_test_func("parallel_reduce basics") {
+    const usize size = 1000000;
+    const u64 sum = parallel_reduce(0, size, 1024, u64(0), [](usize b, usize e) {
+        u64 s = 0;
+        for(usize i = b; i != e; ++i) {
+            s += i;
+        }
+        return s;
+    }, [](u64 a, u64 b) { return a + b; });
+
+    y_test_assert(sum == u64(size) * (size - 1) / 2);
+}
+
+y_test_func("TaskGraph basics") {
+    std::atomic<u32> step = 0;
+    std::atomic<bool> ok = true;
+
+    TaskGraph graph;
+    const auto a = graph.add_node([&] { ok = ok && step.fetch_add(1) == 0; });
+    const auto b = graph.add_node([&] { const u32 s = step.fetch_add(1); ok = ok && (s == 1 || s == 2); });
+    const auto c = graph.add_node([&] { const u32 s = step.fetch_add(1); ok = ok && (s == 1 || s == 2); });
+    const auto d = graph.add_node([&] { ok = ok && step.fetch_add(1) == 3; });
+
+    graph.add_edge(a, b);
+    graph.add_edge(a, c);
+    graph.add_edge(b, d);
+    graph.add_edge(c, d);
+
+    for(usize i = 0; i != 8; ++i) {
+        step = 0;
+        graph.run();
+        graph.wait();
+        y_test_assert(step == 4);
+    }
+    y_test_assert(ok);
+}
+
+}
+
@@ -0,0 +1,61 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/utils/xxh64.h>
+
+#include <y/test/test.h>
+
+#include <y/core/Vector.h>
+
+#include <string_view>
+
+namespace {
+using namespace y;
+
+static u64 hash_str(std::string_view str) {
+    return xxh64(str.data(), str.size());
+}
+
+y_test_func("xxh64 reference values") {
+    y_test_assert(hash_str("") == 0xEF46DB3751D8E999);
+    y_test_assert(hash_str("abc") == 0x44BC2CF5AD770999);
+    y_test_assert(hash_str("Nobody inspects the spammish repetition") == 0xFBCEA83C8A378BF1);
+}
+
+y_test_func("xxh64 streaming") {
+    core::Vector<u8> data;
+    for(usize i = 0; i != 1000; ++i) {
+        data << u8(i * 31 + 7);
+    }
+
+    for(usize chunk = 1; chunk != 70; ++chunk) {
+        Xxh64 hasher;
+        for(usize i = 0; i < data.size(); i += chunk) {
+            hasher.update(data.data() + i, std::min(chunk, data.size() - i));
+        }
+        y_test_assert(hasher.digest() == xxh64(data.data(), data.size()));
+    }
+
+    y_test_assert(xxh64(data.data(), data.size()) != xxh64(data.data(), data.size() - 1));
+    y_test_assert(xxh64(data.data(), data.size(), 1) != xxh64(data.data(), data.size()));
+}
+}
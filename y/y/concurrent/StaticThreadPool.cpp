@@ -26,11 +26,36 @@ SOFTWARE.
 #include <y/core/Chrono.h>
 #include <y/utils/format.h>
 
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
 namespace y {
 namespace concurrent {
 
+struct DependencyGroup::SharedState : NonMovable {
+    // Replaces the continuation list once the group is ready
+    static Continuation* ready_marker() {
+        return reinterpret_cast<Continuation*>(usize(1));
+    }
+
+    ~SharedState() {
+        // Continuations of a group that will never be ready are dropped
+        Continuation* cont = continuations;
+        while(cont && cont != ready_marker()) {
+            delete std::exchange(cont, cont->next);
+        }
+    }
+
+    std::atomic<u32> counter = 1;
+    std::atomic<Continuation*> continuations = nullptr;
+
+    // Orders reopening an expired group against publishing the ready marker, only taken when the counter reaches or leaves 0
+    std::mutex lock;
+};
+
 bool DependencyGroup::is_empty() const {
-    return _counter == nullptr;
+    return _state == nullptr;
 }
 
 bool DependencyGroup::is_ready() const {
@@ -38,58 +63,321 @@ bool DependencyGroup::is_ready() const {
 }
 
 bool DependencyGroup::is_expired() const {
-    return _counter != nullptr && (*_counter) == 0;
+    return _state != nullptr && _state->counter == 0;
 }
 
 u32 DependencyGroup::dependency_count() const {
-    return !_counter ? u32(0) : u32(*_counter);
+    return !_state ? u32(0) : u32(_state->counter);
+}
+
+void DependencyGroup::wait() const {
+    struct WakeUp : Continuation {
+        void run() override {
+            const std::unique_lock l(lock);
+            done = true;
+            condition.notify_all();
+        }
+
+        std::mutex lock;
+        std::condition_variable condition;
+        bool done = false;
+    };
+
+    WakeUp wake_up;
+    if(add_continuation(&wake_up)) {
+        std::unique_lock lock(wake_up.lock);
+        wake_up.condition.wait(lock, [&] { return wake_up.done; });
+    }
 }
 
 void DependencyGroup::add_dependency() {
-    if(!_counter) {
-        _counter = std::make_shared<std::atomic<u32>>(1);
-    } else {
-        ++(*_counter);
+    if(!_state) {
+        _state = std::make_shared<SharedState>();
+    } else if(_state->counter++ == 0) {
+        // Reusing an expired group: reopen the continuation list.
+        // If the last solve_dependency hasn't published the ready marker yet, it will see the new dependency and leave the list open.
+        const std::unique_lock lock(_state->lock);
+        Continuation* expected = SharedState::ready_marker();
+        _state->continuations.compare_exchange_strong(expected, nullptr);
     }
 }
 
 void DependencyGroup::solve_dependency() {
-    if(_counter) {
-        y_debug_assert(*_counter != 0); // not 100% thread safe but we don't care
-        --(*_counter);
+    if(!_state) {
+        return;
+    }
+
+    y_debug_assert(_state->counter != 0); // not 100% thread safe but we don't care
+    if(--_state->counter != 0) {
+        return;
+    }
+
+    Continuation* cont = nullptr;
+    {
+        const std::unique_lock lock(_state->lock);
+        // The group might have been reopened in between, or readied by the solver of a dependency added since
+        if(_state->counter != 0 || _state->continuations == SharedState::ready_marker()) {
+            return;
+        }
+        cont = _state->continuations.exchange(SharedState::ready_marker());
+    }
+
+    // Continuations are pushed in front, reverse the list to run them in order
+    Continuation* reversed = nullptr;
+    while(cont) {
+        Continuation* next = cont->next;
+        cont->next = reversed;
+        reversed = cont;
+        cont = next;
+    }
+
+    while(reversed) {
+        // run might destroy the continuation
+        Continuation* next = reversed->next;
+        reversed->run();
+        reversed = next;
     }
 }
 
+bool DependencyGroup::add_continuation(Continuation* continuation) const {
+    if(!_state) {
+        return false;
+    }
 
-StaticThreadPool::FuncData::FuncData(Func func, DependencyGroup wait, DependencyGroup done) :
-        function(std::move(func)),
-        wait_for(std::move(wait)),
-        on_done(std::move(done)) {
+    Continuation* head = _state->continuations;
+    do {
+        if(head == SharedState::ready_marker()) {
+            return false;
+        }
+        continuation->next = head;
+    } while(!_state->continuations.compare_exchange_weak(head, continuation));
+
+    return true;
 }
 
-StaticThreadPool::StaticThreadPool(usize thread_count) {
+
+
+
+// Every worker owns a deque: it pushes and pops at the back while other workers steal from the front.
+// Tasks scheduled from outside of the pool go into the injection queue.
+// Tasks that wait on a DependencyGroup are parked in the group itself and pushed back when it becomes ready.
+struct StaticThreadPool::SharedData : NonMovable {
+    struct Task {
+        Func function;
+        DependencyGroup on_done;
+    };
+
+    struct ParkedTask : DependencyGroup::Continuation {
+        void run() override {
+            if(const auto d = data.lock()) {
+                if(d->generation == generation) {
+                    --d->parked;
+                    d->push(std::move(task));
+                }
+            }
+            delete this;
+        }
+
+        std::weak_ptr<SharedData> data;
+        u32 generation = 0;
+        Task task;
+    };
+
+    struct WorkQueue : NonMovable {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    static inline thread_local const SharedData* current = nullptr;
+    static inline thread_local usize current_index = 0;
+
+    SharedData(usize workers) : queues(std::make_unique<WorkQueue[]>(workers + 1)), queue_count(workers + 1) {
+    }
+
+    usize worker_count() const {
+        return queue_count - 1;
+    }
+
+    usize local_queue_index() const {
+        return current == this ? current_index : worker_count();
+    }
+
+    void push(Task&& task) {
+        {
+            WorkQueue& queue = queues[local_queue_index()];
+            const std::unique_lock lock(queue.lock);
+            queue.tasks.emplace_back(std::move(task));
+            ++queued;
+        }
+
+        if(sleeping) {
+            const std::unique_lock lock(sleep_lock);
+            condition.notify_one();
+        }
+
+        if(!worker_count()) {
+            process_until_empty();
+        }
+    }
+
+    bool pop(Task& task, usize index) {
+        if(index != worker_count()) {
+            WorkQueue& queue = queues[index];
+            const std::unique_lock lock(queue.lock);
+            if(!queue.tasks.empty()) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                return true;
+            }
+        }
+
+        // Start with the injection queue, then go around the other workers, starting after our own queue
+        const usize injection_index = worker_count();
+        for(usize i = 0; i != queue_count; ++i) {
+            const usize victim = i ? (index + i) % queue_count : injection_index;
+            if(i && victim == injection_index) {
+                continue;
+            }
+
+            WorkQueue& queue = queues[victim];
+            const std::unique_lock lock(queue.lock);
+            if(!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool process_one(usize index) {
+        Task task;
+        if(!pop(task, index)) {
+            return false;
+        }
+
+        ++working;
+        --queued;
+        y_defer(--working);
+
+        task.function();
+        task.on_done.solve_dependency();
+
+        return true;
+    }
+
+    void process_until_empty() {
+        const usize index = local_queue_index();
+        while(process_one(index)) {
+            // Nothing
+        }
+    }
+
+    void worker(usize index) {
+        current = this;
+        current_index = index;
+
+        while(run) {
+            if(process_one(index)) {
+                continue;
+            }
+
+            std::unique_lock lock(sleep_lock);
+            ++sleeping;
+            condition.wait(lock, [&] { return queued || !run; });
+            --sleeping;
+        }
+
+        current = nullptr;
+    }
+
+    void wait(const DependencyGroup& group) {
+        struct WakeUp : DependencyGroup::Continuation {
+            void run() override {
+                // The waiter might return as soon as done is set
+                SharedData* d = data;
+                const std::unique_lock lock(d->sleep_lock);
+                done = true;
+                d->condition.notify_all();
+            }
+
+            SharedData* data = nullptr;
+            std::atomic<bool> done = false;
+        };
+
+        WakeUp wake_up;
+        wake_up.data = this;
+        if(!group.add_continuation(&wake_up)) {
+            return;
+        }
+
+        const usize index = local_queue_index();
+        while(!wake_up.done) {
+            if(process_one(index)) {
+                continue;
+            }
+
+            std::unique_lock lock(sleep_lock);
+            ++sleeping;
+            condition.wait(lock, [&] { return wake_up.done || queued; });
+            --sleeping;
+        }
+    }
+
+    void cancel() {
+        for(usize i = 0; i != queue_count; ++i) {
+            WorkQueue& queue = queues[i];
+            const std::unique_lock lock(queue.lock);
+            queued -= u32(queue.tasks.size());
+            queue.tasks.clear();
+        }
+
+        parked = 0;
+        ++generation;
+    }
+
+    std::unique_ptr<WorkQueue[]> queues;
+    usize queue_count = 0;
+
+    std::mutex sleep_lock;
+    std::condition_variable condition;
+
+    std::atomic<u32> queued = 0;
+    std::atomic<u32> working = 0;
+    std::atomic<u32> parked = 0;
+    std::atomic<u32> sleeping = 0;
+    std::atomic<u32> generation = 0;
+    std::atomic<bool> run = true;
+};
+
+
+StaticThreadPool::StaticThreadPool(usize thread_count) : _shared_data(std::make_shared<SharedData>(thread_count)) {
     for(usize i = 0; i != thread_count; ++i) {
-        _threads.emplace_back([this, i] {
+        _threads.emplace_back([data = _shared_data.get(), i] {
             concurrent::set_thread_name(fmt_c_str("Worker thread #%", i));
-            worker();
+            data->worker(i);
         });
     }
 }
 
 StaticThreadPool::~StaticThreadPool() {
-    process_until_empty();
+    // Parked tasks that never get released are dropped
+    while(_shared_data->queued || _shared_data->working) {
+        if(!_shared_data->process_one(_shared_data->local_queue_index())) {
+            std::this_thread::yield();
+        }
+    }
 
     {
-        _shared_data.run = false;
-        const std::unique_lock<std::mutex> lock(_shared_data.lock);
-        _shared_data.condition.notify_all();
+        _shared_data->run = false;
+        const std::unique_lock lock(_shared_data->sleep_lock);
+        _shared_data->condition.notify_all();
     }
 
     for(auto& thread : _threads) {
         thread.join();
     }
-
-    y_debug_assert(is_empty());
 }
 
 usize StaticThreadPool::concurency() const {
@@ -97,84 +385,68 @@ usize StaticThreadPool::concurency() const {
 }
 
 bool StaticThreadPool::is_empty() const {
-    const std::unique_lock lock(_shared_data.lock);
-    return _shared_data.queue.empty() && !_shared_data.working;
+    return !pending_tasks();
 }
 
 usize StaticThreadPool::pending_tasks() const {
-    const std::unique_lock lock(_shared_data.lock);
-    return _shared_data.queue.size() + _shared_data.working;
+    return _shared_data->queued + _shared_data->working + _shared_data->parked;
 }
 
 void StaticThreadPool::cancel_pending_tasks() {
-    const std::unique_lock lock(_shared_data.lock);
-    _shared_data.queue.clear();
+    _shared_data->cancel();
 }
 
-void StaticThreadPool::process_until_empty() {
-    while(true) {
-        std::unique_lock<std::mutex> lock(_shared_data.lock);
-        if(!process_one(std::move(lock))) {
-            break;
-        }
-        // Nothing
-    }
+void StaticThreadPool::wait(const DependencyGroup& group) {
+    _shared_data->wait(group);
 }
 
 void StaticThreadPool::schedule(Func&& func, DependencyGroup* on_done, DependencyGroup wait_for) {
-    y_debug_assert(_shared_data.run);
+    y_debug_assert(_shared_data->run);
 
-    {
-        const auto lock = std::unique_lock(_shared_data.lock);
-        if(on_done) {
-            on_done->add_dependency();
-            _shared_data.queue.emplace_back(std::move(func), std::move(wait_for), *on_done);
-        } else {
-            _shared_data.queue.emplace_back(std::move(func), std::move(wait_for));
-        }
+    SharedData::Task task;
+    task.function = std::move(func);
+    if(on_done) {
+        on_done->add_dependency();
+        task.on_done = *on_done;
     }
 
-    if(concurency()) {
-        _shared_data.condition.notify_one();
+    if(!wait_for.is_ready()) {
+        auto parked = std::make_unique<SharedData::ParkedTask>();
+        parked->data = _shared_data;
+        parked->generation = _shared_data->generation;
+        parked->task = std::move(task);
+
+        ++_shared_data->parked;
+        if(wait_for.add_continuation(parked.get())) {
+            parked.release();
+        } else {
+            --_shared_data->parked;
+            _shared_data->push(std::move(parked->task));
+        }
     } else {
-        process_until_empty();
+        _shared_data->push(std::move(task));
     }
 }
 
-bool StaticThreadPool::process_one(std::unique_lock<std::mutex> lock) {
-    ++_shared_data.working;
-    y_defer(--_shared_data.working);
+void StaticThreadPool::schedule_n(const Func& func, usize count, DependencyGroup* on_done) {
+    y_debug_assert(_shared_data->run);
 
-    for(auto it = _shared_data.queue.begin(); it != _shared_data.queue.end(); ++it) {
-        if(it->wait_for.is_ready()) {
-            auto f = std::move(*it);
-            _shared_data.queue.erase(it);
-
-            lock.unlock();
-
-            f.function();
-
-            {
-                f.on_done.solve_dependency();
-                if(f.on_done.is_ready()) {
-                    _shared_data.condition.notify_one();
-                }
-            }
-            return true;
+    // Otherwise the first tasks could make the group ready before the last ones are scheduled
+    if(on_done) {
+        for(usize i = 0; i != count; ++i) {
+            on_done->add_dependency();
         }
     }
 
-    return false;
-}
-
-void StaticThreadPool::worker() {
-    while(_shared_data.run) {
-        std::unique_lock<std::mutex> lock(_shared_data.lock);
-        _shared_data.condition.wait(lock, [&] { return !_shared_data.queue.empty() || !_shared_data.run; });
-        process_one(std::move(lock));
+    for(usize i = 0; i != count; ++i) {
+        SharedData::Task task;
+        task.function = func;
+        if(on_done) {
+            task.on_done = *on_done;
+        }
+        _shared_data->push(std::move(task));
     }
 }
 
 }
 }
-
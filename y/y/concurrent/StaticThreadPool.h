@@ -26,13 +26,10 @@ SOFTWARE.
 
 #include "concurrent.h"
 
-#include <list>
 #include <functional>
 #include <thread>
-#include <mutex>
 #include <atomic>
 #include <future>
-#include <condition_variable>
 
 namespace y {
 namespace concurrent {
@@ -48,36 +45,36 @@ class DependencyGroup {
         bool is_expired() const;
         u32 dependency_count() const;
 
+        // Blocks until the group is ready, use StaticThreadPool::wait to help with the work instead
+        void wait() const;
+
     private:
         friend class StaticThreadPool;
 
+        struct SharedState;
+
+        // Intrusive list node, run once by whoever solves the last dependency
+        struct Continuation : NonMovable {
+            virtual ~Continuation() = default;
+            virtual void run() = 0;
+
+            Continuation* next = nullptr;
+        };
+
         void add_dependency();
         void solve_dependency();
 
-        std::shared_ptr<std::atomic<u32>> _counter;
+        // Returns false if the group is already ready, in which case the continuation has not been added
+        bool add_continuation(Continuation* continuation) const;
+
+        std::shared_ptr<SharedState> _state;
 };
 
 class StaticThreadPool : NonMovable {
     private:
         using Func = std::function<void()>;
 
-        struct FuncData : NonCopyable {
-            FuncData(Func func, DependencyGroup wait, DependencyGroup done = DependencyGroup());
-
-            Func function;
-            DependencyGroup wait_for;
-            DependencyGroup on_done;
-        };
-
-        struct SharedData {
-            mutable std::mutex lock;
-            std::condition_variable condition;
-
-            std::list<FuncData> queue;
-
-            std::atomic<u32> working = 0;
-            std::atomic<bool> run = true;
-        };
+        struct SharedData;
 
     public:
         StaticThreadPool(usize thread_count = std::max(4u, std::thread::hardware_concurrency()));
@@ -89,8 +86,14 @@ class StaticThreadPool : NonMovable {
 
         void cancel_pending_tasks();
 
+        // Runs tasks from the pool until the group is ready
+        void wait(const DependencyGroup& group);
+
         void schedule(Func&& func, DependencyGroup* on_done = nullptr, DependencyGroup wait_for = DependencyGroup());
 
+        // Schedules count copies of func. Their dependencies are all added to on_done before any of them can run.
+        void schedule_n(const Func& func, usize count, DependencyGroup* on_done = nullptr);
+
         template<typename F, typename R = decltype(std::declval<F>()())>
         std::future<R> schedule_with_future(F&& func, DependencyGroup* on_done = nullptr, DependencyGroup wait_for = DependencyGroup()) {
             auto promise = std::make_shared<std::promise<R>>();
@@ -100,12 +103,7 @@ class StaticThreadPool : NonMovable {
         }
 
     private:
-        // Empty means all tasks are scheduled, not done!
-        void process_until_empty();
-        bool process_one(std::unique_lock<std::mutex> lock);
-        void worker();
-
-        SharedData _shared_data;
+        std::shared_ptr<SharedData> _shared_data;
         core::Vector<std::thread> _threads;
 };
 
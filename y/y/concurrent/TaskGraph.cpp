@@ -0,0 +1,139 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "TaskGraph.h"
+#include "parallel.h"
+
+namespace y {
+namespace concurrent {
+
+TaskGraph::TaskGraph() : TaskGraph(default_thread_pool()) {
+}
+
+TaskGraph::TaskGraph(StaticThreadPool& pool) : _pool(&pool) {
+}
+
+TaskGraph::~TaskGraph() {
+    wait();
+}
+
+usize TaskGraph::node_count() const {
+    return _nodes.size();
+}
+
+bool TaskGraph::is_running() const {
+    return !_done.is_ready();
+}
+
+TaskGraph::NodeId TaskGraph::add_node(std::function<void()> func) {
+    y_debug_assert(!is_running());
+
+    const NodeId id = _nodes.size();
+    _nodes.emplace_back().func = std::move(func);
+    _checked = false;
+    return id;
+}
+
+void TaskGraph::add_edge(NodeId from, NodeId to) {
+    y_debug_assert(!is_running());
+    y_debug_assert(from < _nodes.size() && to < _nodes.size());
+    y_debug_assert(from != to);
+
+    _nodes[from].successors << to;
+    ++_nodes[to].predecessors;
+    _checked = false;
+}
+
+void TaskGraph::run() {
+    y_debug_assert(!is_running());
+
+    if(_nodes.is_empty()) {
+        return;
+    }
+
+    _pending = std::make_unique<std::atomic<u32>[]>(_nodes.size());
+    for(usize i = 0; i != _nodes.size(); ++i) {
+        _pending[i] = _nodes[i].predecessors;
+    }
+
+    // A cycle would never complete and wait() would hang
+    if(!_checked) {
+        y_always_assert(is_acyclic(), "TaskGraph has a cycle");
+        _checked = true;
+    }
+
+    // Roots are scheduled from a task so that _done can not become ready before all of them have been scheduled
+    _pool->schedule([this] {
+        for(usize i = 0; i != _nodes.size(); ++i) {
+            if(!_nodes[i].predecessors) {
+                _pool->schedule([this, i] { run_node(i); }, &_done);
+            }
+        }
+    }, &_done);
+}
+
+void TaskGraph::wait() {
+    _pool->wait(_done);
+}
+
+bool TaskGraph::is_acyclic() const {
+    core::Vector<u32> predecessors(_nodes.size(), 0);
+    core::Vector<NodeId> ready;
+    for(usize i = 0; i != _nodes.size(); ++i) {
+        predecessors[i] = _nodes[i].predecessors;
+        if(!predecessors[i]) {
+            ready << i;
+        }
+    }
+
+    usize sorted = 0;
+    while(!ready.is_empty()) {
+        const NodeId id = ready.pop();
+        ++sorted;
+        for(const NodeId next : _nodes[id].successors) {
+            if(--predecessors[next] == 0) {
+                ready << next;
+            }
+        }
+    }
+
+    return sorted == _nodes.size();
+}
+
+void TaskGraph::run_node(NodeId id) {
+    const Node& node = _nodes[id];
+
+    if(node.func) {
+        node.func();
+    }
+
+    for(const NodeId next : node.successors) {
+        if(--_pending[next] == 0) {
+            // Scheduled before this node is marked as done, so _done can not be ready until every node has run
+            _pool->schedule([this, next] { run_node(next); }, &_done);
+        }
+    }
+}
+
+}
+}
+
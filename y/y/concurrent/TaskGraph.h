@@ -0,0 +1,79 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_CONCURRENT_TASKGRAPH_H
+#define Y_CONCURRENT_TASKGRAPH_H
+
+#include "StaticThreadPool.h"
+
+namespace y {
+namespace concurrent {
+
+// Acyclic graph of tasks: a node is scheduled on the pool once all the nodes it depends on are done.
+// The graph can be run again once it has been waited on.
+class TaskGraph : NonMovable {
+    public:
+        using NodeId = usize;
+
+        TaskGraph();
+        TaskGraph(StaticThreadPool& pool);
+        ~TaskGraph();
+
+        usize node_count() const;
+        bool is_running() const;
+
+        NodeId add_node(std::function<void()> func);
+
+        // to will not start before from is done
+        void add_edge(NodeId from, NodeId to);
+
+        void run();
+
+        // Helps the pool until the whole graph is done
+        void wait();
+
+    private:
+        struct Node {
+            std::function<void()> func;
+            core::Vector<NodeId> successors;
+            u32 predecessors = 0;
+        };
+
+        void run_node(NodeId id);
+
+        // Kahn's algorithm: every node can be sorted only if there is no cycle
+        bool is_acyclic() const;
+
+        StaticThreadPool* _pool = nullptr;
+        core::Vector<Node> _nodes;
+
+        // Cleared when the graph changes, so that running it again doesn't check it again
+        bool _checked = false;
+
+        std::unique_ptr<std::atomic<u32>[]> _pending;
+        DependencyGroup _done;
+};
+
+}
+}
+
+#endif // Y_CONCURRENT_TASKGRAPH_H
+
@@ -0,0 +1,107 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "parallel.h"
+
+namespace y {
+namespace concurrent {
+
+StaticThreadPool& default_thread_pool() {
+    static StaticThreadPool pool;
+    return pool;
+}
+
+namespace detail {
+
+struct ParallelForState {
+    std::atomic<usize> cursor = 0;
+
+    usize end = 0;
+    usize grain = 1;
+    usize participants = 1;
+
+    ChunkFunc func = nullptr;
+    void* user_data = nullptr;
+
+    bool process_one() {
+        usize begin = cursor.load();
+        usize size = 0;
+        do {
+            const usize remaining = end - begin;
+            if(!remaining) {
+                return false;
+            }
+
+            // Guided scheduling: big chunks first, smaller and smaller ones as we get near the end
+            size = std::min(remaining, std::max(grain, remaining / (participants * 2)));
+        } while(!cursor.compare_exchange_weak(begin, begin + size));
+
+        func(user_data, begin, begin + size);
+        return true;
+    }
+};
+
+void parallel_for_chunks(StaticThreadPool& pool, usize begin, usize end, usize grain, ChunkFunc func, void* user_data) {
+    y_debug_assert(begin <= end);
+
+    grain = std::max(grain, usize(1));
+
+    const usize size = end - begin;
+    if(size <= grain || !pool.concurency()) {
+        if(size) {
+            func(user_data, begin, end);
+        }
+        return;
+    }
+
+    const usize helpers = std::min(pool.concurency(), (size - 1) / grain);
+
+    ParallelForState state;
+    state.cursor = begin;
+    state.end = end;
+    state.grain = grain;
+    state.participants = helpers + 1;
+    state.func = func;
+    state.user_data = user_data;
+
+    // All the helpers are registered before any of them runs: the group can't be ready while one of them still uses state
+    DependencyGroup helpers_done;
+    pool.schedule_n([&state] {
+        while(state.process_one()) {
+            // Nothing
+        }
+    }, helpers, &helpers_done);
+
+    while(state.process_one()) {
+        // Nothing
+    }
+
+    // Helpers that have not started yet find nothing left to do. Waiting on the pool runs other tasks
+    // instead of spinning, which matters when we are ourselves running on one of its workers.
+    pool.wait(helpers_done);
+}
+
+}
+
+}
+}
+
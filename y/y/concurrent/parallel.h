@@ -0,0 +1,89 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_CONCURRENT_PARALLEL_H
+#define Y_CONCURRENT_PARALLEL_H
+
+#include "StaticThreadPool.h"
+
+#include <mutex>
+
+namespace y {
+namespace concurrent {
+
+// Lazily created pool shared by everything that doesn't need its own threads
+StaticThreadPool& default_thread_pool();
+
+namespace detail {
+using ChunkFunc = void (*)(void* user_data, usize begin, usize end);
+
+void parallel_for_chunks(StaticThreadPool& pool, usize begin, usize end, usize grain, ChunkFunc func, void* user_data);
+}
+
+
+// Splits [begin, end) into contiguous chunks of at least grain elements and calls func(chunk_begin, chunk_end) on each.
+// Chunks get smaller as the range runs out so that threads finish at roughly the same time.
+// The calling thread takes part in the work and the call returns once every chunk has been processed.
+template<typename F>
+void parallel_for_chunks(usize begin, usize end, usize grain, F&& func) {
+    detail::parallel_for_chunks(default_thread_pool(), begin, end, grain, [](void* user_data, usize b, usize e) {
+        (*static_cast<std::remove_reference_t<F>*>(user_data))(b, e);
+    }, const_cast<void*>(static_cast<const void*>(&func)));
+}
+
+template<typename F>
+void parallel_for(usize begin, usize end, usize grain, F&& func) {
+    parallel_for_chunks(begin, end, grain, [&](usize b, usize e) {
+        for(usize i = b; i != e; ++i) {
+            func(i);
+        }
+    });
+}
+
+template<typename R, typename F>
+void parallel_for(R&& range, usize grain, F&& func) {
+    const auto beg = std::begin(range);
+    parallel_for_chunks(0, usize(std::end(range) - beg), grain, [&](usize b, usize e) {
+        for(auto it = beg + b; it != beg + e; ++it) {
+            func(*it);
+        }
+    });
+}
+
+// func(chunk_begin, chunk_end) returns the partial result of a chunk, partial results are merged with combine.
+// The order in which partial results are combined is not deterministic: combine should be associative and commutative.
+template<typename T, typename F, typename C>
+T parallel_reduce(usize begin, usize end, usize grain, T identity, F&& func, C&& combine) {
+    std::mutex lock;
+    T result = std::move(identity);
+    parallel_for_chunks(begin, end, grain, [&](usize b, usize e) {
+        T partial = func(b, e);
+        const std::unique_lock l(lock);
+        result = combine(std::move(result), std::move(partial));
+    });
+    return result;
+}
+
+}
+}
+
+#endif // Y_CONCURRENT_PARALLEL_H
+
@@ -0,0 +1,132 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_CORE_BORROWABLEVECTOR_H
+#define Y_CORE_BORROWABLEVECTOR_H
+
+#include "Vector.h"
+
+#include <memory>
+
+namespace y {
+namespace core {
+
+// Read only array that either owns its elements or borrows them from memory kept alive by a shared owner
+// (for example a mapped file), so large trivially copyable payloads can be used without being copied.
+// Compat is the container it replaces in serialized data: serde3 hashes it as Compat so existing archives still load.
+template<typename T, typename Compat = Vector<T>>
+class BorrowableVector {
+
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    public:
+        using value_type = T;
+        using size_type = usize;
+
+        using iterator = const T*;
+        using const_iterator = const T*;
+
+        using serde3_hash_as = Compat;
+
+        BorrowableVector() = default;
+
+        BorrowableVector(Vector<T> owned) : _owned(std::move(owned)) {
+        }
+
+        BorrowableVector(Span<T> borrowed, std::shared_ptr<const void> owner) {
+            borrow(borrowed, std::move(owner));
+        }
+
+        void borrow(Span<T> borrowed, std::shared_ptr<const void> owner) {
+            y_debug_assert(owner || borrowed.is_empty());
+            _owned.clear();
+            _borrowed = borrowed;
+            _owner = std::move(owner);
+        }
+
+        bool is_borrowed() const {
+            return _owner != nullptr;
+        }
+
+        // Copies borrowed elements if needed
+        Vector<T>& to_owned() {
+            if(is_borrowed()) {
+                _owned.assign(_borrowed.begin(), _borrowed.end());
+                _borrowed = {};
+                _owner = nullptr;
+            }
+            return _owned;
+        }
+
+        void make_empty() {
+            _owned.make_empty();
+            _borrowed = {};
+            _owner = nullptr;
+        }
+
+        void resize(usize size) {
+            Vector<T>& owned = to_owned();
+            while(owned.size() > size) {
+                owned.pop();
+            }
+            owned.set_min_size(size);
+        }
+
+        usize size() const {
+            return is_borrowed() ? _borrowed.size() : _owned.size();
+        }
+
+        bool is_empty() const {
+            return !size();
+        }
+
+        const T* data() const {
+            return is_borrowed() ? _borrowed.data() : _owned.data();
+        }
+
+        const_iterator begin() const {
+            return data();
+        }
+
+        const_iterator end() const {
+            return data() + size();
+        }
+
+        const T& operator[](usize i) const {
+            y_debug_assert(i < size());
+            return data()[i];
+        }
+
+        operator Span<T>() const {
+            return Span<T>(data(), size());
+        }
+
+    private:
+        Vector<T> _owned;
+
+        Span<T> _borrowed;
+        std::shared_ptr<const void> _owner;
+};
+
+}
+}
+
+#endif // Y_CORE_BORROWABLEVECTOR_H
@@ -0,0 +1,315 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "FrameArena.h"
+
+#include <y/utils/format.h>
+
+#include <algorithm>
+
+namespace y {
+namespace core {
+
+struct alignas(max_alignment) FrameArena::Block {
+    Block* prev = nullptr;
+    Block* next = nullptr;
+    const usize capacity;
+    std::atomic<usize> offset = 0;
+
+    Block(usize cap) : capacity(cap) {
+    }
+
+    byte* data() {
+        return reinterpret_cast<byte*>(this + 1);
+    }
+
+    bool contains(const void* ptr) {
+        const byte* p = static_cast<const byte*>(ptr);
+        return p >= data() && p <= data() + capacity;
+    }
+
+    void* try_allocate(usize size, usize alignment) {
+        const usize base = reinterpret_cast<usize>(data());
+        usize current = offset.load(std::memory_order_relaxed);
+        for(;;) {
+            const usize begin = align_up_to(base + current, alignment) - base;
+            const usize end = begin + size;
+            if(end > capacity) {
+                return nullptr;
+            }
+            if(offset.compare_exchange_weak(current, end, std::memory_order_relaxed)) {
+                return data() + begin;
+            }
+        }
+    }
+
+    void debug_fill(usize from) {
+#ifdef Y_DEBUG
+        const usize to = offset.load(std::memory_order_relaxed);
+        if(from < to) {
+            std::fill(data() + from, data() + to, byte(0xFE));
+        }
+#else
+        unused(from);
+#endif
+    }
+};
+
+
+FrameArena::FrameArena(usize block_size) : _block_size(block_size) {
+    y_debug_assert(block_size);
+}
+
+FrameArena::~FrameArena() {
+    free_blocks();
+}
+
+void* FrameArena::allocate(usize size, usize alignment) {
+    y_debug_assert(alignment && !(alignment & (alignment - 1)));
+
+    if(!size) {
+        return nullptr;
+    }
+
+    if(Block* block = _current.load(std::memory_order_acquire)) {
+        if(void* ptr = block->try_allocate(size, alignment)) {
+            return ptr;
+        }
+    }
+
+    return allocate_slow(size, alignment);
+}
+
+void* FrameArena::allocate_slow(usize size, usize alignment) {
+    const std::unique_lock lock(_lock);
+
+    Block* current = _current.load(std::memory_order_acquire);
+    if(current) {
+        // Someone might have chained a new block while we were waiting
+        if(void* ptr = current->try_allocate(size, alignment)) {
+            return ptr;
+        }
+    }
+
+    const usize required = size + alignment;
+
+    Block* block = current ? current->next : _first;
+    if(!block || block->capacity < required) {
+        const usize capacity = std::max({_block_size, required, current ? current->capacity * 2 : 0});
+        block = create_block(capacity);
+
+        if(current) {
+            block->prev = current;
+            block->next = current->next;
+            if(current->next) {
+                current->next->prev = block;
+            }
+            current->next = block;
+        } else {
+            y_debug_assert(!_first);
+            _first = block;
+        }
+    }
+
+    if(current) {
+        const usize allocated = _allocated_before.load(std::memory_order_relaxed) + current->offset.load(std::memory_order_relaxed);
+        _allocated_before.store(allocated, std::memory_order_relaxed);
+        update_high_water_mark(allocated);
+    }
+
+    block->offset.store(0, std::memory_order_relaxed);
+
+    void* ptr = block->try_allocate(size, alignment);
+    y_debug_assert(ptr);
+
+    _current.store(block, std::memory_order_release);
+
+    return ptr;
+}
+
+bool FrameArena::try_free(void* ptr, usize size) {
+    if(!ptr) {
+        return false;
+    }
+
+    Block* block = _current.load(std::memory_order_acquire);
+    if(!block || !block->contains(ptr)) {
+        return false;
+    }
+
+    const usize begin = static_cast<byte*>(ptr) - block->data();
+    usize end = begin + size;
+    if(!block->offset.compare_exchange_strong(end, begin, std::memory_order_relaxed)) {
+        return false;
+    }
+
+    update_high_water_mark(_allocated_before.load(std::memory_order_relaxed) + begin + size);
+    return true;
+}
+
+void FrameArena::pop(void* ptr, usize size) {
+    y_debug_assert(!ptr == !size);
+    if(!ptr) {
+        return;
+    }
+
+    Block* block = find_block(ptr);
+    y_debug_assert(block);
+
+    const usize begin = static_cast<byte*>(ptr) - block->data();
+
+#ifdef Y_DEBUG
+    // The allocation must be the last one: the top of the arena is either right after it,
+    // or at the aligned start of the allocation that followed it and has already been popped
+    const usize end = begin + size;
+    const usize top = block->offset.load(std::memory_order_relaxed);
+    y_debug_assert(top == end || top == align_up_to(end, max_alignment));
+    for(Block* b = _current.load(std::memory_order_relaxed); b != block; b = b->prev) {
+        y_debug_assert(b && !b->offset.load(std::memory_order_relaxed));
+    }
+#else
+    unused(size);
+#endif
+
+    rewind(Marker{block, begin});
+}
+
+FrameArena::Marker FrameArena::mark() const {
+    Block* block = _current.load(std::memory_order_acquire);
+    return Marker{block, block ? block->offset.load(std::memory_order_relaxed) : 0};
+}
+
+void FrameArena::rewind(Marker marker) {
+    Block* block = marker.block ? marker.block : _first;
+    if(!block) {
+        return;
+    }
+
+    update_high_water_mark(allocated());
+
+    Block* current = _current.load(std::memory_order_relaxed);
+    y_debug_assert(current);
+
+    // Blocks after the marker are kept around to be reused
+    for(Block* b = current; b != block; b = b->prev) {
+        y_debug_assert(b);
+        b->debug_fill(0);
+        b->offset.store(0, std::memory_order_relaxed);
+    }
+
+    y_debug_assert(marker.offset <= block->offset.load(std::memory_order_relaxed));
+    block->debug_fill(marker.offset);
+    block->offset.store(marker.offset, std::memory_order_relaxed);
+
+    usize before = 0;
+    for(Block* b = block->prev; b; b = b->prev) {
+        before += b->offset.load(std::memory_order_relaxed);
+    }
+    _allocated_before.store(before, std::memory_order_relaxed);
+
+    _current.store(block, std::memory_order_release);
+}
+
+void FrameArena::reset() {
+    if(!_first) {
+        return;
+    }
+
+    update_high_water_mark(allocated());
+
+    if(_block_count > 1) {
+        const usize capacity = _reserved;
+        free_blocks();
+        _first = create_block(capacity);
+        _current.store(_first, std::memory_order_release);
+    } else {
+        rewind(Marker{_first, 0});
+    }
+
+    _allocated_before.store(0, std::memory_order_relaxed);
+}
+
+FrameArena::Stats FrameArena::stats() const {
+    const usize used = allocated();
+    return Stats {
+        used,
+        std::max(used, _high_water_mark.load(std::memory_order_relaxed)),
+        _reserved,
+        _block_count,
+    };
+}
+
+usize FrameArena::allocated() const {
+    const Block* current = _current.load(std::memory_order_acquire);
+    return current ? _allocated_before.load(std::memory_order_relaxed) + current->offset.load(std::memory_order_relaxed) : 0;
+}
+
+void FrameArena::update_high_water_mark(usize allocated) {
+    usize hwm = _high_water_mark.load(std::memory_order_relaxed);
+    while(hwm < allocated && !_high_water_mark.compare_exchange_weak(hwm, allocated, std::memory_order_relaxed)) {
+    }
+}
+
+FrameArena::Block* FrameArena::create_block(usize capacity) {
+    void* memory = ::operator new(sizeof(Block) + capacity, std::align_val_t(alignof(Block)));
+    _reserved += capacity;
+    ++_block_count;
+    return new(memory) Block(capacity);
+}
+
+FrameArena::Block* FrameArena::find_block(const void* ptr) const {
+    for(Block* b = _current.load(std::memory_order_acquire); b; b = b->prev) {
+        if(b->contains(ptr)) {
+            return b;
+        }
+    }
+    return nullptr;
+}
+
+void FrameArena::free_blocks() {
+    for(Block* b = _first; b;) {
+        Block* next = b->next;
+        b->~Block();
+        ::operator delete(b, std::align_val_t(alignof(Block)));
+        b = next;
+    }
+
+    _first = nullptr;
+    _current.store(nullptr, std::memory_order_release);
+    _reserved = 0;
+    _block_count = 0;
+}
+
+
+
+FrameArena& frame_arena() {
+    static FrameArena arena;
+    return arena;
+}
+
+FrameArena& scratch_arena() {
+    static thread_local FrameArena arena(64 * 1024);
+    return arena;
+}
+
+}
+}
@@ -0,0 +1,161 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_CORE_FRAMEARENA_H
+#define Y_CORE_FRAMEARENA_H
+
+#include "Vector.h"
+
+#include <y/utils/memory.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace y {
+namespace core {
+
+// Linear allocator made of a chain of blocks.
+// Allocating is a single CAS on the current block and is safe from any thread.
+// When the current block is full a new one (at least twice as big) is chained after it, so the arena never runs out.
+// mark/rewind/pop/reset are not thread safe: they should only be called by the owner of the arena (ie: at the end of a frame)
+class FrameArena : NonMovable {
+    struct Block;
+
+    public:
+        static constexpr usize default_block_size = 1024 * 1024;
+
+        struct Marker {
+            Block* block = nullptr;
+            usize offset = 0;
+        };
+
+        struct Stats {
+            usize allocated = 0;
+            usize high_water_mark = 0;
+            usize reserved = 0;
+            usize block_count = 0;
+        };
+
+        FrameArena(usize block_size = default_block_size);
+        ~FrameArena();
+
+        void* allocate(usize size, usize alignment = max_alignment);
+
+        // Thread safe: gives the memory back only if ptr is the last allocation of the current block
+        bool try_free(void* ptr, usize size);
+
+        // Frees the last allocation, in LIFO order. Allocations freed this way should not use more than max_alignment.
+        void pop(void* ptr, usize size);
+
+        Marker mark() const;
+        void rewind(Marker marker);
+
+        // Frees everything. If the last frame needed more than one block, they are merged into a single one.
+        void reset();
+
+        Stats stats() const;
+
+        template<typename T>
+        inline T* allocate_typed(usize count) {
+            return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+        }
+
+    private:
+        void* allocate_slow(usize size, usize alignment);
+        Block* create_block(usize capacity);
+        Block* find_block(const void* ptr) const;
+
+        usize allocated() const;
+        void update_high_water_mark(usize allocated);
+        void free_blocks();
+
+        std::atomic<Block*> _current = nullptr;
+        Block* _first = nullptr;
+
+        std::atomic<usize> _allocated_before = 0;
+        std::atomic<usize> _high_water_mark = 0;
+        usize _reserved = 0;
+        usize _block_count = 0;
+
+        const usize _block_size;
+
+        std::mutex _lock;
+};
+
+
+// Shared arena, reset once per frame by the main loop
+FrameArena& frame_arena();
+
+// Per-thread arena used by ScratchPad and ScratchVector
+FrameArena& scratch_arena();
+
+
+template<typename T>
+class FrameAllocator {
+    public:
+        using value_type = T;
+
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::false_type;
+
+        inline FrameAllocator() : _arena(&frame_arena()) {
+        }
+
+        inline FrameAllocator(FrameArena& arena) : _arena(&arena) {
+        }
+
+        template<typename U>
+        inline FrameAllocator(const FrameAllocator<U>& other) : _arena(other.arena()) {
+        }
+
+        inline T* allocate(usize n) {
+            return _arena->allocate_typed<T>(n);
+        }
+
+        inline void deallocate(T* ptr, usize n) {
+            _arena->try_free(ptr, n * sizeof(T));
+        }
+
+        inline FrameArena* arena() const {
+            return _arena;
+        }
+
+        template<typename U>
+        inline bool operator==(const FrameAllocator<U>& other) const {
+            return _arena == other.arena();
+        }
+
+        template<typename U>
+        inline bool operator!=(const FrameAllocator<U>& other) const {
+            return _arena != other.arena();
+        }
+
+    private:
+        FrameArena* _arena = nullptr;
+};
+
+template<typename T>
+using FrameVector = Vector<T, DefaultVectorResizePolicy, FrameAllocator<T>>;
+
+}
+}
+
+#endif // Y_CORE_FRAMEARENA_H
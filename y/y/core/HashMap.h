@@ -28,18 +28,26 @@ SOFTWARE.
 
 #include <y/utils/hash.h>
 #include <y/utils/traits.h>
+#include <y/utils/memory.h>
 
 #include <functional>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define Y_HASHMAP_SSE2
+#include <emmintrin.h>
+#endif
 
-Y_TODO("Implement trick from here: https://www.youtube.com/watch?v=ncHmEUmJZf4")
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
 
 namespace y {
 namespace core {
 
-// http://research.cs.vt.edu/AVresearch/hashing/index.php
+// SwissTable: https://www.youtube.com/watch?v=ncHmEUmJZf4
+// Buckets are split in groups of 16, each bucket has a control byte that is either empty, deleted or the 7 low bits of the hash.
+// Lookups compare the control bytes of a whole group at once and only compare the keys of the buckets whose 7 bits match.
 
-Y_TODO(Maybe keep track of the first element index and start iterating from here)
 Y_TODO(We check the load factor before adding elements so we can end up slightly above after insertion)
 
 namespace detail {
@@ -64,44 +72,132 @@ inline std::pair<const K, V>& map_entry_to_value_type(std::pair<K, V>& p) {
 }
 
 inline constexpr usize ceil_next_power_of_2(usize k) {
-    return 1_uu << log2ui(k + 1);
+    usize p = 1;
+    while(p < k) {
+        p <<= 1;
+    }
+    return p;
 }
 
 
-static constexpr double default_hash_map_max_load_factor = 2.0 / 3.0;
+static constexpr double default_hash_map_max_load_factor = 7.0 / 8.0;
 
-enum class ProbingStrategy {
-    Linear,
-    Quadratic
-};
 
-static constexpr ProbingStrategy default_hash_map_probing_strategy = ProbingStrategy::Quadratic;
+namespace ctrl {
+static constexpr i8 empty = -128;   // 0b10000000
+static constexpr i8 deleted = -2;   // 0b11111110
+// Full buckets store the 7 low bits of the hash: 0b0xxxxxxx
+}
 
-// http://research.cs.vt.edu/AVresearch/hashing/quadratic.php
-template<ProbingStrategy Strategy = default_hash_map_probing_strategy>
-inline constexpr usize probing_offset(usize i) {
-    if constexpr(Strategy == ProbingStrategy::Linear) {
-        return i;
-    } else {
-        return (i * i + i) / 2;
-    }
+inline u32 first_bit_index(u32 mask) {
+    y_debug_assert(mask);
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return u32(index);
+#else
+    return u32(__builtin_ctz(mask));
+#endif
 }
+
+// One bit per bucket of a group
+class GroupMask {
+    public:
+        inline GroupMask(u32 mask) : _mask(mask) {
+        }
+
+        inline explicit operator bool() const {
+            return _mask;
+        }
+
+        inline u32 first() const {
+            return first_bit_index(_mask);
+        }
+
+        // Iterates the set bits, lowest first
+        inline bool next(u32& index) {
+            if(!_mask) {
+                return false;
+            }
+            index = first();
+            _mask &= _mask - 1;
+            return true;
+        }
+
+    private:
+        u32 _mask = 0;
+};
+
+class Group {
+    public:
+        static constexpr usize width = 16;
+
+        inline Group(const i8* ctrl) {
+#ifdef Y_HASHMAP_SSE2
+            _ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+            std::copy_n(ctrl, width, _ctrl);
+#endif
+        }
+
+        inline GroupMask match(u8 h2) const {
+#ifdef Y_HASHMAP_SSE2
+            return u32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(char(h2)), _ctrl)));
+#else
+            return match_if([=](i8 c) { return c == i8(h2); });
+#endif
+        }
+
+        inline GroupMask match_empty() const {
+#ifdef Y_HASHMAP_SSE2
+            return u32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(ctrl::empty), _ctrl)));
+#else
+            return match_if([](i8 c) { return c == ctrl::empty; });
+#endif
+        }
+
+        // Empty and deleted control bytes are the only ones with the high bit set
+        inline GroupMask match_empty_or_deleted() const {
+#ifdef Y_HASHMAP_SSE2
+            return u32(_mm_movemask_epi8(_ctrl));
+#else
+            return match_if([](i8 c) { return c < 0; });
+#endif
+        }
+
+    private:
+#ifdef Y_HASHMAP_SSE2
+        __m128i _ctrl;
+#else
+        template<typename F>
+        inline u32 match_if(F&& f) const {
+            u32 mask = 0;
+            for(usize i = 0; i != width; ++i) {
+                mask |= u32(f(_ctrl[i])) << i;
+            }
+            return mask;
+        }
+
+        i8 _ctrl[width];
+#endif
+};
 }
 
 
 namespace swiss {
-template<typename Key, typename Value, typename Hasher = Hash<Key>, typename Equal = std::equal_to<Key>, bool StoreHash = false>
-class FlatHashMap : Hasher, Equal {
+template<typename Key, typename Value, typename Hasher = Hash<Key>, typename Equal = std::equal_to<Key>, bool StoreHash = false, typename Allocator = std::allocator<u8>>
+class FlatHashMap : Hasher, Equal, Allocator {
     public:
         using key_type = remove_cvref_t<Key>;
         using mapped_type = remove_cvref_t<Value>;
         using value_type = std::pair<const key_type, mapped_type>;
 
         static constexpr double max_load_factor = detail::default_hash_map_max_load_factor;
-        static constexpr usize min_capacity = 16;
+        static constexpr usize min_capacity = detail::Group::width;
 
     private:
         using pair_type = std::pair<key_type, mapped_type>;
+        using Group = detail::Group;
 
         static constexpr usize invalid_index = usize(-1);
 
@@ -110,95 +206,46 @@ class FlatHashMap : Hasher, Equal {
             usize hash;
         };
 
-        struct StateHash {
-            static constexpr usize hash_bit = usize(1) << (8 * sizeof(usize) - 1);
-            static constexpr usize empty_states = 0;
-            static constexpr usize tombstone_states = 1;
-
-            usize bits = empty_states;
+        // With StoreHash, full hashes are kept next to the control bytes: rehashing doesn't need to hash keys again
+        // and key comparisons are skipped for buckets whose 7 bits match by accident
+        struct StoredHashes {
+            usize* hashes = nullptr;
 
-            inline void set_hash(usize hash) {
-                y_debug_assert(!is_full());
-                bits = hash | hash_bit;
+            inline StoredHashes(usize* ptr = nullptr) : hashes(ptr) {
             }
 
-            inline void make_empty() {
-                y_debug_assert(is_full());
-                bits = tombstone_states;
+            inline void set(usize index, usize h) {
+                hashes[index] = h;
             }
 
-            inline bool is_full() const {
-                return bits & hash_bit;
+            inline bool matches(usize index, usize h) const {
+                return hashes[index] == h;
             }
 
-            inline bool is_hash(usize hash) const {
-                return bits == (hash | hash_bit);
-            }
-
-            inline bool is_empty_strict() const {
-                return bits == empty_states;
-            }
-
-            inline bool is_tombstone() const {
-                return bits == tombstone_states;
-            }
-
-            inline usize hash() const {
-                y_debug_assert(is_full());
-                // we dont care about the last bit since we mask instead of %
-                return bits;
+            template<typename F>
+            inline usize get(usize index, F&&) const {
+                return hashes[index];
             }
         };
 
-        struct SimpleState {
-            enum State : u8 {
-                Empty,
-                Full,
-                Tombstone
-            } state = Empty;
-
-            inline void set_hash(usize) {
-                y_debug_assert(!is_full());
-                state = Full;
+        struct NoHashes {
+            inline NoHashes(usize* = nullptr) {
             }
 
-            inline void make_empty() {
-                y_debug_assert(is_full());
-                state = Tombstone;
+            inline void set(usize, usize) {
             }
 
-            inline bool is_full() const {
-                return state == Full;
+            inline bool matches(usize, usize) const {
+                return true;
             }
 
-            inline bool is_hash(usize) const {
-                return is_full();
-            }
-
-            inline bool is_empty_strict() const {
-                return state == Empty;
-            }
-
-            inline bool is_tombstone() const {
-                return state == Tombstone;
+            template<typename F>
+            inline usize get(usize, F&& rehash) const {
+                return rehash();
             }
         };
 
-        static_assert(sizeof(StateHash) == sizeof(usize));
-        static_assert(sizeof(SimpleState) == sizeof(u8));
-
-        template<typename K>
-        inline usize retrieve_hash(const K&, const StateHash& state) const {
-            return state.hash();
-        }
-
-        template<typename K>
-        inline usize retrieve_hash(const K& key, const SimpleState&) const {
-            return hash(key);
-        }
-
-
-        using State = std::conditional_t<StoreHash, StateHash, SimpleState>;
+        using Hashes = std::conditional_t<StoreHash, StoredHashes, NoHashes>;
 
         struct Entry : NonMovable {
             union {
@@ -353,15 +400,13 @@ class FlatHashMap : Hasher, Equal {
                 }
 
                 inline void find_next() {
-                    for(;_index < _parent->bucket_count() && !_parent->_states[_index].is_full(); ++_index) {
+                    for(;_index < _parent->bucket_count() && !is_full(_parent->_ctrl[_index]); ++_index) {
                         // nothing
                     }
                     y_debug_assert(_index <= _parent->bucket_count());
-                    y_debug_assert(at_end() || _parent->_states[_index].is_full());
+                    y_debug_assert(at_end() || is_full(_parent->_ctrl[_index]));
                 }
 
-                Y_TODO(Maybe dont store pointer to parent and use _state directly (starting from the end so we get _index -> 0))
-
                 usize _index = invalid_index;
                 parent_type* _parent = nullptr;
 
@@ -374,13 +419,37 @@ class FlatHashMap : Hasher, Equal {
                 using pointer = value_type*;
         };
 
+        static inline bool is_full(i8 ctrl) {
+            return ctrl >= 0;
+        }
+
+        // The low 7 bits go in the control bytes, the rest select the first group to probe
+        static inline i8 h2(usize hash) {
+            return i8(hash & 0x7F);
+        }
+
+        static inline usize h1(usize hash) {
+            return hash >> 7;
+        }
+
+        inline usize group_mask() const {
+            return bucket_count() / Group::width - 1;
+        }
+
+        // Groups are probed quadratically, which visits every one of them since their number is a power of 2
+        static inline usize next_group(usize group, usize probe, usize mask) {
+            return (group + probe + 1) & mask;
+        }
+
         inline bool should_expand() const {
-            return bucket_count() * max_load_factor <= _size;
+            return bucket_count() * max_load_factor <= _size + _deleted;
         }
 
+        // Control bytes use the low bits of the hash and group selection the high ones:
+        // hashes are mixed so that hashers returning pointers or integers as is still spread keys out
         template<typename K>
         inline usize hash(const K& key) const {
-            return Hasher::operator()(key);
+            return hash_u64(u64(Hasher::operator()(key)));
         }
 
         template<typename K>
@@ -390,48 +459,49 @@ class FlatHashMap : Hasher, Equal {
 
         template<typename K>
         inline Bucket find_bucket_for_insert(const K& key) {
-            const usize h = hash(key);
-            return find_bucket_for_insert(key, h);
+            return find_bucket_for_insert(key, hash(key));
         }
 
+        // Returns the bucket of the key if it is already in the map, or the first free bucket on its probe sequence
         template<typename K>
         Bucket find_bucket_for_insert(const K& key, usize h) {
-            const usize buckets = bucket_count();
-            const usize hash_mask = buckets - 1;
-            usize probes = 0;
-
-            y_debug_assert(buckets);
-            {
-                usize best_index = invalid_index;
-                for(; probes <= _max_probe_len; ++probes) {
-                    const usize index = (h + detail::probing_offset<>(probes)) & hash_mask;
-                    const State& state = _states[index];
-                    if(!state.is_full()) {
-                        if(state.is_empty_strict()) {
-                            return {index, h};
-                        }
-                        if(best_index == invalid_index) {
-                            best_index = index;
-                        }
-                    } else if(state.is_hash(h) && equal(_entries[index].key(), key)) {
+            y_debug_assert(bucket_count());
+
+            const i8 fragment = h2(h);
+            const usize mask = group_mask();
+
+            usize free_index = invalid_index;
+            usize group = h1(h) & mask;
+            for(usize probe = 0; probe <= mask; ++probe) {
+                const usize first = group * Group::width;
+                const Group ctrl(_ctrl + first);
+
+                auto matches = ctrl.match(fragment);
+                for(u32 i = 0; matches.next(i);) {
+                    const usize index = first + i;
+                    if(_hashes.matches(index, h) && equal(_entries[index].key(), key)) {
                         return {index, h};
                     }
                 }
 
-                if(best_index != invalid_index) {
-                    return {best_index, h};
+                if(free_index == invalid_index) {
+                    if(const auto free = ctrl.match_empty_or_deleted()) {
+                        free_index = first + free.first();
+                    }
                 }
-            }
 
-            for(; probes < buckets; ++probes) {
-                const usize index = (h + detail::probing_offset<>(probes)) & hash_mask;
-                if(!_states[index].is_full()) {
-                    _max_probe_len = probes;
-                    return {index, h};
+                // The key would have been put in this group if it was in the map
+                if(ctrl.match_empty()) {
+                    break;
                 }
+
+                group = next_group(group, probe, mask);
             }
 
-            y_fatal("Internal error: unable to find empty bucket");
+            if(free_index == invalid_index) {
+                y_fatal("Internal error: unable to find empty bucket");
+            }
+            return {free_index, h};
         }
 
         template<typename K>
@@ -441,60 +511,171 @@ class FlatHashMap : Hasher, Equal {
             }
 
             const usize h = hash(key);
-            const usize hash_mask = bucket_count() - 1;
-            for(usize i = 0; i <= _max_probe_len; ++i) {
-                const usize index = (h + detail::probing_offset<>(i)) & hash_mask;
-                const State& state = _states[index];
-                if(state.is_hash(h)) {
-                    if(equal(_entries[index].key(), key)) {
+            const i8 fragment = h2(h);
+            const usize mask = group_mask();
+
+            usize group = h1(h) & mask;
+            for(usize probe = 0; probe <= mask; ++probe) {
+                const usize first = group * Group::width;
+                const Group ctrl(_ctrl + first);
+
+                auto matches = ctrl.match(fragment);
+                for(u32 i = 0; matches.next(i);) {
+                    const usize index = first + i;
+                    if(_hashes.matches(index, h) && equal(_entries[index].key(), key)) {
                         return index;
                     }
-                } else if(state.is_empty_strict()) {
+                }
+
+                if(ctrl.match_empty()) {
                     return invalid_index;
                 }
+
+                group = next_group(group, probe, mask);
             }
             return invalid_index;
         }
 
-        void expand(usize new_bucket_count) {
-            const usize pow_2 = detail::ceil_next_power_of_2(new_bucket_count);
-            const usize new_size = pow_2 < min_capacity ? min_capacity : pow_2;
+        // Used when rebuilding: keys are known to be unique and there are no deleted buckets
+        usize find_empty_bucket(usize h) const {
+            const usize mask = group_mask();
+            usize group = h1(h) & mask;
+            for(usize probe = 0; probe <= mask; ++probe) {
+                const usize first = group * Group::width;
+                if(const auto empty = Group(_ctrl + first).match_empty()) {
+                    return first + empty.first();
+                }
+                group = next_group(group, probe, mask);
+            }
+            y_fatal("Internal error: unable to find empty bucket");
+        }
 
-            if(new_size <= bucket_count()) {
+        inline void set_full(usize index, usize h) {
+            y_debug_assert(!is_full(_ctrl[index]));
+            if(_ctrl[index] == detail::ctrl::deleted) {
+                --_deleted;
+            }
+            _ctrl[index] = h2(h);
+            _hashes.set(index, h);
+        }
+
+        // Probing stops at the first group with an empty bucket. If the group of the erased bucket has one,
+        // no probe ever went past it, and the bucket can be made empty again instead of leaving a tombstone.
+        inline void set_erased(usize index) {
+            y_debug_assert(is_full(_ctrl[index]));
+            const usize first = index & ~(Group::width - 1);
+            if(Group(_ctrl + first).match_empty()) {
+                _ctrl[index] = detail::ctrl::empty;
+            } else {
+                _ctrl[index] = detail::ctrl::deleted;
+                ++_deleted;
+            }
+        }
+
+        // Control bytes, stored hashes and entries share a single allocation:
+        // [ctrl: buckets bytes][hashes: buckets usizes if StoreHash][entries: buckets Entries]
+        // Bucket counts are multiples of the group width so the hashes are always aligned.
+        using storage_type = std::max_align_t;
+        using storage_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<storage_type>;
+
+        static_assert(alignof(Entry) <= alignof(storage_type));
+
+        static inline usize entries_offset(usize buckets) {
+            return align_up_to(buckets + (StoreHash ? buckets * sizeof(usize) : 0), alignof(Entry));
+        }
+
+        static inline usize storage_size(usize buckets) {
+            return (entries_offset(buckets) + buckets * sizeof(Entry) + sizeof(storage_type) - 1) / sizeof(storage_type);
+        }
+
+        inline void allocate_storage(usize buckets) {
+            storage_allocator allocator(static_cast<const Allocator&>(*this));
+            u8* storage = reinterpret_cast<u8*>(std::allocator_traits<storage_allocator>::allocate(allocator, storage_size(buckets)));
+
+            _ctrl = reinterpret_cast<i8*>(storage);
+            _hashes = Hashes(reinterpret_cast<usize*>(storage + buckets));
+            _entries = reinterpret_cast<Entry*>(storage + entries_offset(buckets));
+            _bucket_count = buckets;
+
+            std::fill_n(_ctrl, buckets, detail::ctrl::empty);
+            for(usize i = 0; i != buckets; ++i) {
+                ::new(_entries + i) Entry();
+            }
+        }
+
+        inline void free_storage(i8* ctrl, Entry* entries, usize buckets) {
+            if(!ctrl) {
                 return;
             }
 
-            auto old_states = std::exchange(_states, FixedArray<State>(new_size));
-            auto old_entries = std::exchange(_entries, std::make_unique<Entry[]>(new_size));
-            _max_probe_len = 0;
+            for(usize i = 0; i != buckets; ++i) {
+                entries[i].~Entry();
+            }
+
+            storage_allocator allocator(static_cast<const Allocator&>(*this));
+            std::allocator_traits<storage_allocator>::deallocate(allocator, reinterpret_cast<storage_type*>(ctrl), storage_size(buckets));
+        }
+
+        // Moves every element into new arrays of new_size buckets, tombstones are dropped
+        void rebuild(usize new_size) {
+            y_debug_assert(new_size >= min_capacity);
+            y_debug_assert(new_size % Group::width == 0);
+            y_debug_assert(new_size * max_load_factor > _size);
+
+            i8* old_ctrl = _ctrl;
+            Entry* old_entries = _entries;
+            const Hashes old_hashes = _hashes;
+            const usize old_bucket_count = _bucket_count;
+
+            allocate_storage(new_size);
+            _deleted = 0;
 
             if(_size) {
-                const usize old_bucket_count = old_states.size();
                 for(usize i = 0; i != old_bucket_count; ++i) {
-                    if(old_states[i].is_full()) {
-                        const usize h = retrieve_hash(old_entries[i].key(), old_states[i]);
-                        const Bucket bucket = find_bucket_for_insert(old_entries[i].key(), h);
-                        const usize new_index = bucket.index;
+                    if(is_full(old_ctrl[i])) {
+                        Entry& entry = old_entries[i];
+                        const usize h = old_hashes.get(i, [&] { return hash(entry.key()); });
+                        const usize new_index = find_empty_bucket(h);
 
-                        y_debug_assert(!_states[new_index].is_full());
+                        _ctrl[new_index] = h2(h);
+                        _hashes.set(new_index, h);
+                        _entries[new_index].set(std::move(entry.key_value));
 
-                        _states[new_index].set_hash(bucket.hash);
-                        _entries[new_index].set(std::move(old_entries[i].key_value));
-
-                        old_entries[i].clear();
+                        entry.clear();
                     }
                 }
             }
+
+            free_storage(old_ctrl, old_entries, old_bucket_count);
+        }
+
+        void expand(usize new_bucket_count) {
+            const usize pow_2 = detail::ceil_next_power_of_2(new_bucket_count);
+            const usize new_size = pow_2 < min_capacity ? min_capacity : pow_2;
+
+            if(new_size <= bucket_count()) {
+                return;
+            }
+
+            rebuild(new_size);
         }
 
+        // Called when the map is full of elements and tombstones: if tombstones take most of the space they are cleaned up in place instead of growing
         inline void expand() {
-            expand(bucket_count() == 0 ? min_capacity : 2 * bucket_count());
+            const usize buckets = bucket_count();
+            if(buckets && _size * 2 < buckets * max_load_factor) {
+                rebuild(buckets);
+            } else {
+                expand(buckets == 0 ? min_capacity : 2 * buckets);
+            }
         }
 
-        FixedArray<State> _states;
-        std::unique_ptr<Entry[]> _entries;
+        i8* _ctrl = nullptr;
+        Entry* _entries = nullptr;
+        Hashes _hashes;
+        usize _bucket_count = 0;
         usize _size = 0;
-        usize _max_probe_len = 0;
+        usize _deleted = 0;
 
     public:
         using iterator          = IteratorBase<false, KeyValueIt>;
@@ -508,6 +689,9 @@ class FlatHashMap : Hasher, Equal {
         inline FlatHashMap() {
         }
 
+        inline explicit FlatHashMap(const Allocator& allocator) : Allocator(allocator) {
+        }
+
         inline FlatHashMap(FlatHashMap&& other) {
             swap(other);
         }
@@ -517,37 +701,48 @@ class FlatHashMap : Hasher, Equal {
             return *this;
         }
 
+        inline const Allocator& get_allocator() const {
+            return *this;
+        }
+
         inline void swap(FlatHashMap& other) {
             if(&other != this) {
-                std::swap(_states, other._states);
+                // Storage is always freed by the allocator that allocated it
+                std::swap(static_cast<Allocator&>(*this), static_cast<Allocator&>(other));
+                std::swap(_ctrl, other._ctrl);
                 std::swap(_entries, other._entries);
+                std::swap(_hashes, other._hashes);
+                std::swap(_bucket_count, other._bucket_count);
                 std::swap(_size, other._size);
-                std::swap(_max_probe_len, other._max_probe_len);
+                std::swap(_deleted, other._deleted);
             }
         }
 
         inline ~FlatHashMap() {
-            make_empty();
+            clear();
         }
 
         inline void make_empty() {
             const usize len = bucket_count();
             for(usize i = 0; i != len && _size; ++i) {
-                if(_states[i].is_full()) {
-                    _states[i] = State();
+                if(is_full(_ctrl[i])) {
                     _entries[i].clear();
                     --_size;
                 }
             }
-            _max_probe_len = 0;
+            std::fill_n(_ctrl, len, detail::ctrl::empty);
+            _deleted = 0;
 
             y_debug_assert(_size == 0);
         }
 
         inline void clear() {
             make_empty();
-            _states.clear();
+            free_storage(_ctrl, _entries, _bucket_count);
+            _ctrl = nullptr;
             _entries = nullptr;
+            _hashes = Hashes();
+            _bucket_count = 0;
         }
 
         inline iterator begin() {
@@ -601,15 +796,20 @@ class FlatHashMap : Hasher, Equal {
         }
 
         inline usize bucket_count() const {
-            return _states.size();
+            return _bucket_count;
         }
 
         inline usize size() const {
             return _size;
         }
 
+        // Erased buckets that still take space until the next rebuild
+        inline usize tombstone_count() const {
+            return _deleted;
+        }
+
         static inline constexpr usize max_size() {
-            return decltype(_states)::max_size();
+            return usize(-1);
         }
 
         inline double load_factor() const {
@@ -641,7 +841,9 @@ class FlatHashMap : Hasher, Equal {
         }
 
         inline void rehash() {
-            expand(bucket_count());
+            if(bucket_count()) {
+                rebuild(bucket_count());
+            }
         }
 
         inline void set_min_capacity(usize cap) {
@@ -668,10 +870,10 @@ class FlatHashMap : Hasher, Equal {
 
             y_debug_assert(index < bucket_count());
             y_debug_assert(it._parent == this);
-            y_debug_assert(_states[index].is_full());
+            y_debug_assert(is_full(_ctrl[index]));
 
             _entries[index].clear();
-            _states[index].make_empty();
+            set_erased(index);
 
             --_size;
         }
@@ -690,12 +892,12 @@ class FlatHashMap : Hasher, Equal {
 
             const Bucket bucket = find_bucket_for_insert(p.first);
             const usize index = bucket.index;
-            const bool exists = _states[index].is_full();
+            const bool exists = is_full(_ctrl[index]);
 
             y_debug_assert(!exists || _size > 0);
             if(!exists) {
                 _entries[index].set(std::move(p));
-                _states[index].set_hash(bucket.hash);
+                set_full(index, bucket.hash);
                 ++_size;
             }
 
@@ -718,11 +920,11 @@ class FlatHashMap : Hasher, Equal {
 
             const Bucket bucket = find_bucket_for_insert(key);
             const usize index = bucket.index;
-            const bool exists = _states[index].is_full();
+            const bool exists = is_full(_ctrl[index]);
 
             if(!exists) {
                 _entries[index].set_empty(key);
-                _states[index].set_hash(bucket.hash);
+                set_full(index, bucket.hash);
                 ++_size;
             }
 
@@ -737,4 +939,3 @@ using namespace swiss;
 }
 
 #endif // Y_CORE_HASHMAP_H
-
@@ -21,68 +21,20 @@ SOFTWARE.
 **********************************/
 
 #include "ScratchPad.h"
-#include "FixedArray.h"
-
-#include <y/utils/memory.h>
-#include <y/utils/format.h>
+#include "FrameArena.h"
 
 namespace y {
 namespace core {
 namespace detail {
 
-static constexpr usize scratch_buffer_size = 64 * 1024;
-
-static thread_local FixedArray<byte> scratch_buffer;
-static thread_local byte* scratch_begin = nullptr;
-
 void* alloc_scratchpad(usize size) {
-    if(!size) {
-        return nullptr;
-    }
-
-    auto& scratch = scratch_buffer;
-    auto& begin = scratch_begin;
-
-    y_debug_assert(begin >= scratch.begin());
-    y_debug_assert(begin <= scratch.end());
-
-    if(!begin) {
-        scratch = FixedArray<byte>(scratch_buffer_size);
-        begin = scratch.data();
-    }
-
-    const usize aligned_size = align_up_to_max(size);
-    byte* data = begin;
-    begin += aligned_size;
-
-    y_always_assert(begin <= scratch.end(), "Scratch pad full: trying to allocate % bytes (free space = %)", size, data - scratch.end());
-
-    return data;
+    return scratch_arena().allocate(size);
 }
 
-
 void free_scratchpad(void* ptr, usize size) {
-    y_debug_assert(!ptr == !size);
-    if(!ptr) {
-        return;
-    }
-
-    auto& begin = scratch_begin;
-    y_debug_assert(begin);
-
-    const usize aligned_size = align_up_to_max(size);
-
-    byte* alloc_end = static_cast<byte*>(ptr) + aligned_size;
-    y_debug_assert(alloc_end == begin);
-
-    begin = static_cast<byte*>(ptr);
-
-#ifdef Y_DEBUG
-    std::fill(begin, alloc_end, byte(0xFE));
-#endif
+    scratch_arena().pop(ptr, size);
 }
 
 }
 }
 }
-
@@ -21,6 +21,8 @@ SOFTWARE.
 **********************************/
 #include "String.h"
 #include "Vector.h"
+
+#include <y/memory/PolymorphicAllocator.h>
 #include <y/test/test.h>
 #include <memory>
 #include <cstring>
@@ -36,10 +38,10 @@ String::LongData::LongData(LongData&& other) : LongData() {
     swap(other);
 }
 
-String::LongData::LongData(const char* str, usize len) : LongData(str, compute_capacity(len), len) {
+String::LongData::LongData(const char* str, usize len, memory::PolymorphicAllocatorBase* allocator) : LongData(str, compute_capacity(len), len, allocator) {
 }
 
-String::LongData::LongData(const char* str, usize cap, usize len) : data(alloc_long(cap)), capacity(cap), length(len) {
+String::LongData::LongData(const char* str, usize cap, usize len, memory::PolymorphicAllocatorBase* allocator) : data(alloc_long(cap, allocator)), capacity(cap), length(len, allocator != nullptr) {
     if(str) {
         std::memcpy(data, str, len);
     }
@@ -71,8 +73,27 @@ String::ShortData::ShortData(const char* str, usize len) : length(len) {
 
 // --------------------------------------------------- ALLOC ---------------------------------------------------
 
-char* String::alloc_long(usize capacity) {
-    return new char[capacity + 1];
+// Strings using a custom allocator store a pointer to it right before their data
+static constexpr usize allocator_header_size = sizeof(memory::PolymorphicAllocatorBase*);
+
+char* String::alloc_long(usize capacity, memory::PolymorphicAllocatorBase* allocator) {
+    if(!allocator) {
+        return new char[capacity + 1];
+    }
+
+    char* block = static_cast<char*>(allocator->allocate(allocator_header_size + capacity + 1, alignof(memory::PolymorphicAllocatorBase*)));
+    std::memcpy(block, &allocator, allocator_header_size);
+    return block + allocator_header_size;
+}
+
+memory::PolymorphicAllocatorBase* String::long_allocator(const LongData& d) {
+    if(!d.length._has_allocator) {
+        return nullptr;
+    }
+
+    memory::PolymorphicAllocatorBase* allocator = nullptr;
+    std::memcpy(&allocator, d.data - allocator_header_size, allocator_header_size);
+    return allocator;
 }
 
 usize String::compute_capacity(usize len) {
@@ -87,7 +108,11 @@ void String::free_long(LongData& d) {
         std::memset(d.data, 0xFE, d.length + 1);
     }
 #endif
-    delete[] d.data;
+    if(memory::PolymorphicAllocatorBase* allocator = long_allocator(d)) {
+        allocator->deallocate(d.data - allocator_header_size, allocator_header_size + d.capacity + 1, alignof(memory::PolymorphicAllocatorBase*));
+    } else {
+        delete[] d.data;
+    }
 }
 
 void String::free_short(ShortData& d) {
@@ -149,6 +174,14 @@ String::String(const char* str, usize len) {
 String::String(const char* beg, const char* end) : String(beg, usize(end - beg)) {
 }
 
+String::String(std::string_view str, memory::PolymorphicAllocatorBase& allocator) {
+    if(str.size() > max_short_size) {
+        ::new(&_l) LongData(str.data(), str.size(), &allocator);
+    } else {
+        ::new(&_s) ShortData(str.data(), str.size());
+    }
+}
+
 String::~String() {
     free_data();
 }
@@ -157,12 +190,21 @@ void String::set_min_capacity(usize cap) {
     if(cap > capacity() && cap > max_short_size) {
         usize self_size = size();
 
-        LongData new_dat(data(), compute_capacity(cap), self_size);
+        LongData new_dat(data(), compute_capacity(cap), self_size, is_long() ? long_allocator(_l) : nullptr);
         free_data();
         new(&_l) LongData(std::move(new_dat));
     }
 }
 
+memory::PolymorphicAllocatorBase& String::allocator() const {
+    if(is_long()) {
+        if(memory::PolymorphicAllocatorBase* allocator = long_allocator(_l)) {
+            return *allocator;
+        }
+    }
+    return memory::default_allocator();
+}
+
 usize String::size() const {
     return is_long() ? usize(_l.length) : usize(_s.length);
 }
@@ -308,9 +350,10 @@ String& String::operator=(const String& str) {
                 _s.length = str.size();
             }
         } else {
+            memory::PolymorphicAllocatorBase* allocator = is_long() ? long_allocator(_l) : nullptr;
             free_data();
             if(str.is_long()) {
-                ::new(&_l) LongData(str._l.data, str._l.length);
+                ::new(&_l) LongData(str._l.data, str._l.length, allocator);
             } else {
                 ::new(&_s) ShortData(str._s);
             }
@@ -30,6 +30,10 @@ SOFTWARE.
 #include <string_view>
 
 namespace y {
+namespace memory {
+class PolymorphicAllocatorBase;
+}
+
 namespace core {
 
 // see: https://www.youtube.com/watch?v=kPR8h4-qZdk
@@ -37,10 +41,17 @@ class String {
 
     struct LongLenType
     {
-        usize _len : 8 * sizeof(usize) - 1;
+        usize _len : 8 * sizeof(usize) - 2;
+        usize _has_allocator : 1;
         usize _is_long : 1;
 
-        LongLenType(usize l = 0) : _len(l), _is_long(1) {
+        LongLenType(usize l = 0, bool has_allocator = false) : _len(l), _has_allocator(has_allocator), _is_long(1) {
+        }
+
+        // Keeps the allocator bit
+        LongLenType& operator=(usize l) {
+            _len = l;
+            return *this;
         }
 
         operator usize() const {
@@ -48,7 +59,7 @@ class String {
         }
 
         static constexpr usize max_length() {
-            return (1_uu << (8 * sizeof(usize) - 1)) - 2;
+            return (1_uu << (8 * sizeof(usize) - 2)) - 2;
         }
     };
 
@@ -74,8 +85,8 @@ class String {
 
         LongData();
         LongData(LongData&& other);
-        LongData(const char* str, usize cap, usize len);
-        LongData(const char* str, usize len);
+        LongData(const char* str, usize cap, usize len, memory::PolymorphicAllocatorBase* allocator = nullptr);
+        LongData(const char* str, usize len, memory::PolymorphicAllocatorBase* allocator = nullptr);
 
         ~LongData() = default;
 
@@ -121,6 +132,9 @@ class String {
         String(const char* str, usize len);
         String(const char* beg, const char* end);
 
+        // Only long strings use the allocator: short strings that grow later will use the default one.
+        String(std::string_view str, memory::PolymorphicAllocatorBase& allocator);
+
 
         template<typename It>
         String(It beg_it, It end_it) : String(nullptr, std::distance(beg_it, end_it)) {
@@ -135,6 +149,8 @@ class String {
 
         void set_min_capacity(usize cap);
 
+        memory::PolymorphicAllocatorBase& allocator() const;
+
         usize size() const;
         usize capacity() const;
         bool is_empty() const;
@@ -245,8 +261,9 @@ class String {
 
         String& append(const char* other_data, usize other_size);
 
-        static char* alloc_long(usize capacity);
+        static char* alloc_long(usize capacity, memory::PolymorphicAllocatorBase* allocator);
         static usize compute_capacity(usize len);
+        static memory::PolymorphicAllocatorBase* long_allocator(const LongData& d);
         static void free_long(LongData& d);
         static void free_short(ShortData& d);
 
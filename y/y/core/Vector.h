@@ -83,6 +83,9 @@ class Vector : ResizePolicy, Allocator {
 
         inline Vector() = default;
 
+        inline explicit Vector(const Allocator& allocator) : Allocator(allocator) {
+        }
+
         inline explicit Vector(const Vector& other) : Vector(other.begin(), other.end()) {
         }
 
@@ -177,6 +180,10 @@ class Vector : ResizePolicy, Allocator {
             push_back(beg_it, end_it);
         }
 
+        inline const Allocator& get_allocator() const {
+            return *this;
+        }
+
         inline void swap(Vector& v) {
             if(&v != this) {
                 if constexpr(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
@@ -225,8 +232,16 @@ class Vector : ResizePolicy, Allocator {
 
         template<typename It>
         inline void push_back(It beg_it, It end_it) {
-            set_min_capacity(size() + std::distance(beg_it, end_it));
-            std::copy(beg_it, end_it, std::back_inserter(*this));
+            const usize count = std::distance(beg_it, end_it);
+            set_min_capacity(size() + count);
+            if constexpr(std::is_pointer_v<It> && std::is_trivially_copyable_v<data_type> && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<It>>, data_type>) {
+                // Contiguous range of trivially copyable elements: copied as a single block
+                Y_CHECK_ELECTRIC(_data_end, count);
+                std::copy_n(beg_it, count, _data_end);
+                _data_end += count;
+            } else {
+                std::copy(beg_it, end_it, std::back_inserter(*this));
+            }
         }
 
         template<typename... Args>
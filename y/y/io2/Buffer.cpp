@@ -77,7 +77,7 @@ ReadResult Buffer::read(void* data, usize bytes) {
 ReadUpToResult Buffer::read_up_to(void* data, usize max_bytes) {
     const usize max = std::min(max_bytes, remaining());
     y_debug_assert(_cursor < _buffer.size() || !max);
-    std::memcpy(data, &_buffer[_cursor], max);
+    std::memcpy(data, _buffer.data() + _cursor, max);
     _cursor += max;
     y_debug_assert(_cursor <= _buffer.size());
     return core::Ok(max);
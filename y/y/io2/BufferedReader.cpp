@@ -0,0 +1,138 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "BufferedReader.h"
+
+namespace y {
+namespace io2 {
+
+BufferedReader::BufferedReader(ReaderPtr inner, usize buffer_size) :
+        _inner(std::move(inner)),
+        _buffer(std::make_unique<byte[]>(buffer_size)),
+        _buffer_size(buffer_size) {
+
+    y_debug_assert(_inner);
+    y_debug_assert(_buffer_size);
+}
+
+BufferedReader::~BufferedReader() {
+}
+
+usize BufferedReader::buffered() const {
+    y_debug_assert(_begin <= _end);
+    return _end - _begin;
+}
+
+usize BufferedReader::consume(void* data, usize bytes) {
+    const usize size = std::min(bytes, buffered());
+    std::memcpy(data, _buffer.get() + _begin, size);
+    _begin += size;
+    return size;
+}
+
+void BufferedReader::refill() {
+    y_debug_assert(!buffered());
+    const auto r = _inner->read_up_to(_buffer.get(), _buffer_size);
+    _begin = 0;
+    _end = r ? r.unwrap() : 0;
+}
+
+bool BufferedReader::at_end() const {
+    return !buffered() && _inner->at_end();
+}
+
+usize BufferedReader::remaining() const {
+    return buffered() + _inner->remaining();
+}
+
+// Seeking inside the buffered window keeps the buffer
+void BufferedReader::seek(usize byte) {
+    const usize inner_pos = _inner->tell();
+    if(byte <= inner_pos && byte >= inner_pos - _end) {
+        _begin = byte - (inner_pos - _end);
+    } else {
+        _inner->seek(byte);
+        _begin = _end = 0;
+    }
+}
+
+usize BufferedReader::tell() const {
+    return _inner->tell() - buffered();
+}
+
+ReadResult BufferedReader::read(void* data, usize bytes) {
+    byte* dst = static_cast<byte*>(data);
+    usize read_bytes = consume(dst, bytes);
+    if(read_bytes == bytes) {
+        return core::Ok();
+    }
+
+    // Large reads skip the buffer
+    if(bytes - read_bytes >= _buffer_size) {
+        if(auto r = _inner->read(dst + read_bytes, bytes - read_bytes); !r) {
+            return core::Err(read_bytes + r.error());
+        }
+        return core::Ok();
+    }
+
+    refill();
+    read_bytes += consume(dst + read_bytes, bytes - read_bytes);
+    if(read_bytes != bytes) {
+        return core::Err(read_bytes);
+    }
+    return core::Ok();
+}
+
+ReadUpToResult BufferedReader::read_up_to(void* data, usize max_bytes) {
+    byte* dst = static_cast<byte*>(data);
+    usize read_bytes = consume(dst, max_bytes);
+    if(read_bytes == max_bytes) {
+        return core::Ok(read_bytes);
+    }
+
+    if(max_bytes - read_bytes >= _buffer_size) {
+        auto r = _inner->read_up_to(dst + read_bytes, max_bytes - read_bytes);
+        if(!r) {
+            return core::Err(read_bytes + r.error());
+        }
+        return core::Ok(read_bytes + r.unwrap());
+    }
+
+    refill();
+    read_bytes += consume(dst + read_bytes, max_bytes - read_bytes);
+    return core::Ok(read_bytes);
+}
+
+ReadUpToResult BufferedReader::read_all(core::Vector<byte>& data) {
+    const usize read_bytes = buffered();
+    data.push_back(_buffer.get() + _begin, _buffer.get() + _end);
+    _begin = _end = 0;
+
+    auto r = _inner->read_all(data);
+    if(!r) {
+        return core::Err(read_bytes + r.error());
+    }
+    return core::Ok(read_bytes + r.unwrap());
+}
+
+}
+}
@@ -0,0 +1,66 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_IO2_BUFFEREDREADER_H
+#define Y_IO2_BUFFEREDREADER_H
+
+#include "io.h"
+
+namespace y {
+namespace io2 {
+
+// Serves small reads from a large buffer so that only every buffer_size bytes reach the underlying reader
+class BufferedReader final : public Reader {
+
+    public:
+        static constexpr usize default_buffer_size = 64 * 1024;
+
+        BufferedReader(ReaderPtr inner, usize buffer_size = default_buffer_size);
+        ~BufferedReader() override;
+
+        bool at_end() const override;
+        usize remaining() const override;
+
+        void seek(usize byte) override;
+        usize tell() const override;
+
+        ReadResult read(void* data, usize bytes) override;
+        ReadUpToResult read_up_to(void* data, usize max_bytes) override;
+        ReadUpToResult read_all(core::Vector<byte>& data) override;
+
+    private:
+        usize buffered() const;
+        usize consume(void* data, usize bytes);
+        void refill();
+
+        ReaderPtr _inner;
+
+        std::unique_ptr<byte[]> _buffer;
+        usize _buffer_size = 0;
+
+        usize _begin = 0;
+        usize _end = 0;
+};
+
+}
+}
+
+#endif // Y_IO2_BUFFEREDREADER_H
@@ -0,0 +1,86 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "BufferedWriter.h"
+
+namespace y {
+namespace io2 {
+
+BufferedWriter::BufferedWriter(WriterPtr inner, usize buffer_size) :
+        _inner(std::move(inner)),
+        _buffer(std::make_unique<byte[]>(buffer_size)),
+        _buffer_size(buffer_size) {
+
+    y_debug_assert(_inner);
+    y_debug_assert(_buffer_size);
+}
+
+// Errors can not be reported from here, call flush() first to check them
+BufferedWriter::~BufferedWriter() {
+    write_buffer().ignore();
+}
+
+WriteResult BufferedWriter::write_buffer() {
+    if(!_size) {
+        return core::Ok();
+    }
+
+    const usize size = _size;
+    _size = 0;
+    return _inner->write(_buffer.get(), size);
+}
+
+void BufferedWriter::seek(usize byte) {
+    write_buffer().ignore();
+    _inner->seek(byte);
+}
+
+usize BufferedWriter::tell() const {
+    return _inner->tell() + _size;
+}
+
+FlushResult BufferedWriter::flush() {
+    if(!write_buffer()) {
+        return core::Err();
+    }
+    return _inner->flush();
+}
+
+WriteResult BufferedWriter::write(const void* data, usize bytes) {
+    if(_size + bytes > _buffer_size) {
+        if(!write_buffer()) {
+            return core::Err<usize>(0);
+        }
+    }
+
+    // Large writes skip the buffer
+    if(bytes >= _buffer_size) {
+        return _inner->write(data, bytes);
+    }
+
+    std::memcpy(_buffer.get() + _size, data, bytes);
+    _size += bytes;
+    return core::Ok();
+}
+
+}
+}
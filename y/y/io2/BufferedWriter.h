@@ -0,0 +1,59 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_IO2_BUFFEREDWRITER_H
+#define Y_IO2_BUFFEREDWRITER_H
+
+#include "io.h"
+
+namespace y {
+namespace io2 {
+
+// Accumulates small writes and forwards them to the underlying writer in buffer_size chunks.
+// Pending data is written on flush, seek and destruction.
+class BufferedWriter final : public Writer {
+
+    public:
+        static constexpr usize default_buffer_size = 64 * 1024;
+
+        BufferedWriter(WriterPtr inner, usize buffer_size = default_buffer_size);
+        ~BufferedWriter() override;
+
+        void seek(usize byte) override;
+        usize tell() const override;
+
+        FlushResult flush() override;
+        WriteResult write(const void* data, usize bytes) override;
+
+    private:
+        WriteResult write_buffer();
+
+        WriterPtr _inner;
+
+        std::unique_ptr<byte[]> _buffer;
+        usize _buffer_size = 0;
+        usize _size = 0;
+};
+
+}
+}
+
+#endif // Y_IO2_BUFFEREDWRITER_H
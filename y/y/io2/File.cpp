@@ -21,6 +21,8 @@ SOFTWARE.
 **********************************/
 #include "File.h"
 
+#include <y/utils/xxh64.h>
+
 namespace y {
 namespace io2 {
 
@@ -86,6 +88,15 @@ core::Result<File> File::open(const core::String& name) {
     return core::Err();
 }
 
+// Every write goes to the end of the file, whatever the current position
+core::Result<File> File::open_append(const core::String& name) {
+    std::FILE* file = std::fopen(name.begin(), "ab");
+    if(file) {
+        return core::Ok<File>(file);
+    }
+    return core::Err();
+}
+
 
 core::Result<core::String> File::read_text_file(const core::String& name) {
     auto r = File::open(name);
@@ -97,23 +108,25 @@ core::Result<core::String> File::read_text_file(const core::String& name) {
     return core::Ok(std::move(buffer));
 }
 
-core::Result<void> File::copy(Reader& src, const core::String& dst) {
+core::Result<u64> File::copy(Reader& src, const core::String& dst) {
     auto f = create(dst);
     if(!f) {
         return core::Err();
     }
 
     File dst_file = std::move(f.unwrap());
-    u8 buffer[1024];
+    Xxh64 hasher;
+    u8 buffer[16 * 1024];
     while(!src.at_end()) {
         if(const auto r = src.read_up_to(buffer, sizeof(buffer))) {
             if(dst_file.write(buffer, r.unwrap())) {
+                hasher.update(buffer, r.unwrap());
                 continue;
             }
         }
         return core::Err();
     }
-    return core::Ok();
+    return core::Ok(hasher.digest());
 }
 
 usize File::size() const {
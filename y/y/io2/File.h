@@ -42,9 +42,11 @@ class File final : public Reader, public Writer {
 
         static core::Result<File> create(const core::String& name);
         static core::Result<File> open(const core::String& name);
+        static core::Result<File> open_append(const core::String& name);
         static core::Result<core::String> read_text_file(const core::String& name);
 
-        static  core::Result<void> copy(Reader& src, const core::String& dst);
+        // Returns the xxh64 of the copied data, computed while streaming
+        static core::Result<u64> copy(Reader& src, const core::String& dst);
 
         usize size() const;
         usize remaining() const override;
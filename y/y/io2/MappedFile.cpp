@@ -0,0 +1,217 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "MappedFile.h"
+
+#ifdef Y_OS_WIN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace y {
+namespace io2 {
+
+// Empty files can't be mapped: they are opened with a null view
+static core::Result<std::pair<const byte*, usize>> map_file(const core::String& name) {
+#ifdef Y_OS_WIN
+    // The view keeps the file locked: it can't be deleted or renamed over until unmapped
+    const HANDLE file = CreateFileA(name.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(file == INVALID_HANDLE_VALUE) {
+        return core::Err();
+    }
+    y_defer(CloseHandle(file));
+
+    LARGE_INTEGER size = {};
+    if(!GetFileSizeEx(file, &size)) {
+        return core::Err();
+    }
+    if(!size.QuadPart) {
+        return core::Ok(std::pair<const byte*, usize>(nullptr, 0));
+    }
+
+    const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!mapping) {
+        return core::Err();
+    }
+    y_defer(CloseHandle(mapping));
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!view) {
+        return core::Err();
+    }
+    return core::Ok(std::pair(static_cast<const byte*>(view), usize(size.QuadPart)));
+#else
+    const int fd = ::open(name.data(), O_RDONLY);
+    if(fd < 0) {
+        return core::Err();
+    }
+    y_defer(::close(fd));
+
+    struct stat st = {};
+    if(::fstat(fd, &st) || !S_ISREG(st.st_mode)) {
+        return core::Err();
+    }
+    if(!st.st_size) {
+        return core::Ok(std::pair<const byte*, usize>(nullptr, 0));
+    }
+
+    void* view = ::mmap(nullptr, usize(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if(view == MAP_FAILED) {
+        return core::Err();
+    }
+    ::madvise(view, usize(st.st_size), MADV_SEQUENTIAL);
+    return core::Ok(std::pair(static_cast<const byte*>(view), usize(st.st_size)));
+#endif
+}
+
+static void unmap_file(const byte* data, usize size) {
+#ifdef Y_OS_WIN
+    unused(size);
+    UnmapViewOfFile(data);
+#else
+    ::munmap(const_cast<byte*>(data), size);
+#endif
+}
+
+
+MappedFile::~MappedFile() {
+}
+
+MappedFile::MappedFile(MappedFile&& other) {
+    swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+    swap(other);
+    return *this;
+}
+
+void MappedFile::swap(MappedFile& other) {
+    std::swap(_mapping, other._mapping);
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+    std::swap(_cursor, other._cursor);
+    std::swap(_is_open, other._is_open);
+}
+
+core::Result<MappedFile> MappedFile::open(const core::String& name) {
+    auto r = map_file(name);
+    if(!r) {
+        return core::Err();
+    }
+
+    const auto [data, size] = r.unwrap();
+
+    MappedFile file;
+    if(data) {
+        file._mapping = std::shared_ptr<const void>(data, [size = size](const void* ptr) { unmap_file(static_cast<const byte*>(ptr), size); });
+    }
+    file._data = data;
+    file._size = size;
+    file._is_open = true;
+    return core::Ok(std::move(file));
+}
+
+MappedFile MappedFile::slice(usize offset, usize size) const {
+    y_debug_assert(offset + size <= _size);
+
+    MappedFile file;
+    file._mapping = _mapping;
+    file._data = _data + offset;
+    file._size = size;
+    file._is_open = _is_open;
+    return file;
+}
+
+usize MappedFile::size() const {
+    return _size;
+}
+
+usize MappedFile::remaining() const {
+    y_debug_assert(_cursor <= _size);
+    return _size - _cursor;
+}
+
+bool MappedFile::is_open() const {
+    return _is_open;
+}
+
+bool MappedFile::at_end() const {
+    return _cursor == _size;
+}
+
+void MappedFile::seek(usize byte) {
+    _cursor = std::min(_size, byte);
+}
+
+usize MappedFile::tell() const {
+    return _cursor;
+}
+
+void MappedFile::reset() {
+    _cursor = 0;
+}
+
+ReadResult MappedFile::read(void* data, usize bytes) {
+    if(remaining() < bytes) {
+        return core::Err<usize>(0);
+    }
+    std::memcpy(data, _data + _cursor, bytes);
+    _cursor += bytes;
+    return core::Ok();
+}
+
+ReadUpToResult MappedFile::read_up_to(void* data, usize max_bytes) {
+    const usize max = std::min(max_bytes, remaining());
+    if(max) {
+        std::memcpy(data, _data + _cursor, max);
+        _cursor += max;
+    }
+    return core::Ok(max);
+}
+
+ReadUpToResult MappedFile::read_all(core::Vector<byte>& data) {
+    const usize r = remaining();
+    data.push_back(_data + _cursor, _data + _size);
+    _cursor = _size;
+    return core::Ok(r);
+}
+
+core::Result<BorrowedBytes> MappedFile::borrow(usize bytes) {
+    if(remaining() < bytes) {
+        return core::Err();
+    }
+    BorrowedBytes borrowed{_data + _cursor, _mapping};
+    _cursor += bytes;
+    return core::Ok(std::move(borrowed));
+}
+
+const byte* MappedFile::data() const {
+    return _data;
+}
+
+}
+}
@@ -38,6 +38,11 @@ using ReadResult = core::Result<void, usize>;
 using WriteResult = core::Result<void, usize>;
 using FlushResult = core::Result<void>;
 
+struct BorrowedBytes {
+    const byte* data = nullptr;
+    std::shared_ptr<const void> owner;
+};
+
 class Reader : NonCopyable {
     public:
         Reader() = default;
@@ -53,6 +58,13 @@ class Reader : NonCopyable {
         virtual void seek(usize byte) = 0;
         virtual usize tell() const = 0;
 
+        // Readers backed by memory that can outlive them (like mapped files) can lend it instead of copying it.
+        // On success the reader moves past the bytes, which stay valid for as long as owner is alive.
+        virtual core::Result<BorrowedBytes> borrow(usize bytes) {
+            unused(bytes);
+            return core::Err();
+        }
+
         template<typename T>
         ReadResult read_one(T& t) {
             static_assert(std::is_trivially_copyable_v<T>);
@@ -43,6 +43,13 @@ namespace detail {
 
     template<typename T>
     inline constexpr T determinant(const Matrix<1, 1, T>& mat);
+
+#ifdef Y_SIMD
+    inline Matrix<4, 4, float> simd_multiply(const Matrix<4, 4, float>& a, const Matrix<4, 4, float>& b);
+    inline Vec<4, float> simd_multiply(const Matrix<4, 4, float>& m, const Vec<4, float>& v);
+    inline Matrix<4, 4, float> simd_transposed(const Matrix<4, 4, float>& m);
+    inline Matrix<4, 4, float> simd_inverse(const Matrix<4, 4, float>& m);
+#endif
 }
 
 
@@ -53,6 +60,10 @@ class Matrix {
         static constexpr usize vec_size = N;
         static constexpr usize vec_count = M;
 
+#ifdef Y_SIMD
+        static constexpr bool use_simd = N == 4 && M == 4 && std::is_same_v<T, float>;
+#endif
+
         using Column = Vec<N, T>;
         using Row = Vec<M, T>;
 
@@ -142,6 +153,13 @@ class Matrix {
         }
 
         inline constexpr Matrix<M, N, T> transposed() const {
+#ifdef Y_SIMD
+            if constexpr(use_simd) {
+                if(!y_is_constant_evaluated()) {
+                    return detail::simd_transposed(*this);
+                }
+            }
+#endif
             Matrix<M, N, T> tr;
             for(usize i = 0; i != vec_count; ++i) {
                 for(usize j = 0; j != vec_size; ++j) {
@@ -196,6 +214,13 @@ class Matrix {
         }
 
         inline constexpr Matrix inverse() const {
+#ifdef Y_SIMD
+            if constexpr(use_simd) {
+                if(!y_is_constant_evaluated()) {
+                    return detail::simd_inverse(*this);
+                }
+            }
+#endif
             T d = determinant();
             if(d == 0) {
                 return Matrix();
@@ -245,6 +270,13 @@ class Matrix {
         }
 
         inline constexpr Column operator*(const Row& v) const {
+#ifdef Y_SIMD
+            if constexpr(use_simd) {
+                if(!y_is_constant_evaluated()) {
+                    return detail::simd_multiply(*this, v);
+                }
+            }
+#endif
             Column tr;
             for(usize i = 0; i != M; ++i) {
                 tr += column(i) * v[i];
@@ -254,6 +286,13 @@ class Matrix {
 
         template<typename U, usize P>
         inline constexpr auto operator*(const Matrix<M, P, U>& m) const {
+#ifdef Y_SIMD
+            if constexpr(use_simd && P == 4 && std::is_same_v<U, float>) {
+                if(!y_is_constant_evaluated()) {
+                    return detail::simd_multiply(*this, m);
+                }
+            }
+#endif
             Matrix<N, P, decltype(std::declval<T>() * std::declval<U>())> mat;
             for(usize i = 0; i != N; ++i) {
                 for(usize j = 0; j != P; ++j) {
@@ -314,6 +353,103 @@ namespace detail {
     constexpr T determinant(const Matrix<1, 1, T>& mat) {
         return mat[0][0];
     }
+
+#ifdef Y_SIMD
+    inline Matrix<4, 4, float> simd_multiply(const Matrix<4, 4, float>& a, const Matrix<4, 4, float>& b) {
+        const simd::f32x4 a0 = simd::load(a[0].data());
+        const simd::f32x4 a1 = simd::load(a[1].data());
+        const simd::f32x4 a2 = simd::load(a[2].data());
+        const simd::f32x4 a3 = simd::load(a[3].data());
+
+        Matrix<4, 4, float> mat;
+        for(usize i = 0; i != 4; ++i) {
+            const simd::f32x4 col = simd::load(b[i].data());
+            simd::f32x4 r = simd::mul(a0, simd::broadcast<0>(col));
+            r = simd::madd(a1, simd::broadcast<1>(col), r);
+            r = simd::madd(a2, simd::broadcast<2>(col), r);
+            r = simd::madd(a3, simd::broadcast<3>(col), r);
+            simd::store(mat[i].data(), r);
+        }
+        return mat;
+    }
+
+    inline Vec<4, float> simd_multiply(const Matrix<4, 4, float>& m, const Vec<4, float>& v) {
+        const simd::f32x4 vec = simd::load(v.data());
+        simd::f32x4 r = simd::mul(simd::load(m[0].data()), simd::broadcast<0>(vec));
+        r = simd::madd(simd::load(m[1].data()), simd::broadcast<1>(vec), r);
+        r = simd::madd(simd::load(m[2].data()), simd::broadcast<2>(vec), r);
+        r = simd::madd(simd::load(m[3].data()), simd::broadcast<3>(vec), r);
+
+        Vec<4, float> res;
+        simd::store(res.data(), r);
+        return res;
+    }
+
+    inline Matrix<4, 4, float> simd_transposed(const Matrix<4, 4, float>& m) {
+        simd::f32x4 c0 = simd::load(m[0].data());
+        simd::f32x4 c1 = simd::load(m[1].data());
+        simd::f32x4 c2 = simd::load(m[2].data());
+        simd::f32x4 c3 = simd::load(m[3].data());
+        simd::transpose(c0, c1, c2, c3);
+
+        Matrix<4, 4, float> tr;
+        simd::store(tr[0].data(), c0);
+        simd::store(tr[1].data(), c1);
+        simd::store(tr[2].data(), c2);
+        simd::store(tr[3].data(), c3);
+        return tr;
+    }
+
+    // Cofactors from the 2x2 sub determinants of the top (s) and bottom (c) halves
+    // https://www.geometrictools.com/Documentation/LaplaceExpansionTheorem.pdf
+    inline Matrix<4, 4, float> simd_inverse(const Matrix<4, 4, float>& m) {
+        auto a = [&](usize row, usize col) { return m[col][row]; };
+
+        const float s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+        const float s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+        const float s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+        const float s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+        const float s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+        const float s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+
+        const float c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+        const float c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+        const float c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+        const float c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+        const float c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+        const float c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+
+        const float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        if(det == 0.0f) {
+            return Matrix<4, 4, float>();
+        }
+
+        simd::f32x4 r0 = simd::load(m[0].data());
+        simd::f32x4 r1 = simd::load(m[1].data());
+        simd::f32x4 r2 = simd::load(m[2].data());
+        simd::f32x4 r3 = simd::load(m[3].data());
+        simd::transpose(r0, r1, r2, r3);
+
+        // Each column of the inverse is built from one row of m and one set of sub determinants
+        auto cofactors = [](simd::f32x4 r, float k0, float k1, float k2, float k3, float k4, float k5) {
+            const simd::f32x4 t0 = simd::mul(simd::shuffle<1, 0, 0, 0>(r), simd::set(k5, k5, k4, k3));
+            const simd::f32x4 t1 = simd::mul(simd::shuffle<2, 2, 1, 1>(r), simd::set(k4, k2, k2, k1));
+            const simd::f32x4 t2 = simd::mul(simd::shuffle<3, 3, 3, 2>(r), simd::set(k3, k1, k0, k0));
+            return simd::add(simd::sub(t0, t1), t2);
+        };
+
+        const float inv_det = 1.0f / det;
+        const simd::f32x4 pos = simd::set(inv_det, -inv_det, inv_det, -inv_det);
+        const simd::f32x4 neg = simd::set(-inv_det, inv_det, -inv_det, inv_det);
+
+        Matrix<4, 4, float> inv;
+        simd::store(inv[0].data(), simd::mul(cofactors(r1, c0, c1, c2, c3, c4, c5), pos));
+        simd::store(inv[1].data(), simd::mul(cofactors(r0, c0, c1, c2, c3, c4, c5), neg));
+        simd::store(inv[2].data(), simd::mul(cofactors(r3, s0, s1, s2, s3, s4, s5), pos));
+        simd::store(inv[3].data(), simd::mul(cofactors(r2, s0, s1, s2, s3, s4, s5), neg));
+        return inv;
+    }
+#endif
 }
 
 
@@ -23,6 +23,7 @@ SOFTWARE.
 #define Y_MATH_VEC_H
 
 #include <y/utils.h>
+#include "simd.h"
 
 #include <cmath>
 
@@ -69,6 +70,15 @@ class Vec
     static_assert(N != 0, "Invalid size for Vec");
     static_assert(std::is_arithmetic_v<T>, "Invalid type <T> for Vec");
 
+#ifdef Y_SIMD
+    static constexpr bool use_simd = N == 4 && std::is_same_v<T, float>;
+
+    template<typename F>
+    inline void apply_simd(const Vec& v, F&& op) {
+        simd::store(_vec, op(simd::load(_vec), simd::load(v._vec)));
+    }
+#endif
+
 
     public:
         using value_type = typename std::remove_const_t<T>;
@@ -117,6 +127,13 @@ class Vec
         }
 
         inline constexpr T dot(const Vec& o) const {
+#ifdef Y_SIMD
+            if constexpr(use_simd) {
+                if(!y_is_constant_evaluated()) {
+                    return simd::dot(simd::load(_vec), simd::load(o._vec));
+                }
+            }
+#endif
             T sum = 0;
             for(usize i = 0; i != N; ++i) {
                 sum += _vec[i] * o._vec[i];
@@ -162,6 +179,15 @@ class Vec
         }
 
         inline constexpr Vec max(const Vec& v) const {
+#ifdef Y_SIMD
+            if constexpr(use_simd) {
+                if(!y_is_constant_evaluated()) {
+                    Vec m = *this;
+                    m.apply_simd(v, [](auto a, auto b) { return simd::max(a, b); });
+                    return m;
+                }
+            }
+#endif
             Vec m;
             for(usize i = 0; i != N; ++i) {
                 m[i] = std::max(_vec[i], v[i]);
@@ -170,6 +196,15 @@ class Vec
         }
 
         inline constexpr Vec min(const Vec& v) const {
+#ifdef Y_SIMD
+            if constexpr(use_simd) {
+                if(!y_is_constant_evaluated()) {
+                    Vec m = *this;
+                    m.apply_simd(v, [](auto a, auto b) { return simd::min(a, b); });
+                    return m;
+                }
+            }
+#endif
             Vec m;
             for(usize i = 0; i != N; ++i) {
                 m[i] = std::min(_vec[i], v[i]);
@@ -346,6 +381,14 @@ class Vec
         }
 
         inline constexpr Vec& operator*=(const T& t) {
+#ifdef Y_SIMD
+            if constexpr(use_simd) {
+                if(!y_is_constant_evaluated()) {
+                    simd::store(_vec, simd::mul(simd::load(_vec), simd::splat(t)));
+                    return *this;
+                }
+            }
+#endif
             for(usize i = 0; i != N; ++i) {
                 _vec[i] *= t;
             }
@@ -376,6 +419,14 @@ class Vec
 
 
         inline constexpr Vec& operator*=(const Vec& v) {
+#ifdef Y_SIMD
+            if constexpr(use_simd) {
+                if(!y_is_constant_evaluated()) {
+                    apply_simd(v, [](auto a, auto b) { return simd::mul(a, b); });
+                    return *this;
+                }
+            }
+#endif
             for(usize i = 0; i != N; ++i) {
                 _vec[i] *= v[i];
             }
@@ -383,6 +434,14 @@ class Vec
         }
 
         inline constexpr Vec& operator/=(const Vec& v) {
+#ifdef Y_SIMD
+            if constexpr(use_simd) {
+                if(!y_is_constant_evaluated()) {
+                    apply_simd(v, [](auto a, auto b) { return simd::div(a, b); });
+                    return *this;
+                }
+            }
+#endif
             for(usize i = 0; i != N; ++i) {
                 _vec[i] /= v[i];
             }
@@ -390,6 +449,14 @@ class Vec
         }
 
         inline constexpr Vec& operator+=(const Vec& v) {
+#ifdef Y_SIMD
+            if constexpr(use_simd) {
+                if(!y_is_constant_evaluated()) {
+                    apply_simd(v, [](auto a, auto b) { return simd::add(a, b); });
+                    return *this;
+                }
+            }
+#endif
             for(usize i = 0; i != N; ++i) {
                 _vec[i] += v[i];
             }
@@ -397,6 +464,14 @@ class Vec
         }
 
         inline constexpr Vec& operator-=(const Vec& v) {
+#ifdef Y_SIMD
+            if constexpr(use_simd) {
+                if(!y_is_constant_evaluated()) {
+                    apply_simd(v, [](auto a, auto b) { return simd::sub(a, b); });
+                    return *this;
+                }
+            }
+#endif
             for(usize i = 0; i != N; ++i) {
                 _vec[i] -= v[i];
             }
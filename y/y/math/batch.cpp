@@ -0,0 +1,110 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "batch.h"
+
+namespace y {
+namespace math {
+
+#ifdef Y_SIMD
+static inline Vec3 to_vec3(simd::f32x4 v) {
+    float f[4];
+    simd::store(f, v);
+    return Vec3(f[0], f[1], f[2]);
+}
+
+static inline simd::f32x4 transform(const simd::f32x4 (&cols)[3], const Vec3& v, simd::f32x4 offset) {
+    simd::f32x4 r = simd::madd(cols[0], simd::splat(v.x()), offset);
+    r = simd::madd(cols[1], simd::splat(v.y()), r);
+    r = simd::madd(cols[2], simd::splat(v.z()), r);
+    return r;
+}
+#endif
+
+void transform_points(const Matrix4<float>& tr, core::Span<Vec3> points, core::MutableSpan<Vec3> out) {
+    y_debug_assert(points.size() == out.size());
+
+#ifdef Y_SIMD
+    const simd::f32x4 cols[] = {simd::load(tr[0].data()), simd::load(tr[1].data()), simd::load(tr[2].data())};
+    const simd::f32x4 pos = simd::load(tr[3].data());
+    for(usize i = 0; i != points.size(); ++i) {
+        out[i] = to_vec3(transform(cols, points[i], pos));
+    }
+#else
+    for(usize i = 0; i != points.size(); ++i) {
+        out[i] = (tr * Vec4(points[i], 1.0f)).to<3>();
+    }
+#endif
+}
+
+void transform_directions(const Matrix4<float>& tr, core::Span<Vec3> dirs, core::MutableSpan<Vec3> out) {
+    y_debug_assert(dirs.size() == out.size());
+
+#ifdef Y_SIMD
+    const simd::f32x4 cols[] = {simd::load(tr[0].data()), simd::load(tr[1].data()), simd::load(tr[2].data())};
+    const simd::f32x4 zero = simd::splat(0.0f);
+    for(usize i = 0; i != dirs.size(); ++i) {
+        out[i] = to_vec3(transform(cols, dirs[i], zero));
+    }
+#else
+    for(usize i = 0; i != dirs.size(); ++i) {
+        out[i] = (tr * Vec4(dirs[i], 0.0f)).to<3>();
+    }
+#endif
+}
+
+// Arvo: transform the center and project the half extent on the absolute value of the basis
+void transform_aabbs(const Matrix4<float>& tr, core::Span<Vec3> min, core::Span<Vec3> max, core::MutableSpan<Vec3> out_min, core::MutableSpan<Vec3> out_max) {
+    y_debug_assert(min.size() == max.size());
+    y_debug_assert(min.size() == out_min.size());
+    y_debug_assert(min.size() == out_max.size());
+
+#ifdef Y_SIMD
+    const simd::f32x4 cols[] = {simd::load(tr[0].data()), simd::load(tr[1].data()), simd::load(tr[2].data())};
+    const simd::f32x4 abs_cols[] = {simd::abs(cols[0]), simd::abs(cols[1]), simd::abs(cols[2])};
+    const simd::f32x4 pos = simd::load(tr[3].data());
+    const simd::f32x4 zero = simd::splat(0.0f);
+    for(usize i = 0; i != min.size(); ++i) {
+        const Vec3 center = (min[i] + max[i]) * 0.5f;
+        const Vec3 half_extent = (max[i] - min[i]) * 0.5f;
+        const simd::f32x4 c = transform(cols, center, pos);
+        const simd::f32x4 e = transform(abs_cols, half_extent, zero);
+        out_min[i] = to_vec3(simd::sub(c, e));
+        out_max[i] = to_vec3(simd::add(c, e));
+    }
+#else
+    for(usize i = 0; i != min.size(); ++i) {
+        const Vec3 center = (min[i] + max[i]) * 0.5f;
+        const Vec3 half_extent = (max[i] - min[i]) * 0.5f;
+        const Vec3 c = (tr * Vec4(center, 1.0f)).to<3>();
+        Vec3 e;
+        for(usize k = 0; k != 3; ++k) {
+            e += tr[k].to<3>().abs() * half_extent[k];
+        }
+        out_min[i] = c - e;
+        out_max[i] = c + e;
+    }
+#endif
+}
+
+}
+}
@@ -0,0 +1,45 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MATH_BATCH_H
+#define Y_MATH_BATCH_H
+
+#include "Matrix.h"
+
+#include <y/core/Span.h>
+
+namespace y {
+namespace math {
+
+// Batch versions of the Transform helpers, using the SIMD kernels when available.
+// Input and output may alias, but must have the same size.
+
+// Affine transform: w is assumed to be 1 and the result is not divided by w
+void transform_points(const Matrix4<float>& tr, core::Span<Vec3> points, core::MutableSpan<Vec3> out);
+void transform_directions(const Matrix4<float>& tr, core::Span<Vec3> dirs, core::MutableSpan<Vec3> out);
+
+// Transforms boxes given as min/max corners and returns the axis aligned bounds of the results
+void transform_aabbs(const Matrix4<float>& tr, core::Span<Vec3> min, core::Span<Vec3> max, core::MutableSpan<Vec3> out_min, core::MutableSpan<Vec3> out_max);
+
+}
+}
+
+#endif // Y_MATH_BATCH_H
@@ -0,0 +1,258 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MATH_SIMD_H
+#define Y_MATH_SIMD_H
+
+#include <y/utils.h>
+
+#ifndef Y_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define Y_SIMD_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define Y_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+#if defined(Y_SIMD_SSE) || defined(Y_SIMD_NEON)
+#define Y_SIMD
+#endif
+
+// constexpr math functions use the scalar code when evaluated at compile time and the SIMD kernels otherwise
+#define y_is_constant_evaluated() __builtin_is_constant_evaluated()
+
+
+#ifdef Y_SIMD
+namespace y {
+namespace math {
+namespace simd {
+
+// 4 floats, loaded from and stored to unaligned memory
+#ifdef Y_SIMD_SSE
+using f32x4 = __m128;
+
+inline f32x4 load(const float* ptr) {
+    return _mm_loadu_ps(ptr);
+}
+
+inline void store(float* ptr, f32x4 v) {
+    _mm_storeu_ps(ptr, v);
+}
+
+inline f32x4 splat(float f) {
+    return _mm_set1_ps(f);
+}
+
+inline f32x4 set(float a, float b, float c, float d) {
+    return _mm_setr_ps(a, b, c, d);
+}
+
+inline f32x4 add(f32x4 a, f32x4 b) {
+    return _mm_add_ps(a, b);
+}
+
+inline f32x4 sub(f32x4 a, f32x4 b) {
+    return _mm_sub_ps(a, b);
+}
+
+inline f32x4 mul(f32x4 a, f32x4 b) {
+    return _mm_mul_ps(a, b);
+}
+
+inline f32x4 div(f32x4 a, f32x4 b) {
+    return _mm_div_ps(a, b);
+}
+
+inline f32x4 min(f32x4 a, f32x4 b) {
+    return _mm_min_ps(a, b);
+}
+
+inline f32x4 max(f32x4 a, f32x4 b) {
+    return _mm_max_ps(a, b);
+}
+
+inline f32x4 abs(f32x4 a) {
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+}
+
+template<int I>
+inline f32x4 broadcast(f32x4 v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(I, I, I, I));
+}
+
+template<int A, int B, int C, int D>
+inline f32x4 shuffle(f32x4 v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(D, C, B, A));
+}
+
+inline float hsum(f32x4 v) {
+    const f32x4 s = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1))));
+}
+
+inline void transpose(f32x4& a, f32x4& b, f32x4& c, f32x4& d) {
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+}
+
+// Comparison results, all bits of a lane are set if true
+using m32x4 = __m128;
+
+inline m32x4 less(f32x4 a, f32x4 b) {
+    return _mm_cmplt_ps(a, b);
+}
+
+inline m32x4 greater(f32x4 a, f32x4 b) {
+    return _mm_cmpgt_ps(a, b);
+}
+
+inline m32x4 mask_or(m32x4 a, m32x4 b) {
+    return _mm_or_ps(a, b);
+}
+
+inline m32x4 mask_and(m32x4 a, m32x4 b) {
+    return _mm_and_ps(a, b);
+}
+
+inline m32x4 mask_none() {
+    return _mm_setzero_ps();
+}
+
+// One bit per lane, lane 0 is the lowest bit
+inline u32 mask_bits(m32x4 m) {
+    return u32(_mm_movemask_ps(m));
+}
+#else
+using f32x4 = float32x4_t;
+
+inline f32x4 load(const float* ptr) {
+    return vld1q_f32(ptr);
+}
+
+inline void store(float* ptr, f32x4 v) {
+    vst1q_f32(ptr, v);
+}
+
+inline f32x4 splat(float f) {
+    return vdupq_n_f32(f);
+}
+
+inline f32x4 set(float a, float b, float c, float d) {
+    const float v[] = {a, b, c, d};
+    return vld1q_f32(v);
+}
+
+inline f32x4 add(f32x4 a, f32x4 b) {
+    return vaddq_f32(a, b);
+}
+
+inline f32x4 sub(f32x4 a, f32x4 b) {
+    return vsubq_f32(a, b);
+}
+
+inline f32x4 mul(f32x4 a, f32x4 b) {
+    return vmulq_f32(a, b);
+}
+
+inline f32x4 div(f32x4 a, f32x4 b) {
+    return vdivq_f32(a, b);
+}
+
+inline f32x4 min(f32x4 a, f32x4 b) {
+    return vminq_f32(a, b);
+}
+
+inline f32x4 max(f32x4 a, f32x4 b) {
+    return vmaxq_f32(a, b);
+}
+
+inline f32x4 abs(f32x4 a) {
+    return vabsq_f32(a);
+}
+
+template<int I>
+inline f32x4 broadcast(f32x4 v) {
+    return vdupq_laneq_f32(v, I);
+}
+
+template<int A, int B, int C, int D>
+inline f32x4 shuffle(f32x4 v) {
+    return set(vgetq_lane_f32(v, A), vgetq_lane_f32(v, B), vgetq_lane_f32(v, C), vgetq_lane_f32(v, D));
+}
+
+inline float hsum(f32x4 v) {
+    return vaddvq_f32(v);
+}
+
+inline void transpose(f32x4& a, f32x4& b, f32x4& c, f32x4& d) {
+    const float32x4x2_t ab = vtrnq_f32(a, b);
+    const float32x4x2_t cd = vtrnq_f32(c, d);
+    a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+    b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+    c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+    d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+}
+
+// Comparison results, all bits of a lane are set if true
+using m32x4 = uint32x4_t;
+
+inline m32x4 less(f32x4 a, f32x4 b) {
+    return vcltq_f32(a, b);
+}
+
+inline m32x4 greater(f32x4 a, f32x4 b) {
+    return vcgtq_f32(a, b);
+}
+
+inline m32x4 mask_or(m32x4 a, m32x4 b) {
+    return vorrq_u32(a, b);
+}
+
+inline m32x4 mask_and(m32x4 a, m32x4 b) {
+    return vandq_u32(a, b);
+}
+
+inline m32x4 mask_none() {
+    return vdupq_n_u32(0);
+}
+
+// One bit per lane, lane 0 is the lowest bit
+inline u32 mask_bits(m32x4 m) {
+    const u32 lane_bits[] = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(m, vld1q_u32(lane_bits)));
+}
+#endif
+
+inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c) {
+    return add(mul(a, b), c);
+}
+
+inline float dot(f32x4 a, f32x4 b) {
+    return hsum(mul(a, b));
+}
+
+}
+}
+}
+#endif
+
+#endif // Y_MATH_SIMD_H
@@ -0,0 +1,52 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MEMORY_MONOTONICALLOCATOR_H
+#define Y_MEMORY_MONOTONICALLOCATOR_H
+
+#include "PolymorphicAllocator.h"
+
+#include <y/core/FrameArena.h>
+
+namespace y {
+namespace memory {
+
+// Allocations are only freed all at once by release() or when the allocator is destroyed.
+// deallocate only gives back the most recent allocation (which makes growing the last vector cheaper).
+class MonotonicAllocator final : public PolymorphicAllocatorBase {
+    public:
+        MonotonicAllocator(usize block_size = core::FrameArena::default_block_size);
+
+        void* allocate(usize size, usize alignment) override;
+        void deallocate(void* ptr, usize size, usize alignment) override;
+
+        void release();
+
+        core::FrameArena::Stats stats() const;
+
+    private:
+        core::FrameArena _arena;
+};
+
+}
+}
+
+#endif // Y_MEMORY_MONOTONICALLOCATOR_H
@@ -0,0 +1,78 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "PolymorphicAllocator.h"
+
+#include <y/core/FrameArena.h>
+
+#include <new>
+
+namespace y {
+namespace memory {
+
+namespace {
+class DefaultAllocator final : public PolymorphicAllocatorBase {
+    public:
+        void* allocate(usize size, usize alignment) override {
+            if(alignment > max_alignment) {
+                return ::operator new(size, std::align_val_t(alignment));
+            }
+            return ::operator new(size);
+        }
+
+        void deallocate(void* ptr, usize size, usize alignment) override {
+            unused(size);
+            if(alignment > max_alignment) {
+                ::operator delete(ptr, std::align_val_t(alignment));
+            } else {
+                ::operator delete(ptr);
+            }
+        }
+};
+
+class FrameArenaAllocator final : public PolymorphicAllocatorBase {
+    public:
+        void* allocate(usize size, usize alignment) override {
+            return core::frame_arena().allocate(size, alignment);
+        }
+
+        void deallocate(void* ptr, usize size, usize) override {
+            core::frame_arena().try_free(ptr, size);
+        }
+};
+}
+
+PolymorphicAllocatorBase::~PolymorphicAllocatorBase() {
+}
+
+PolymorphicAllocatorBase& default_allocator() {
+    static DefaultAllocator allocator;
+    return allocator;
+}
+
+PolymorphicAllocatorBase& frame_allocator() {
+    static FrameArenaAllocator allocator;
+    return allocator;
+}
+
+}
+}
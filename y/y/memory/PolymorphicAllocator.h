@@ -0,0 +1,96 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MEMORY_POLYMORPHICALLOCATOR_H
+#define Y_MEMORY_POLYMORPHICALLOCATOR_H
+
+#include <y/utils.h>
+#include <y/utils/memory.h>
+
+namespace y {
+namespace memory {
+
+// Same idea as std::pmr::memory_resource: containers are bound to an allocator instance at runtime
+// instead of having it baked in their type.
+class PolymorphicAllocatorBase : NonMovable {
+    public:
+        virtual ~PolymorphicAllocatorBase();
+
+        virtual void* allocate(usize size, usize alignment) = 0;
+        virtual void deallocate(void* ptr, usize size, usize alignment) = 0;
+};
+
+// Uses global new and delete
+PolymorphicAllocatorBase& default_allocator();
+
+// Allocates from core::frame_arena(): memory is only valid until the end of the frame
+PolymorphicAllocatorBase& frame_allocator();
+
+
+template<typename T>
+class PolymorphicAllocator {
+    public:
+        using value_type = T;
+
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::false_type;
+
+        inline PolymorphicAllocator() : _allocator(&default_allocator()) {
+        }
+
+        inline PolymorphicAllocator(PolymorphicAllocatorBase& allocator) : _allocator(&allocator) {
+        }
+
+        template<typename U>
+        inline PolymorphicAllocator(const PolymorphicAllocator<U>& other) : _allocator(&other.allocator()) {
+        }
+
+        inline T* allocate(usize n) {
+            return static_cast<T*>(_allocator->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        inline void deallocate(T* ptr, usize n) {
+            _allocator->deallocate(ptr, n * sizeof(T), alignof(T));
+        }
+
+        inline PolymorphicAllocatorBase& allocator() const {
+            return *_allocator;
+        }
+
+        template<typename U>
+        inline bool operator==(const PolymorphicAllocator<U>& other) const {
+            return _allocator == &other.allocator();
+        }
+
+        template<typename U>
+        inline bool operator!=(const PolymorphicAllocator<U>& other) const {
+            return !operator==(other);
+        }
+
+    private:
+        PolymorphicAllocatorBase* _allocator = nullptr;
+};
+
+}
+}
+
+#endif // Y_MEMORY_POLYMORPHICALLOCATOR_H
@@ -0,0 +1,100 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "PoolAllocator.h"
+
+namespace y {
+namespace memory {
+
+static_assert(PoolAllocator::min_block_size >= max_alignment);
+
+PoolAllocator::PoolAllocator(PolymorphicAllocatorBase& upstream) : _upstream(&upstream) {
+}
+
+PoolAllocator::~PoolAllocator() {
+    release();
+}
+
+usize PoolAllocator::pool_index(usize size) {
+    usize index = 0;
+    for(usize block_size = min_block_size; block_size < size; block_size *= 2) {
+        ++index;
+    }
+    return index;
+}
+
+void* PoolAllocator::allocate(usize size, usize alignment) {
+    if(size > max_block_size || alignment > max_alignment) {
+        return _upstream->allocate(size, alignment);
+    }
+
+    const usize index = pool_index(size);
+    Pool& pool = _pools[index];
+
+    if(FreeBlock* block = pool.free) {
+        pool.free = block->next;
+        return block;
+    }
+
+    const usize block_size = min_block_size << index;
+    if(pool.begin == pool.end) {
+        u8* chunk = static_cast<u8*>(_upstream->allocate(chunk_size, max_alignment));
+        _chunks << chunk;
+        pool.begin = chunk;
+        pool.end = chunk + (chunk_size / block_size) * block_size;
+    }
+
+    void* ptr = pool.begin;
+    pool.begin += block_size;
+    return ptr;
+}
+
+void PoolAllocator::deallocate(void* ptr, usize size, usize alignment) {
+    if(!ptr) {
+        return;
+    }
+
+    if(size > max_block_size || alignment > max_alignment) {
+        _upstream->deallocate(ptr, size, alignment);
+        return;
+    }
+
+    Pool& pool = _pools[pool_index(size)];
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = pool.free;
+    pool.free = block;
+}
+
+void PoolAllocator::release() {
+    for(void* chunk : _chunks) {
+        _upstream->deallocate(chunk, chunk_size, max_alignment);
+    }
+    _chunks.clear();
+    _pools = {};
+}
+
+usize PoolAllocator::chunk_count() const {
+    return _chunks.size();
+}
+
+}
+}
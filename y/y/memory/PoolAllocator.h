@@ -0,0 +1,79 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MEMORY_POOLALLOCATOR_H
+#define Y_MEMORY_POOLALLOCATOR_H
+
+#include "PolymorphicAllocator.h"
+
+#include <y/core/Vector.h>
+
+#include <array>
+
+namespace y {
+namespace memory {
+
+// Power of two size classes from 16 to 4096 bytes, each with its own free list.
+// Blocks are carved out of 64KB chunks taken from the upstream allocator, bigger allocations go to upstream directly.
+// Not thread safe.
+class PoolAllocator final : public PolymorphicAllocatorBase {
+    public:
+        static constexpr usize min_block_size = 16;
+        static constexpr usize max_block_size = 4096;
+        static constexpr usize chunk_size = 64 * 1024;
+
+        PoolAllocator(PolymorphicAllocatorBase& upstream = default_allocator());
+        ~PoolAllocator() override;
+
+        void* allocate(usize size, usize alignment) override;
+        void deallocate(void* ptr, usize size, usize alignment) override;
+
+        // Frees every chunk, even if blocks are still in use
+        void release();
+
+        usize chunk_count() const;
+
+    private:
+        static usize pool_index(usize size);
+
+        static constexpr usize pool_count = 9;
+        static_assert((min_block_size << (pool_count - 1)) == max_block_size);
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        struct Pool {
+            FreeBlock* free = nullptr;
+            u8* begin = nullptr;
+            u8* end = nullptr;
+        };
+
+        std::array<Pool, pool_count> _pools;
+        core::Vector<void*> _chunks;
+
+        PolymorphicAllocatorBase* _upstream = nullptr;
+};
+
+}
+}
+
+#endif // Y_MEMORY_POOLALLOCATOR_H
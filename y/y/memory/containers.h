@@ -0,0 +1,46 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MEMORY_CONTAINERS_H
+#define Y_MEMORY_CONTAINERS_H
+
+#include "PolymorphicAllocator.h"
+
+#include <y/core/Vector.h>
+#include <y/core/HashMap.h>
+
+namespace y {
+namespace memory {
+
+// Containers bound to a PolymorphicAllocatorBase at construction, like the std::pmr ones.
+// Moves carry the allocator along, copies use the default allocator.
+// core::String takes its allocator directly, see String(std::string_view, memory::PolymorphicAllocatorBase&).
+
+template<typename T>
+using Vector = core::Vector<T, core::DefaultVectorResizePolicy, PolymorphicAllocator<T>>;
+
+template<typename Key, typename Value, typename Hasher = Hash<Key>, typename Equal = std::equal_to<Key>, bool StoreHash = false>
+using FlatHashMap = core::FlatHashMap<Key, Value, Hasher, Equal, StoreHash, PolymorphicAllocator<u8>>;
+
+}
+}
+
+#endif // Y_MEMORY_CONTAINERS_H
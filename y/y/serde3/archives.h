@@ -31,6 +31,7 @@ SOFTWARE.
 #include "property.h"
 
 #include <y/io2/io.h>
+#include <y/utils/memory.h>
 
 #define Y_SERDE3_BUFFER
 
@@ -76,6 +77,9 @@ static constexpr u16 compiler_id = 0x00;
 
 static constexpr u16 magic = 0x7966;
 static constexpr u16 version_id = 2 | (compiler_id << 12);
+
+// Set in the size of collections whose elements are padded to their alignment, so they can be borrowed from mapped archives
+static constexpr size_type aligned_collection_bit = size_type(1) << 63;
 }
 
 
@@ -246,10 +250,14 @@ class WritableArchive final {
             static_assert(is_iterable_v<T>);
 
             if constexpr(detail::use_collection_fast_path<remove_cvref_t<T>>) {
-                y_try(write_one(size_type(object.object.size())));
+                constexpr bool aligned = is_borrowable_v<remove_cvref_t<T>>;
+                y_try(write_one(size_type(object.object.size()) | (aligned ? detail::aligned_collection_bit : 0)));
                 if(object.object.size()) {
                     const auto header = detail::build_header(y_create_named_object(*object.object.begin(), detail::collection_version_string));
                     y_try(write_one(header));
+                    if constexpr(aligned) {
+                        y_try(write_padding(alignof(typename remove_cvref_t<T>::value_type)));
+                    }
                     y_try(write_array(object.object.begin(), object.object.size()));
                 }
             } else {
@@ -452,6 +460,13 @@ class WritableArchive final {
             return core::Ok(Success::Full);
         }
 
+        Result write_padding(usize alignment) {
+            const u8 zeros[16] = {};
+            y_debug_assert(alignment <= sizeof(zeros));
+            const usize pos = tell();
+            return write_array(zeros, align_up_to(pos, alignment) - pos);
+        }
+
         usize tell() const {
 #ifdef Y_SERDE3_BUFFER
             return _cached_file_size + _buffer_size;
@@ -632,6 +647,9 @@ class ReadableArchive final {
             size_type collection_size = 0;
             y_try(read_one(collection_size));
 
+            const bool aligned = collection_size & detail::aligned_collection_bit;
+            collection_size &= ~detail::aligned_collection_bit;
+
             if constexpr(IsRange) {
                 if(collection_size != object.object.size()) {
                     return core::Err(Error(ErrorType::SizeError, object.name.data()));
@@ -642,20 +660,28 @@ class ReadableArchive final {
                 if constexpr(detail::use_collection_fast_path<T>) {
                     if(collection_size) {
                         y_try(check_header(y_create_named_object(*object.object.begin(), detail::collection_version_string)));
-                        if constexpr(!IsRange) {
-                            if constexpr(has_resize_v<T>) {
-                                object.object.resize(collection_size);
-                            } else {
-                                if constexpr(has_reserve_v<T>) {
-                                    object.object.reserve(collection_size);
-                                }
-                                while(object.object.size() < collection_size) {
-                                    object.object.emplace_back();
+                        if(aligned) {
+                            using value_type = typename T::value_type;
+                            seek(align_up_to(tell(), alignof(value_type)));
+                        }
+                        if constexpr(is_borrowable_v<T>) {
+                            y_try(read_borrowable(object, collection_size));
+                        } else {
+                            if constexpr(!IsRange) {
+                                if constexpr(has_resize_v<T>) {
+                                    object.object.resize(collection_size);
+                                } else {
+                                    if constexpr(has_reserve_v<T>) {
+                                        object.object.reserve(collection_size);
+                                    }
+                                    while(object.object.size() < collection_size) {
+                                        object.object.emplace_back();
+                                    }
                                 }
                             }
-                        }
-                        if(!_file.read_array(object.object.begin(), collection_size)) {
-                            return core::Err(Error(ErrorType::IOError, object.name.data()));
+                            if(!_file.read_array(object.object.begin(), collection_size)) {
+                                return core::Err(Error(ErrorType::IOError, object.name.data()));
+                            }
                         }
                     }
 
@@ -755,6 +781,32 @@ class ReadableArchive final {
         }
 
 
+        // ------------------------------- BORROWABLE -------------------------------
+        // Elements are referenced in place if the reader can lend its memory and it is aligned for them
+        template<typename T>
+        inline Result read_borrowable(NamedObject<T> object, size_type size) {
+            using value_type = typename T::value_type;
+
+            const usize pos = tell();
+            if(auto r = _file.borrow(usize(size) * sizeof(value_type))) {
+                io2::BorrowedBytes& borrowed = r.unwrap();
+                if(reinterpret_cast<uintptr_t>(borrowed.data) % alignof(value_type) == 0) {
+                    const value_type* data = reinterpret_cast<const value_type*>(borrowed.data);
+                    object.object.borrow(core::Span<value_type>(data, usize(size)), std::move(borrowed.owner));
+                    return core::Ok(Success::Full);
+                }
+                seek(pos);
+            }
+
+            auto& owned = object.object.to_owned();
+            owned.set_min_size(usize(size));
+            if(!_file.read_array(owned.data(), owned.size())) {
+                return core::Err(Error(ErrorType::IOError, object.name.data()));
+            }
+            return core::Ok(Success::Full);
+        }
+
+
         // ------------------------------- POD -------------------------------
         template<typename T>
         inline Result deserialize_pod(NamedObject<T> object) {
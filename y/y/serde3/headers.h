@@ -122,10 +122,18 @@ struct ObjectHeader {
 static_assert(sizeof(TypeHeader) == sizeof(u64));
 static_assert(sizeof(MembersHeader) == sizeof(u64));
 
+template<typename T>
+using has_hash_as_t = typename T::serde3_hash_as;
+
 template<typename T>
 constexpr u32 header_type_hash() {
     using naked = deconst_t<T>;
 
+    // Types can hash as the type they replace if they share its serialized format
+    if constexpr(is_detected_v<has_hash_as_t, naked>) {
+        return header_type_hash<typename naked::serde3_hash_as>();
+    }
+
     if constexpr(is_range_v<T>) {
         static_assert(!has_serde3_v<T>);
         using value_type = typename T::value_type;
@@ -55,6 +55,9 @@ using has_serde3_poly_t = decltype(std::declval<T>()._y_serde3_poly_base);
 template<typename T>
 using has_serde3_ptr_poly_t = decltype(std::declval<T>()->_y_serde3_poly_base);
 
+template<typename T>
+using has_borrow_t = decltype(std::declval<T&>().borrow(std::declval<core::Span<typename T::value_type>>(), std::declval<std::shared_ptr<const void>>()));
+
 }
 
 template<typename T>
@@ -75,6 +78,10 @@ static constexpr bool has_serde3_poly_v = is_detected_v<detail::has_serde3_poly_
 template<typename T>
 static constexpr bool has_serde3_ptr_poly_v = is_detected_v<detail::has_serde3_ptr_poly_t, T>;
 
+// Collections that can reference their elements directly from the archive memory (see core::BorrowableVector)
+template<typename T>
+static constexpr bool is_borrowable_v = is_detected_v<detail::has_borrow_t, T>;
+
 
 
 namespace detail {
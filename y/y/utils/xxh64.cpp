@@ -0,0 +1,149 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "xxh64.h"
+
+#include <cstring>
+
+namespace y {
+
+static constexpr u64 prime_1 = 0x9E3779B185EBCA87;
+static constexpr u64 prime_2 = 0xC2B2AE3D27D4EB4F;
+static constexpr u64 prime_3 = 0x165667B19E3779F9;
+static constexpr u64 prime_4 = 0x85EBCA77C2B2AE63;
+static constexpr u64 prime_5 = 0x27D4EB2F165667C5;
+
+static inline u64 rotl(u64 x, u32 r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// Reference implementation is little endian, like every platform we support
+static inline u64 read_u64(const u8* data) {
+    u64 x = 0;
+    std::memcpy(&x, data, sizeof(x));
+    return x;
+}
+
+static inline u32 read_u32(const u8* data) {
+    u32 x = 0;
+    std::memcpy(&x, data, sizeof(x));
+    return x;
+}
+
+static inline u64 round(u64 acc, u64 input) {
+    acc += input * prime_2;
+    acc = rotl(acc, 31);
+    return acc * prime_1;
+}
+
+static inline u64 merge_round(u64 acc, u64 value) {
+    acc ^= round(0, value);
+    return acc * prime_1 + prime_4;
+}
+
+static inline void process_stripe(std::array<u64, 4>& acc, const u8* data) {
+    acc[0] = round(acc[0], read_u64(data));
+    acc[1] = round(acc[1], read_u64(data + 8));
+    acc[2] = round(acc[2], read_u64(data + 16));
+    acc[3] = round(acc[3], read_u64(data + 24));
+}
+
+
+Xxh64::Xxh64(u64 seed) : _acc{seed + prime_1 + prime_2, seed + prime_2, seed, seed - prime_1}, _seed(seed) {
+}
+
+void Xxh64::update(const void* data, usize size) {
+    const u8* bytes = static_cast<const u8*>(data);
+    const u8* end = bytes + size;
+
+    _total_size += size;
+
+    if(_stripe_size + size < _stripe.size()) {
+        std::memcpy(_stripe.data() + _stripe_size, bytes, size);
+        _stripe_size += size;
+        return;
+    }
+
+    if(_stripe_size) {
+        const usize fill = _stripe.size() - _stripe_size;
+        std::memcpy(_stripe.data() + _stripe_size, bytes, fill);
+        process_stripe(_acc, _stripe.data());
+        bytes += fill;
+        _stripe_size = 0;
+    }
+
+    for(; bytes + _stripe.size() <= end; bytes += _stripe.size()) {
+        process_stripe(_acc, bytes);
+    }
+
+    _stripe_size = usize(end - bytes);
+    std::memcpy(_stripe.data(), bytes, _stripe_size);
+}
+
+u64 Xxh64::digest() const {
+    u64 h = 0;
+    if(_total_size >= _stripe.size()) {
+        h = rotl(_acc[0], 1) + rotl(_acc[1], 7) + rotl(_acc[2], 12) + rotl(_acc[3], 18);
+        for(const u64 acc : _acc) {
+            h = merge_round(h, acc);
+        }
+    } else {
+        h = _seed + prime_5;
+    }
+
+    h += _total_size;
+
+    const u8* bytes = _stripe.data();
+    const u8* end = bytes + _stripe_size;
+
+    for(; bytes + 8 <= end; bytes += 8) {
+        h ^= round(0, read_u64(bytes));
+        h = rotl(h, 27) * prime_1 + prime_4;
+    }
+
+    if(bytes + 4 <= end) {
+        h ^= u64(read_u32(bytes)) * prime_1;
+        h = rotl(h, 23) * prime_2 + prime_3;
+        bytes += 4;
+    }
+
+    for(; bytes != end; ++bytes) {
+        h ^= u64(*bytes) * prime_5;
+        h = rotl(h, 11) * prime_1;
+    }
+
+    h ^= h >> 33;
+    h *= prime_2;
+    h ^= h >> 29;
+    h *= prime_3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+u64 xxh64(const void* data, usize size, u64 seed) {
+    Xxh64 hasher(seed);
+    hasher.update(data, size);
+    return hasher.digest();
+}
+
+}
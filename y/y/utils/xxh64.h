@@ -0,0 +1,54 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_UTILS_XXH64_H
+#define Y_UTILS_XXH64_H
+
+#include <y/defines.h>
+
+#include "types.h"
+
+#include <array>
+
+namespace y {
+
+// Streaming implementation of the 64 bits xxHash (XXH64), used to hash file contents.
+// Not suitable for hash maps keys: use y::Hash for those.
+class Xxh64 {
+    public:
+        Xxh64(u64 seed = 0);
+
+        void update(const void* data, usize size);
+        u64 digest() const;
+
+    private:
+        std::array<u64, 4> _acc;
+        std::array<u8, 32> _stripe = {};
+        usize _stripe_size = 0;
+        u64 _total_size = 0;
+        u64 _seed = 0;
+};
+
+u64 xxh64(const void* data, usize size, u64 seed = 0);
+
+}
+
+#endif // Y_UTILS_XXH64_H
@@ -0,0 +1,113 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "AssetPaths.h"
+
+namespace yave {
+namespace asset_paths {
+
+static bool is_valid_name_char(char c) {
+    return std::isprint(static_cast<unsigned char>(c)) && c != '\\';
+}
+
+static bool is_valid_path_char(char c) {
+    return is_valid_name_char(c) || is_delimiter(c);
+}
+
+bool is_delimiter(char c) {
+    return c == '/';
+}
+
+std::string_view strict_path(std::string_view path) {
+    const bool has_delim = !path.empty() && is_delimiter(path.back());
+    const std::string_view no_delim(path.data(), path.size() - has_delim);
+    return no_delim;
+}
+
+std::string_view strict_parent_path(std::string_view path) {
+    for(usize i = path.size(); i > 0; --i) {
+        if(is_delimiter(path[i - 1])) {
+            return path.substr(0, i - 1);
+        }
+    }
+    return std::string_view();
+}
+
+bool is_strict_direct_parent(std::string_view parent, std::string_view path) {
+    return strict_parent_path(path) == parent;
+}
+
+bool is_strict_indirect_parent(std::string_view parent, std::string_view path) {
+    parent = strict_path(parent);
+    if(parent.size() >= path.size()) {
+        return false;
+    }
+    if(!is_delimiter(path[parent.size()])) {
+        return false;
+    }
+    return path.substr(0, parent.size()) == parent;
+}
+
+bool is_valid_name(std::string_view name) {
+    for(char c : name) {
+        if(!is_valid_name_char(c)) {
+            return false;
+        }
+    }
+    return !name.empty();
+}
+
+bool is_valid_path(std::string_view name) {
+    for(char c : name) {
+        if(!is_valid_path_char(c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+core::String join(std::string_view path, std::string_view name) {
+    if(!path.size()) {
+        return name;
+    }
+    char last = path.back();
+    core::String result;
+    result.set_min_capacity(path.size() + name.size() + 1);
+    result += path;
+    if(!is_delimiter(last)) {
+        result.push_back('/');
+    }
+    result += name;
+    return result;
+}
+
+core::String filename(std::string_view path) {
+    for(usize i = path.size(); i > 0; --i) {
+        if(is_delimiter(path[i - 1])) {
+            return path.substr(i);
+        }
+    }
+    return path;
+}
+
+}
+}
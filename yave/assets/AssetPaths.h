@@ -0,0 +1,53 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ASSETS_ASSETPATHS_H
+#define YAVE_ASSETS_ASSETPATHS_H
+
+#include <yave/yave.h>
+
+#include <y/core/String.h>
+
+namespace yave {
+
+// Asset stores expose a virtual tree where '/' is the only delimiter.
+// "Strict" paths never end with a delimiter.
+namespace asset_paths {
+
+bool is_delimiter(char c);
+
+std::string_view strict_path(std::string_view path);
+std::string_view strict_parent_path(std::string_view path);
+
+bool is_strict_direct_parent(std::string_view parent, std::string_view path);
+bool is_strict_indirect_parent(std::string_view parent, std::string_view path);
+
+bool is_valid_name(std::string_view name);
+bool is_valid_path(std::string_view path);
+
+core::String join(std::string_view path, std::string_view name);
+core::String filename(std::string_view path);
+
+}
+
+}
+
+#endif // YAVE_ASSETS_ASSETPATHS_H
@@ -23,6 +23,10 @@ SOFTWARE.
 #include "AssetStore.h"
 
 #include <y/reflect/reflect.h>
+#include <y/utils/xxh64.h>
+
+#include <array>
+#include <cstring>
 
 namespace yave {
 
@@ -70,5 +74,53 @@ AssetStore::Result<AssetType> AssetStore::asset_type(AssetId id) const {
     return core::Err(ErrorType::UnsupportedOperation);
 }
 
+AssetStore::Result<AssetId> AssetStore::find_by_content(io2::Reader& data) const {
+    unused(data);
+    return core::Err(ErrorType::UnsupportedOperation);
+}
+
+AssetStore::Result<AssetStore::ContentHash> AssetStore::hash_content(io2::Reader& data) {
+    const usize start = data.tell();
+
+    Xxh64 hasher;
+    ContentHash content;
+
+    std::array<u8, 16 * 1024> buffer;
+    while(!data.at_end()) {
+        const auto read = data.read_up_to(buffer.data(), buffer.size());
+        if(!read || !read.unwrap()) {
+            data.seek(start);
+            return core::Err(ErrorType::FilesytemError);
+        }
+        hasher.update(buffer.data(), read.unwrap());
+        content.size += read.unwrap();
+    }
+
+    data.seek(start);
+
+    content.hash = hasher.digest();
+    return core::Ok(content);
+}
+
+bool AssetStore::same_content(io2::Reader& a, io2::Reader& b) {
+    if(a.remaining() != b.remaining()) {
+        return false;
+    }
+
+    std::array<u8, 16 * 1024> buffer_a;
+    std::array<u8, 16 * 1024> buffer_b;
+    while(!a.at_end()) {
+        const auto read = a.read_up_to(buffer_a.data(), buffer_a.size());
+        if(!read || !read.unwrap() || !b.read_array(buffer_b.data(), read.unwrap())) {
+            return false;
+        }
+        if(std::memcmp(buffer_a.data(), buffer_b.data(), read.unwrap())) {
+            return false;
+        }
+    }
+
+    return b.at_end();
+}
+
 }
 
@@ -71,6 +71,19 @@ class AssetStore : NonCopyable {
         virtual Result<> rename(std::string_view from, std::string_view to);
 
         virtual Result<AssetType> asset_type(AssetId id) const;
+
+        // Returns an asset whose data is byte for byte identical to what is left in data, data is left where it started
+        virtual Result<AssetId> find_by_content(io2::Reader& data) const;
+
+    protected:
+        struct ContentHash {
+            u64 hash = 0;
+            usize size = 0;
+        };
+
+        // Hashes what is left in data and seeks back to where it started
+        static Result<ContentHash> hash_content(io2::Reader& data);
+        static bool same_content(io2::Reader& a, io2::Reader& b);
 };
 
 }
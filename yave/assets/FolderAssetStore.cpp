@@ -21,76 +21,90 @@ SOFTWARE.
 **********************************/
 
 #include "FolderAssetStore.h"
+#include "AssetPaths.h"
 
 #include <y/io2/File.h>
-#include <y/concurrent/StaticThreadPool.h>
+#include <y/io2/MappedFile.h>
+#include <y/io2/BufferedReader.h>
+#include <y/concurrent/parallel.h>
 
+#include <y/core/Chrono.h>
 #include <y/utils/log.h>
 #include <y/serde3/archives.h>
 
+#include <yave/utils/filesystem.h>
+
+#include <algorithm>
 #include <charconv>
+#include <cinttypes>
+#include <cstdio>
 
 namespace yave {
 
-static bool is_delimiter(char c) {
-    return c == '/';
-}
+using namespace asset_paths;
 
-static std::string_view strict_path(std::string_view path) {
-    const bool has_delim = !path.empty() && is_delimiter(path.back());
-    const std::string_view no_delim(path.data(), path.size() - has_delim);
-    return no_delim;
-}
+namespace {
+struct IndexEntry {
+    AssetId id;
+    AssetType type = AssetType::Unknown;
+    u32 name_size = 0;
+    u64 file_size = 0;
+};
 
-static std::string_view strict_parent_path(std::string_view path) {
-    for(usize i = path.size(); i > 0; --i) {
-        if(is_delimiter(path[i - 1])) {
-            return path.substr(0, i - 1);
-        }
-    }
-    return std::string_view();
-}
+// Cache of the whole database, only valid while the root folder has not been modified since it was written
+struct AssetIndex {
+    u64 stamp = 0;
 
-static bool is_strict_direct_parent(std::string_view parent, std::string_view path) {
-    return strict_parent_path(path) == parent;
-}
+    // Newline separated folders, and entry names stored back to back in entry order
+    core::String folders;
+    core::String names;
+    core::Vector<IndexEntry> entries;
 
-static bool is_strict_indirect_parent(std::string_view parent, std::string_view path) {
-    parent = strict_path(parent);
-    if(parent.size() >= path.size()) {
-        return false;
-    }
-    if(!is_delimiter(path[parent.size()])) {
-        return false;
-    }
-    return path.substr(0, parent.size()) == parent;
-}
+    y_reflect(AssetIndex, stamp, folders, names, entries)
+};
+
+// Content hash of every entry, written after the index.
+// Indices written before assets were hashed end without it.
+struct IndexHashes {
+    core::Vector<u64> hashes;
 
-static bool is_valid_name_char(char c) {
-    return std::isprint(static_cast<unsigned char>(c)) && c != '\\';
+    y_reflect(IndexHashes, hashes)
+};
 }
 
-static bool is_valid_path_char(char c) {
-    return is_valid_name_char(c) || is_delimiter(c);
+static core::String stringify_hash(u64 hash) {
+    std::array<char, 32> buffer = {0};
+    std::snprintf(buffer.data(), buffer.size(), "%016" PRIx64, hash);
+    return core::String(buffer.data());
 }
 
-[[maybe_unused]]
-static bool is_valid_name(std::string_view name) {
-    for(char c : name) {
-        if(!is_valid_name_char(c)) {
-            return false;
+// Keeps each id in the bucket of its current content only, so rewritten assets don't pile up in the buckets of their past contents
+static void update_hashed_id(core::FlatHashMap<u64, core::Vector<AssetId>>& hashes, AssetId id, u64 previous_hash, u64 hash) {
+    if(previous_hash && previous_hash != hash) {
+        if(const auto it = hashes.find(previous_hash); it != hashes.end()) {
+            core::Vector<AssetId>& ids = it->second;
+            if(const auto id_it = std::find(ids.begin(), ids.end(), id); id_it != ids.end()) {
+                ids.erase_unordered(id_it);
+            }
+            if(ids.is_empty()) {
+                hashes.erase(it);
+            }
         }
     }
-    return !name.empty();
-}
 
-static bool is_valid_path(std::string_view name) {
-    for(char c : name) {
-        if(!is_valid_path_char(c)) {
-            return false;
+    if(hash) {
+        core::Vector<AssetId>& ids = hashes[hash];
+        if(std::find(ids.begin(), ids.end(), id) == ids.end()) {
+            ids << id;
         }
     }
-    return true;
+}
+
+// Every operation of the store creates, renames or removes files in the root folder, which updates its modification time
+static u64 root_folder_stamp(const core::String& root) {
+    std::error_code ec;
+    const auto time = fs::last_write_time(fs::path(root.data()), ec);
+    return ec ? 0 : u64(time.time_since_epoch().count());
 }
 
 
@@ -102,27 +116,11 @@ FolderAssetStore::FolderFileSystemModel::FolderFileSystemModel(FolderAssetStore*
 }
 
 core::String FolderAssetStore::FolderFileSystemModel::join(std::string_view path, std::string_view name) const {
-    if(!path.size()) {
-        return name;
-    }
-    char last = path.back();
-    core::String result;
-    result.set_min_capacity(path.size() + name.size() + 1);
-    result += path;
-    if(!is_delimiter(last)) {
-        result.push_back('/');
-    }
-    result += name;
-    return result;
+    return asset_paths::join(path, name);
 }
 
 core::String FolderAssetStore::FolderFileSystemModel::filename(std::string_view path) const {
-    for(usize i = path.size(); i > 0; --i) {
-        if(is_delimiter(path[i - 1])) {
-            return path.substr(i);
-        }
-    }
-    return path;
+    return asset_paths::filename(path);
 }
 
 FileSystemModel::Result<core::String> FolderAssetStore::FolderFileSystemModel::current_path() const {
@@ -233,6 +231,9 @@ FileSystemModel::Result<> FolderAssetStore::FolderFileSystemModel::remove(std::s
 
     const auto lock = y_profile_unique_lock(_parent->_lock);
 
+    _parent->begin_root_change();
+    y_defer(_parent->end_root_change());
+
     core::Vector<core::String> files_to_delete;
 
     std::set<core::String> new_folders;
@@ -296,6 +297,9 @@ FileSystemModel::Result<> FolderAssetStore::FolderFileSystemModel::rename(std::s
 
     const auto lock = y_profile_unique_lock(_parent->_lock);
 
+    _parent->begin_root_change();
+    y_defer(_parent->end_root_change());
+
     std::map<core::String, AssetData> new_assets;
     {
         for(const auto &[name, data] : _parent->_assets) {
@@ -359,10 +363,16 @@ FolderAssetStore::FolderAssetStore(const core::String& root) : _root(FileSystemM
 
     FileSystemModel::local_filesystem()->create_directory(_root).unwrap();
 
+    // The index lives in a sub folder so that writing it doesn't change the modification time of the root
+    FileSystemModel::local_filesystem()->create_directory(_filesystem.parent_path(index_file_name()).unwrap()).ignore();
+
     reload_all().unwrap();
 }
 
 FolderAssetStore::~FolderAssetStore() {
+    if(_index_dirty && !save_index()) {
+        log_msg("Unable to save asset index", Log::Error);
+    }
 }
 
 core::String FolderAssetStore::asset_data_file_name(AssetId id) const {
@@ -379,6 +389,11 @@ core::String FolderAssetStore::tree_file_name() const {
     return fs->join(_root, ".tree");
 }
 
+core::String FolderAssetStore::index_file_name() const {
+    const auto* fs = FileSystemModel::local_filesystem();
+    return fs->join(fs->join(_root, ".cache"), "index");
+}
+
 core::String FolderAssetStore::next_id_file_name() const {
     const auto* fs = FileSystemModel::local_filesystem();
     return fs->join(_root, ".next_id");
@@ -404,10 +419,18 @@ AssetStore::Result<FolderAssetStore::AssetDesc> FolderAssetStore::load_desc(Asse
         } else {
             const core::String leftover(data + i + 1, data + buffer.size());
             const std::string_view trimmed = core::trim(leftover);
+            const char* end = trimmed.data() + trimmed.size();
 
             u32 type = 0;
-            if(std::from_chars(trimmed.data(), trimmed.data() + trimmed.size(), type).ec == std::errc()) {
+            if(const auto [type_end, ec] = std::from_chars(trimmed.data(), end, type); ec == std::errc()) {
                 desc.type = AssetType(type);
+
+                // Descs written before assets were hashed have no hash line
+                const std::string_view hash = core::trim(std::string_view(type_end, end - type_end));
+                if(std::from_chars(hash.data(), hash.data() + hash.size(), desc.content_hash, 16).ec != std::errc()) {
+                    desc.content_hash = 0;
+                }
+
                 return core::Ok(std::move(desc));
             }
 
@@ -421,7 +444,12 @@ AssetStore::Result<FolderAssetStore::AssetDesc> FolderAssetStore::load_desc(Asse
 AssetStore::Result<> FolderAssetStore::save_desc(AssetId id, const AssetDesc& desc) const {
     y_profile();
 
-    const std::string_view data = fmt("%\n%\n", desc.name, desc.type);
+    const std::string_view data = desc.content_hash
+        ? fmt("%\n%\n%\n", desc.name, desc.type, stringify_hash(desc.content_hash))
+        : fmt("%\n%\n", desc.name, desc.type);
+
+    begin_root_change();
+    y_defer(end_root_change());
 
     const core::String file_name = asset_desc_file_name(id);
     const core::String tmp_file = file_name + "_";
@@ -452,6 +480,117 @@ void FolderAssetStore::rebuild_id_map() const {
     }
 }
 
+void FolderAssetStore::rebuild_hash_map() const {
+    y_profile();
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    if(!_hashes) {
+        _hashes = std::make_unique<std::remove_reference_t<decltype(*_hashes)>>();
+        _hashes->reserve(_assets.size());
+
+        for(const auto& [name, data] : _assets) {
+            if(data.content_hash) {
+                (*_hashes)[data.content_hash] << data.id;
+            }
+        }
+    }
+}
+
+AssetId FolderAssetStore::find_content(const ContentHash& content, io2::Reader& data) const {
+    y_profile();
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    rebuild_id_map();
+    rebuild_hash_map();
+
+    const auto candidates = _hashes->find(content.hash);
+    if(candidates == _hashes->end()) {
+        return AssetId::invalid_id();
+    }
+
+    const usize start = data.tell();
+    for(const AssetId id : candidates->second) {
+        const auto it = _ids->find(id);
+        if(it == _ids->end()) {
+            continue;
+        }
+
+        // Assets that have been rewritten or removed since are left in the map
+        const AssetData& candidate = it->second->second;
+        if(candidate.content_hash != content.hash || candidate.file_size != content.size) {
+            continue;
+        }
+
+        auto candidate_data = this->data(id);
+        if(!candidate_data) {
+            continue;
+        }
+
+        const bool same = same_content(data, *candidate_data.unwrap());
+        data.seek(start);
+
+        if(same) {
+            return id;
+        }
+    }
+
+    return AssetId::invalid_id();
+}
+
+AssetStore::Result<> FolderAssetStore::store_data(io2::Reader& data, AssetData& asset) {
+    y_profile();
+
+    const core::String data_file_name = asset_data_file_name(asset.id);
+
+    // Loaded assets may still borrow from a mapping of the previous file, so we never truncate it in place.
+    // On Windows assets are never mapped, see data()
+    const core::String tmp_file = data_file_name + "_";
+    {
+        y_profile_zone("copying");
+        const auto hash = io2::File::copy(data, tmp_file);
+        if(!hash) {
+            return core::Err(ErrorType::FilesytemError);
+        }
+        asset.content_hash = hash.unwrap();
+    }
+
+    AssetId shared = AssetId::invalid_id();
+    {
+        auto copied = io2::MappedFile::open(tmp_file);
+        asset.file_size = copied ? copied.unwrap().size() : 0;
+        if(asset.file_size) {
+            shared = find_content(ContentHash{asset.content_hash, asset.file_size}, copied.unwrap());
+        }
+    }
+
+    if(shared != AssetId::invalid_id()) {
+        // Identical payloads are hard links to a single file: the file system counts the references for us.
+        // Writes never modify files in place, so a write to one of them does not affect the others.
+        const core::String link_file = data_file_name + "_link";
+
+        std::error_code ec;
+        fs::remove(fs::path(link_file.data()), ec);
+        fs::create_hard_link(fs::path(asset_data_file_name(shared).data()), fs::path(link_file.data()), ec);
+
+        if(!ec && FileSystemModel::local_filesystem()->rename(link_file, data_file_name)) {
+            // Renaming over another link to the same file does nothing
+            fs::remove(fs::path(link_file.data()), ec);
+            fs::remove(fs::path(tmp_file.data()), ec);
+            return core::Ok();
+        }
+
+        fs::remove(fs::path(link_file.data()), ec);
+    }
+
+    if(!FileSystemModel::local_filesystem()->rename(tmp_file, data_file_name)) {
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    return core::Ok();
+}
+
 const FileSystemModel* FolderAssetStore::filesystem() const {
     return &_filesystem;
 }
@@ -475,23 +614,23 @@ AssetStore::Result<AssetId> FolderAssetStore::import(io2::Reader& data, std::str
         return core::Err(ErrorType::NameAlreadyExists);
     }
 
-    const AssetId id = next_id();
-    const core::String data_file_name = asset_data_file_name(id);
+    begin_root_change();
+    y_defer(end_root_change());
 
-    {
-        y_profile_zone("writing");
-        if(!io2::File::copy(data, data_file_name)) {
-            return core::Err(ErrorType::FilesytemError);
-        }
-    }
+    AssetData asset = { next_id(), type };
+    y_try(store_data(data, asset));
 
-    const AssetDesc desc = { dst_name, type };
-    y_try(save_desc(id, desc));
+    const AssetDesc desc = { dst_name, type, asset.content_hash };
+    y_try(save_desc(asset.id, desc));
 
-    const auto it = _assets.emplace(dst_name, AssetData{id, type}).first;
+    const AssetId id = asset.id;
+    const auto it = _assets.emplace(dst_name, asset).first;
     if(_ids) {
         (*_ids)[id] = it;
     }
+    if(_hashes) {
+        (*_hashes)[asset.content_hash] << id;
+    }
 
     return core::Ok(id);
 }
@@ -505,16 +644,28 @@ AssetStore::Result<> FolderAssetStore::write(AssetId id, io2::Reader& data) {
 
     const auto lock = y_profile_unique_lock(_lock);
 
-    const core::String data_file_name = asset_data_file_name(id);
-    if(!io2::File::open(data_file_name)) {
+    rebuild_id_map();
+    const auto id_it = _ids->find(id);
+    if(id_it == _ids->end()) {
         return core::Err(ErrorType::UnknownID);
     }
 
-    if(!io2::File::copy(data, data_file_name)) {
-        return core::Err(ErrorType::FilesytemError);
+    const auto it = _assets.find(id_it->second->first);
+    y_debug_assert(it != _assets.end());
+
+    begin_root_change();
+    y_defer(end_root_change());
+
+    AssetData asset = it->second;
+    y_try(store_data(data, asset));
+
+    if(_hashes) {
+        update_hashed_id(*_hashes, id, it->second.content_hash, asset.content_hash);
     }
+    it->second = asset;
 
-    return core::Ok();
+    const AssetDesc desc = { it->first, asset.type, asset.content_hash };
+    return save_desc(id, desc);
 }
 
 AssetStore::Result<io2::ReaderPtr> FolderAssetStore::data(AssetId id) const {
@@ -524,8 +675,21 @@ AssetStore::Result<io2::ReaderPtr> FolderAssetStore::data(AssetId id) const {
         return core::Err(ErrorType::UnknownID);
     }
 
-    if(auto file = io2::File::open(asset_data_file_name(id))) {
-        io2::ReaderPtr ptr = std::make_unique<io2::File>(std::move(file.unwrap()));
+    const core::String data_file_name = asset_data_file_name(id);
+
+    // Deserialization does many tiny reads, so never hand out an unbuffered file
+#ifndef Y_OS_WIN
+    if(auto file = io2::MappedFile::open(data_file_name)) {
+        io2::ReaderPtr ptr = std::make_unique<io2::MappedFile>(std::move(file.unwrap()));
+        return core::Ok(std::move(ptr));
+    }
+#else
+    // Windows can't rename over a file while a view of it is mapped, and loaded assets would keep borrowing from it.
+    // Copying keeps the file free so store_data can replace it.
+#endif
+
+    if(auto file = io2::File::open(data_file_name)) {
+        io2::ReaderPtr ptr = std::make_unique<io2::BufferedReader>(std::make_unique<io2::File>(std::move(file.unwrap())));
         return core::Ok(std::move(ptr));
     }
 
@@ -633,6 +797,22 @@ AssetStore::Result<AssetType> FolderAssetStore::asset_type(AssetId id) const {
 }
 
 
+AssetStore::Result<AssetId> FolderAssetStore::find_by_content(io2::Reader& data) const {
+    y_profile();
+
+    auto content = hash_content(data);
+    y_try(content);
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    if(const AssetId id = find_content(content.unwrap(), data); id != AssetId::invalid_id()) {
+        return core::Ok(id);
+    }
+
+    return core::Err(ErrorType::UnknownID);
+}
+
+
 AssetId FolderAssetStore::next_id() {
     const auto lock = y_profile_unique_lock(_lock);
 
@@ -699,6 +879,9 @@ FolderAssetStore::Result<> FolderAssetStore::save_tree() const {
         }
     }
 
+    begin_root_change();
+    y_defer(end_root_change());
+
     {
         const core::String file_name = tree_file_name();
         const core::String tmp_file = file_name + "_";
@@ -735,6 +918,7 @@ FolderAssetStore::Result<> FolderAssetStore::load_asset_descs() {
     const auto lock = y_profile_unique_lock(_lock);
 
     _ids = nullptr;
+    _hashes = nullptr;
     _assets.clear();
 
     core::Vector<u64> desc_ids;
@@ -765,62 +949,52 @@ FolderAssetStore::Result<> FolderAssetStore::load_asset_descs() {
     }
 
 
-    core::Vector<core::Vector<std::pair<AssetDesc, AssetData>>> assets;
+    core::Vector<std::pair<AssetDesc, AssetData>> assets;
     {
         y_profile_zone("Reading descs");
-        concurrent::StaticThreadPool thread_pool;
-
-        y_profile_zone("schedule");
-        const usize split = desc_ids.size() / (thread_pool.concurency() * 8);
-        for(usize i = 0; i < desc_ids.size(); i += split) {
-            const core::Range range(desc_ids.begin() + i, desc_ids.begin() + std::min(desc_ids.size(), i + split));
-
-            const usize index = assets.size();
-            assets.emplace_back();
-
-            thread_pool.schedule([this, range, index, &assets] {
-                y_profile_zone("Reading descs internal");
-                for(const u64 uid : range) {
-                    const AssetId id = AssetId::from_id(uid);
-                    if(auto r = load_desc(id)) {
-                        AssetDesc desc = r.unwrap();
-                        AssetData data = { id, desc.type, 0 };
-
-                        if(auto file = io2::File::open(asset_data_file_name(id))) {
-                            data.file_size = file.unwrap().size();
-                        } else {
-                            log_msg(fmt("\"%\" has no asset file", desc.name), Log::Error);
-                            continue;
-                        }
 
-                        assets[index].emplace_back(std::move(desc), std::move(data));
-                    } else {
-                        log_msg(fmt("%.desc could not be read", uid), Log::Error);
-                    }
+        assets.set_min_size(desc_ids.size());
+        concurrent::parallel_for(0, desc_ids.size(), 16, [&](usize i) {
+            const AssetId id = AssetId::from_id(desc_ids[i]);
+            if(auto r = load_desc(id)) {
+                AssetDesc desc = r.unwrap();
+                AssetData data = { id, desc.type, 0, desc.content_hash };
+
+                if(auto file = io2::File::open(asset_data_file_name(id))) {
+                    data.file_size = file.unwrap().size();
+                } else {
+                    log_msg(fmt("\"%\" has no asset file", desc.name), Log::Error);
+                    return;
                 }
-            });
-        }
+
+                assets[i] = {std::move(desc), std::move(data)};
+            } else {
+                log_msg(fmt("%.desc could not be read", desc_ids[i]), Log::Error);
+            }
+        });
     }
 
     {
         y_profile_zone("Merging descs");
         usize emergency_id = 1;
-        for(auto& a : assets) {
-            for(auto& [desc, data] : a) {
-                if(!_assets.emplace(desc.name, data).second) {
-                    log_msg(fmt("\"%\" already exists in asset database", desc.name), Log::Error);
-
-                    {
-                        fmt_into(desc.name, "_(%)", emergency_id++);
-                        _assets.emplace(desc.name, data);
-                        save_desc(data.id, desc).ignore();
-                    }
+        for(auto& [desc, data] : assets) {
+            if(data.id == AssetId::invalid_id()) {
+                continue;
+            }
+
+            if(!_assets.emplace(desc.name, data).second) {
+                log_msg(fmt("\"%\" already exists in asset database", desc.name), Log::Error);
+
+                {
+                    fmt_into(desc.name, "_(%)", emergency_id++);
+                    _assets.emplace(desc.name, data);
+                    save_desc(data.id, desc).ignore();
                 }
+            }
 
-                if(auto parent = _filesystem.parent_path(desc.name); parent && !parent.unwrap().is_empty()) {
-                    if(_folders.insert(parent.unwrap()).second) {
-                        log_msg(fmt("\"%\" was not found in folder database", parent.unwrap()), Log::Warning);
-                    }
+            if(auto parent = _filesystem.parent_path(desc.name); parent && !parent.unwrap().is_empty()) {
+                if(_folders.insert(parent.unwrap()).second) {
+                    log_msg(fmt("\"%\" was not found in folder database", parent.unwrap()), Log::Warning);
                 }
             }
         }
@@ -829,14 +1003,181 @@ FolderAssetStore::Result<> FolderAssetStore::load_asset_descs() {
     return core::Ok();
 }
 
+FolderAssetStore::Result<> FolderAssetStore::load_index() {
+    y_profile();
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    _ids = nullptr;
+    _hashes = nullptr;
+    _folders.clear();
+    _assets.clear();
+
+    auto file = io2::MappedFile::open(index_file_name());
+    if(!file) {
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    AssetIndex index;
+    if(!serde3::ReadableArchive(file.unwrap()).deserialize(index)) {
+        log_msg("Unable to read asset index", Log::Warning);
+        return core::Err(ErrorType::Unknown);
+    }
+
+    const u64 stamp = root_folder_stamp(_root);
+    if(!stamp || index.stamp != stamp) {
+        log_msg("Asset index is out of date");
+        return core::Err(ErrorType::Unknown);
+    }
+
+    IndexHashes hashes;
+    if(!file.unwrap().at_end()) {
+        if(!serde3::ReadableArchive(file.unwrap()).deserialize(hashes) || hashes.hashes.size() != index.entries.size()) {
+            log_msg("Unable to read asset index content hashes", Log::Warning);
+            return core::Err(ErrorType::Unknown);
+        }
+    }
+
+    {
+        usize begin = 0;
+        for(usize i = 0; i != index.folders.size(); ++i) {
+            if(index.folders[i] == '\n') {
+                _folders.emplace_hint(_folders.end(), index.folders.sub_str(begin, i - begin));
+                begin = i + 1;
+            }
+        }
+    }
+
+    {
+        usize name_offset = 0;
+        for(usize i = 0; i != index.entries.size(); ++i) {
+            const IndexEntry& entry = index.entries[i];
+            if(name_offset + entry.name_size > index.names.size()) {
+                log_msg("Asset index is corrupted", Log::Warning);
+                _folders.clear();
+                _assets.clear();
+                return core::Err(ErrorType::Unknown);
+            }
+
+            // Entries are sorted by name so every insertion is at the end
+            _assets.emplace_hint(_assets.end(), index.names.sub_str(name_offset, entry.name_size), AssetData{entry.id, entry.type, entry.file_size, hashes.hashes.is_empty() ? 0 : hashes.hashes[i]});
+            name_offset += entry.name_size;
+        }
+    }
+
+    _index_stamp = stamp;
+    _index_dirty = false;
+
+    return core::Ok();
+}
+
+FolderAssetStore::Result<> FolderAssetStore::save_index() const {
+    y_profile();
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    const core::String file_name = index_file_name();
+
+    // Someone else modified the root since we loaded it: the index would claim their changes as ours
+    if(!_index_stamp || root_folder_stamp(_root) != _index_stamp) {
+        log_msg("Asset folder was modified externally, dropping the index", Log::Warning);
+        FileSystemModel::local_filesystem()->remove(file_name).ignore();
+        _index_dirty = false;
+        return core::Ok();
+    }
+
+    AssetIndex index;
+    IndexHashes hashes;
+    index.stamp = _index_stamp;
+
+    {
+        usize folders_size = 0;
+        for(const core::String& folder : _folders) {
+            folders_size += folder.size() + 1;
+        }
+
+        usize names_size = 0;
+        for(const auto& [name, data] : _assets) {
+            names_size += name.size();
+        }
+
+        // Strings don't grow geometrically
+        index.folders.set_min_capacity(folders_size);
+        index.names.set_min_capacity(names_size);
+        index.entries.set_min_capacity(_assets.size());
+        hashes.hashes.set_min_capacity(_assets.size());
+    }
+
+    for(const core::String& folder : _folders) {
+        index.folders += folder;
+        index.folders += "\n";
+    }
+
+    for(const auto& [name, data] : _assets) {
+        index.names += name;
+        index.entries.emplace_back(IndexEntry{data.id, data.type, u32(name.size()), data.file_size});
+        hashes.hashes << data.content_hash;
+    }
+
+    const core::String tmp_file = file_name + "_";
+
+    {
+        auto file = io2::File::create(tmp_file);
+        if(!file || !serde3::WritableArchive(file.unwrap()).serialize(index) || !serde3::WritableArchive(file.unwrap()).serialize(hashes)) {
+            return core::Err(ErrorType::FilesytemError);
+        }
+    }
+
+    if(!FileSystemModel::local_filesystem()->rename(tmp_file, file_name)) {
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    _index_dirty = false;
+
+    return core::Ok();
+}
+
+void FolderAssetStore::begin_root_change() const {
+    const auto lock = y_profile_unique_lock(_lock);
+
+    if(!_root_changes++ && _index_stamp != root_folder_stamp(_root)) {
+        _index_stamp = 0;
+    }
+    _index_dirty = true;
+}
+
+void FolderAssetStore::end_root_change() const {
+    const auto lock = y_profile_unique_lock(_lock);
+
+    y_debug_assert(_root_changes);
+    if(!--_root_changes && _index_stamp) {
+        _index_stamp = root_folder_stamp(_root);
+    }
+}
+
 FolderAssetStore::Result<> FolderAssetStore::reload_all() {
     y_profile();
 
     const auto lock = y_profile_unique_lock(_lock);
 
+    core::Chrono chrono;
+
     _next_id = u64(std::time(nullptr));
-    load_tree().unwrap();
-    load_asset_descs().unwrap();
+
+    if(load_index()) {
+        log_msg(fmt("Asset store loaded from index in %ms (% assets)", chrono.elapsed().to_millis(), _assets.size()));
+    } else {
+        // Taken before scanning, so changes made while we read are caught before saving
+        _index_stamp = root_folder_stamp(_root);
+
+        load_tree().unwrap();
+        load_asset_descs().unwrap();
+        log_msg(fmt("Asset store scanned in %ms (% assets)", chrono.elapsed().to_millis(), _assets.size()));
+
+        if(!save_index()) {
+            log_msg("Unable to save asset index", Log::Warning);
+        }
+    }
 
     rebuild_id_map();
 
@@ -68,12 +68,14 @@ class FolderAssetStore final : NonMovable, public AssetStore {
     struct AssetData {
         AssetId id;
         AssetType type;
-        usize file_size;
+        usize file_size = 0;
+        u64 content_hash = 0;
     };
 
     struct AssetDesc {
         core::String name;
         AssetType type;
+        u64 content_hash = 0;
     };
 
     public:
@@ -97,11 +99,18 @@ class FolderAssetStore final : NonMovable, public AssetStore {
 
         Result<AssetType> asset_type(AssetId id) const override;
 
+        Result<AssetId> find_by_content(io2::Reader& data) const override;
+
     private:
         AssetId next_id();
         void rebuild_id_map() const;
+        void rebuild_hash_map() const;
+
+        AssetId find_content(const ContentHash& content, io2::Reader& data) const;
+        Result<> store_data(io2::Reader& data, AssetData& asset);
 
         core::String tree_file_name() const;
+        core::String index_file_name() const;
         core::String next_id_file_name() const;
         core::String asset_data_file_name(AssetId id) const;
         core::String asset_desc_file_name(AssetId id) const;
@@ -116,6 +125,14 @@ class FolderAssetStore final : NonMovable, public AssetStore {
 
         Result<> load_asset_descs();
 
+        Result<> load_index();
+        Result<> save_index() const;
+
+        // Every change the store makes to the root folder is wrapped in these, so that the index stamp keeps up with
+        // our own changes but not with anyone else's
+        void begin_root_change() const;
+        void end_root_change() const;
+
         Result<> reload_all();
 
         core::String _root;
@@ -126,8 +143,17 @@ class FolderAssetStore final : NonMovable, public AssetStore {
 
         mutable std::unique_ptr<core::FlatHashMap<AssetId, std::map<core::String, AssetData>::const_iterator>> _ids;
 
+        // Ids by content hash. Removed assets are not taken out, so entries are checked against the asset data before being used
+        mutable std::unique_ptr<core::FlatHashMap<u64, core::Vector<AssetId>>> _hashes;
+
         mutable std::recursive_mutex _lock;
 
+        mutable bool _index_dirty = false;
+
+        // Stamp of the root folder as last seen by the store, 0 once someone else has modified it
+        mutable u64 _index_stamp = 0;
+        mutable u32 _root_changes = 0;
+
         FolderFileSystemModel _filesystem;
 };
 }
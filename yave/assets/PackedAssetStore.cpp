@@ -0,0 +1,1159 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "PackedAssetStore.h"
+#include "AssetPaths.h"
+
+#include <y/io2/File.h>
+#include <y/io2/Buffer.h>
+
+#include <y/utils/log.h>
+#include <y/utils/memory.h>
+#include <y/utils/xxh64.h>
+#include <y/serde3/archives.h>
+
+#include <algorithm>
+#include <ctime>
+
+namespace yave {
+
+using namespace asset_paths;
+
+// Past this point the journal is folded into the table of contents
+static constexpr usize max_journal_entries = 4096;
+
+// Compaction only triggers when the pack wastes more than this and more than it actually uses
+static constexpr u64 min_compaction_waste = 64 * 1024 * 1024;
+
+static constexpr usize copy_buffer_size = 16 * 1024;
+
+// Keeps each id in the bucket of its current content only, so rewritten assets don't pile up in the buckets of their past contents
+static void update_hashed_id(core::FlatHashMap<u64, core::Vector<AssetId>>& hashes, AssetId id, u64 previous_hash, u64 hash) {
+    if(previous_hash && previous_hash != hash) {
+        if(const auto it = hashes.find(previous_hash); it != hashes.end()) {
+            core::Vector<AssetId>& ids = it->second;
+            if(const auto id_it = std::find(ids.begin(), ids.end(), id); id_it != ids.end()) {
+                ids.erase_unordered(id_it);
+            }
+            if(ids.is_empty()) {
+                hashes.erase(it);
+            }
+        }
+    }
+
+    if(hash) {
+        core::Vector<AssetId>& ids = hashes[hash];
+        if(std::find(ids.begin(), ids.end(), id) == ids.end()) {
+            ids << id;
+        }
+    }
+}
+
+namespace {
+// Plain data so the whole table is read with a handful of memcpys
+struct TocEntry {
+    AssetId id;
+    AssetType type = AssetType::Unknown;
+    u32 name_size = 0;
+    u64 offset = 0;
+    u64 size = 0;
+};
+
+struct Toc {
+    u64 sequence = 0;
+    u64 generation = 0;
+
+    // Newline separated folders, and entry names stored back to back in entry order
+    core::String folders;
+    core::String names;
+    core::Vector<TocEntry> entries;
+
+    y_reflect(Toc, sequence, generation, folders, names, entries)
+};
+
+// Content hash of every entry, written after the table of contents.
+// Tables written before assets were hashed end without it.
+struct TocHashes {
+    core::Vector<u64> hashes;
+
+    y_reflect(TocHashes, hashes)
+};
+
+struct JournalEntry {
+    core::String name;
+    TocEntry entry;
+    u64 content_hash = 0;
+
+    y_reflect(JournalEntry, name, entry, content_hash)
+};
+}
+
+static u64 aligned_entry_size(u64 size) {
+    return align_up_to(size, PackedAssetStore::entry_alignment);
+}
+
+static bool write_padding(io2::File& file, usize size) {
+    y_debug_assert(size < PackedAssetStore::entry_alignment);
+    const std::array<u8, PackedAssetStore::entry_alignment> padding = {};
+    return file.write(padding.data(), size).is_ok();
+}
+
+
+
+PackedAssetStore::PackedFileSystemModel::PackedFileSystemModel(PackedAssetStore* parent) : _parent(parent) {
+}
+
+core::String PackedAssetStore::PackedFileSystemModel::join(std::string_view path, std::string_view name) const {
+    return asset_paths::join(path, name);
+}
+
+core::String PackedAssetStore::PackedFileSystemModel::filename(std::string_view path) const {
+    return asset_paths::filename(path);
+}
+
+FileSystemModel::Result<core::String> PackedAssetStore::PackedFileSystemModel::current_path() const {
+    return core::Ok(core::String());
+}
+
+FileSystemModel::Result<core::String> PackedAssetStore::PackedFileSystemModel::parent_path(std::string_view path) const {
+    return core::Ok(core::String(strict_parent_path(path)));
+}
+
+FileSystemModel::Result<bool> PackedAssetStore::PackedFileSystemModel::exists(std::string_view path) const {
+    y_profile();
+
+    if(path.empty()) {
+        return core::Ok(true);
+    }
+
+    const bool has_delim = is_delimiter(path.back());
+    const std::string_view no_delim = strict_path(path);
+
+    const auto lock = y_profile_unique_lock(_parent->_lock);
+    return core::Ok(_parent->_folders.find(no_delim) != _parent->_folders.end() || (!has_delim && _parent->_assets.find(no_delim) != _parent->_assets.end()));
+}
+
+FileSystemModel::Result<FileSystemModel::EntryType> PackedAssetStore::PackedFileSystemModel::entry_type(std::string_view path) const {
+    y_profile();
+
+    if(path.empty()) {
+        return core::Ok(EntryType::Directory);
+    }
+
+    const auto lock = y_profile_unique_lock(_parent->_lock);
+    const bool is_dir = _parent->_folders.find(strict_path(path)) != _parent->_folders.end();
+    return core::Ok(is_dir ? EntryType::Directory : EntryType::File);
+}
+
+FileSystemModel::Result<core::String> PackedAssetStore::PackedFileSystemModel::absolute(std::string_view path) const {
+    return core::Ok(core::String(path));
+}
+
+FileSystemModel::Result<> PackedAssetStore::PackedFileSystemModel::for_each(std::string_view path, const for_each_f& func) const {
+    y_profile();
+
+    path = strict_path(path);
+
+    const bool is_root = path.empty();
+
+    const auto lock = y_profile_unique_lock(_parent->_lock);
+
+    for(auto it = _parent->_folders.lower_bound(path); it != _parent->_folders.end(); ++it) {
+        if(is_strict_direct_parent(path, *it)) {
+            const EntryInfo info = {
+                EntryType::Directory,
+                it->sub_str(path.size() + !is_root),
+                0
+            };
+            func(info);
+        } else if(!it->starts_with(path)) {
+            break;
+        }
+    }
+
+    for(auto it = _parent->_assets.lower_bound(path); it != _parent->_assets.end(); ++it) {
+        if(is_strict_direct_parent(path, it->first)) {
+            const EntryInfo info = {
+                EntryType::File,
+                it->first.sub_str(path.size() + !is_root),
+                usize(it->second.size)
+            };
+            func(info);
+        } else if(!it->first.starts_with(path)) {
+            break;
+        }
+    }
+
+    return core::Ok();
+}
+
+FileSystemModel::Result<> PackedAssetStore::PackedFileSystemModel::create_directory(std::string_view path) const {
+    y_profile();
+
+    path = strict_path(path);
+
+    if(path.empty()) {
+        return core::Ok();
+    }
+
+    const auto lock = y_profile_unique_lock(_parent->_lock);
+
+    const auto parent = strict_parent_path(path);
+    if(!is_directory(parent).unwrap_or(false)) {
+        y_try(create_directory(parent));
+    }
+
+    if(_parent->_folders.emplace(path).second) {
+        log_msg(fmt("Folder created: %", path));
+        if(!_parent->save_or_reload_toc()) {
+            return core::Err();
+        }
+    }
+
+    return core::Ok();
+}
+
+FileSystemModel::Result<> PackedAssetStore::PackedFileSystemModel::remove(std::string_view path) const {
+    y_profile();
+
+    path = strict_path(path);
+
+    const auto lock = y_profile_unique_lock(_parent->_lock);
+
+    std::set<core::String> new_folders;
+    for(const core::String& folder : _parent->_folders) {
+        if(!is_strict_indirect_parent(path, folder) && folder != path) {
+            new_folders.insert(folder);
+        }
+    }
+
+    // Only the affected range of the map is touched: the store can hold a lot of assets
+    usize removed = 0;
+    auto& assets = _parent->_assets;
+    for(auto it = assets.lower_bound(path); it != assets.end() && it->first.starts_with(path);) {
+        if(is_strict_indirect_parent(path, it->first) || it->first == path) {
+            _parent->_live_size -= aligned_entry_size(it->second.size);
+            it = assets.erase(it);
+            ++removed;
+        } else {
+            ++it;
+        }
+    }
+
+    log_msg(fmt("Removed % assets", removed));
+
+    _parent->_ids = nullptr;
+    std::swap(new_folders, _parent->_folders);
+
+    if(!_parent->save_or_reload_toc()) {
+        return core::Err();
+    }
+
+    _parent->compact_if_needed();
+
+    return core::Ok();
+}
+
+FileSystemModel::Result<> PackedAssetStore::PackedFileSystemModel::rename(std::string_view from, std::string_view to) const {
+    y_profile();
+
+    from = strict_path(from);
+    to = strict_path(to);
+
+    if(!is_valid_path(to) || to.empty() || from.empty()) {
+        return core::Err();
+    }
+
+    const auto lock = y_profile_unique_lock(_parent->_lock);
+
+    const auto is_renamed = [&](std::string_view name) {
+        return is_strict_indirect_parent(from, name) || from == name;
+    };
+
+    auto& assets = _parent->_assets;
+
+    core::Vector<std::pair<std::map<core::String, AssetData>::iterator, core::String>> renamed;
+    for(auto it = assets.lower_bound(from); it != assets.end() && it->first.starts_with(from); ++it) {
+        if(is_renamed(it->first)) {
+            const std::string_view end = it->first.sub_str(from.size());
+            core::String new_name = end.empty() ? core::String(to) : join(to, end.substr(1));
+
+            if(const auto existing = assets.find(new_name); existing != assets.end() && !is_renamed(existing->first)) {
+                return core::Err();
+            }
+
+            renamed.emplace_back(it, std::move(new_name));
+        }
+    }
+
+    core::Vector<decltype(assets.extract(assets.begin()))> nodes;
+    for(auto& [it, new_name] : renamed) {
+        nodes.emplace_back(assets.extract(it));
+        nodes.last().key() = std::move(new_name);
+    }
+    for(auto& node : nodes) {
+        assets.insert(std::move(node));
+    }
+
+    std::set<core::String> new_folders;
+    for(const core::String& folder : _parent->_folders) {
+        core::String new_name = folder;
+
+        if(is_strict_indirect_parent(from, folder)) {
+            const std::string_view end = folder.sub_str(from.size() + 1);
+            new_name = join(to, end);
+        } else if(from == folder) {
+            new_name = to;
+        }
+
+        new_folders.insert(new_name);
+    }
+
+    _parent->_ids = nullptr;
+    std::swap(new_folders, _parent->_folders);
+
+    if(!_parent->save_or_reload_toc()) {
+        return core::Err();
+    }
+
+    return core::Ok();
+}
+
+
+
+
+
+
+
+
+PackedAssetStore::PackedAssetStore(const core::String& root) : _root(FileSystemModel::local_filesystem()->absolute(root).unwrap_or(root)), _filesystem(this) {
+    y_profile();
+
+    FileSystemModel::local_filesystem()->create_directory(_root).unwrap();
+
+    reload_all().unwrap();
+}
+
+PackedAssetStore::~PackedAssetStore() {
+}
+
+core::String PackedAssetStore::toc_file_name() const {
+    return _filesystem.join(_root, "toc");
+}
+
+core::String PackedAssetStore::journal_file_name() const {
+    return _filesystem.join(_root, "journal");
+}
+
+core::String PackedAssetStore::pack_file_name(u64 generation) const {
+    return _filesystem.join(_root, fmt("%.pack", generation));
+}
+
+usize PackedAssetStore::pack_size() const {
+    const auto lock = y_profile_unique_lock(_lock);
+    return usize(_pack_size);
+}
+
+usize PackedAssetStore::wasted_size() const {
+    const auto lock = y_profile_unique_lock(_lock);
+    return _pack_size > _live_size ? usize(_pack_size - _live_size) : 0;
+}
+
+void PackedAssetStore::rebuild_id_map() const {
+    y_profile();
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    if(!_ids) {
+        _ids = std::make_unique<std::remove_reference_t<decltype(*_ids)>>();
+        _ids->reserve(_assets.size());
+
+        for(auto it = _assets.begin(); it != _assets.end(); ++it) {
+            (*_ids)[it->second.id] = it;
+        }
+    }
+}
+
+void PackedAssetStore::rebuild_hash_map() const {
+    y_profile();
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    if(!_hashes) {
+        _hashes = std::make_unique<std::remove_reference_t<decltype(*_hashes)>>();
+        _hashes->reserve(_assets.size());
+
+        for(const auto& [name, data] : _assets) {
+            if(data.content_hash) {
+                (*_hashes)[data.content_hash] << data.id;
+            }
+        }
+    }
+}
+
+const FileSystemModel* PackedAssetStore::filesystem() const {
+    return &_filesystem;
+}
+
+AssetStore::Result<AssetId> PackedAssetStore::import(io2::Reader& data, std::string_view dst_name, AssetType type) {
+    y_profile();
+
+    dst_name = strict_path(dst_name);
+
+    if(!is_valid_path(dst_name)) {
+        return core::Err(ErrorType::InvalidName);
+    }
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    if(!_filesystem.create_directory(strict_parent_path(dst_name))) {
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    if(_assets.find(dst_name) != _assets.end()) {
+        return core::Err(ErrorType::NameAlreadyExists);
+    }
+
+    const AssetId id = next_id();
+
+    auto appended = append_data(data, id, type);
+    y_try(appended);
+
+    const core::String name = dst_name;
+    set_asset(name, appended.unwrap());
+    if(!append_journal(name, appended.unwrap())) {
+        y_try(save_or_reload_toc());
+    }
+
+    return core::Ok(id);
+}
+
+AssetStore::Result<> PackedAssetStore::write(AssetId id, io2::Reader& data) {
+    y_profile();
+
+    if(id == AssetId::invalid_id()) {
+        return core::Err(ErrorType::UnknownID);
+    }
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    rebuild_id_map();
+    const auto it = _ids->find(id);
+    if(it == _ids->end()) {
+        return core::Err(ErrorType::UnknownID);
+    }
+
+    const core::String name = it->second->first;
+
+    // The previous data is left untouched in the pack: loaded assets may still borrow from it
+    auto appended = append_data(data, id, it->second->second.type);
+    y_try(appended);
+
+    set_asset(name, appended.unwrap());
+    if(!append_journal(name, appended.unwrap())) {
+        y_try(save_or_reload_toc());
+    }
+
+    compact_if_needed();
+
+    return core::Ok();
+}
+
+AssetStore::Result<io2::ReaderPtr> PackedAssetStore::data(AssetId id) const {
+    y_profile();
+
+    if(id == AssetId::invalid_id()) {
+        return core::Err(ErrorType::UnknownID);
+    }
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    rebuild_id_map();
+    const auto it = _ids->find(id);
+    if(it == _ids->end()) {
+        return core::Err(ErrorType::UnknownID);
+    }
+
+    const AssetData& data = it->second->second;
+    if(!data.size) {
+        io2::ReaderPtr ptr = std::make_unique<io2::Buffer>();
+        return core::Ok(std::move(ptr));
+    }
+
+    const usize end = usize(data.offset + data.size);
+    if(end > _pack_view.size()) {
+        // The pack has grown since it was last mapped
+        if(auto file = io2::MappedFile::open(pack_file_name(_generation))) {
+            _pack_view = std::move(file.unwrap());
+        }
+    }
+
+    if(end <= _pack_view.size()) {
+        io2::ReaderPtr ptr = std::make_unique<io2::MappedFile>(_pack_view.slice(usize(data.offset), usize(data.size)));
+        return core::Ok(std::move(ptr));
+    }
+
+    if(auto file = io2::File::open(pack_file_name(_generation))) {
+        core::Vector<u8> bytes(usize(data.size), u8(0));
+        file.unwrap().seek(usize(data.offset));
+        if(file.unwrap().read_array(bytes.data(), bytes.size())) {
+            auto buffer = std::make_unique<io2::Buffer>(bytes.size());
+            buffer->write_array(bytes.data(), bytes.size()).unwrap();
+            buffer->reset();
+
+            io2::ReaderPtr ptr = std::move(buffer);
+            return core::Ok(std::move(ptr));
+        }
+    }
+
+    return core::Err(ErrorType::FilesytemError);
+}
+
+AssetStore::Result<AssetId> PackedAssetStore::id(std::string_view name) const {
+    y_profile();
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    if(const auto it = _assets.find(name); it != _assets.end()) {
+        return core::Ok(it->second.id);
+    }
+
+    return core::Err(ErrorType::UnknownID);
+}
+
+AssetStore::Result<core::String> PackedAssetStore::name(AssetId id) const {
+    y_profile();
+
+    if(id == AssetId::invalid_id()) {
+        return core::Err(ErrorType::UnknownID);
+    }
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    rebuild_id_map();
+    if(const auto it = _ids->find(id); it != _ids->end()) {
+        return core::Ok(core::String(it->second->first));
+    }
+
+    return core::Err(ErrorType::UnknownID);
+}
+
+AssetStore::Result<> PackedAssetStore::remove(AssetId id) {
+    y_profile();
+
+    if(id == AssetId::invalid_id()) {
+        return core::Err(ErrorType::UnknownID);
+    }
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    auto na = name(id);
+    y_try(na);
+
+    if(!_filesystem.remove(na.unwrap())) {
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    return core::Ok();
+}
+
+AssetStore::Result<> PackedAssetStore::rename(AssetId id, std::string_view new_name) {
+    y_profile();
+
+    if(id == AssetId::invalid_id()) {
+        return core::Err(ErrorType::UnknownID);
+    }
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    auto na = name(id);
+    y_try(na);
+
+    return rename(na.unwrap(), new_name);
+}
+
+AssetStore::Result<> PackedAssetStore::remove(std::string_view name) {
+    y_profile();
+
+    if(!_filesystem.remove(name)) {
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    return core::Ok();
+}
+
+AssetStore::Result<> PackedAssetStore::rename(std::string_view from, std::string_view to) {
+    y_profile();
+
+    if(!_filesystem.rename(from, to)) {
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    return core::Ok();
+}
+
+AssetStore::Result<AssetType> PackedAssetStore::asset_type(AssetId id) const {
+    y_profile();
+
+    if(id == AssetId::invalid_id()) {
+        return core::Err(ErrorType::UnknownID);
+    }
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    rebuild_id_map();
+    if(const auto it = _ids->find(id); it != _ids->end()) {
+        return core::Ok(it->second->second.type);
+    }
+
+    return core::Err(ErrorType::UnknownID);
+}
+
+AssetStore::Result<AssetId> PackedAssetStore::find_by_content(io2::Reader& data) const {
+    y_profile();
+
+    auto content = hash_content(data);
+    y_try(content);
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    rebuild_id_map();
+    rebuild_hash_map();
+
+    const auto candidates = _hashes->find(content.unwrap().hash);
+    if(candidates == _hashes->end()) {
+        return core::Err(ErrorType::UnknownID);
+    }
+
+    const usize start = data.tell();
+    for(const AssetId id : candidates->second) {
+        const auto it = _ids->find(id);
+        if(it == _ids->end()) {
+            continue;
+        }
+
+        // Assets that have been rewritten or removed since are left in the map
+        const AssetData& candidate = it->second->second;
+        if(candidate.content_hash != content.unwrap().hash || candidate.size != content.unwrap().size) {
+            continue;
+        }
+
+        auto candidate_data = this->data(id);
+        if(!candidate_data) {
+            continue;
+        }
+
+        const bool same = same_content(data, *candidate_data.unwrap());
+        data.seek(start);
+
+        if(same) {
+            return core::Ok(id);
+        }
+    }
+
+    return core::Err(ErrorType::UnknownID);
+}
+
+AssetStore::Result<> PackedAssetStore::import_store(const AssetStore& store) {
+    y_profile();
+
+    const FileSystemModel* fs = store.filesystem();
+    if(!fs) {
+        return core::Err(ErrorType::UnsupportedOperation);
+    }
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    core::Vector<core::String> files;
+    core::Vector<core::String> to_visit = {core::String()};
+    while(!to_visit.is_empty()) {
+        const core::String path = to_visit.pop();
+        const auto r = fs->for_each(path, [&](const FileSystemModel::EntryInfo& info) {
+            core::String full_name = fs->join(path, info.name);
+            if(info.type == FileSystemModel::EntryType::Directory) {
+                _folders.insert(full_name);
+                to_visit << std::move(full_name);
+            } else {
+                files << std::move(full_name);
+            }
+        });
+
+        if(!r) {
+            return core::Err(ErrorType::FilesytemError);
+        }
+    }
+
+    rebuild_id_map();
+
+    usize imported = 0;
+    for(const core::String& name : files) {
+        const auto id = store.id(name);
+        if(!id) {
+            log_msg(fmt("\"%\" has no id", name), Log::Error);
+            continue;
+        }
+
+        if(_assets.find(name) != _assets.end() || _ids->find(id.unwrap()) != _ids->end()) {
+            log_msg(fmt("\"%\" already exists in asset database", name), Log::Error);
+            continue;
+        }
+
+        auto reader = store.data(id.unwrap());
+        if(!reader) {
+            log_msg(fmt("\"%\" has no asset data", name), Log::Error);
+            continue;
+        }
+
+        auto appended = append_data(*reader.unwrap(), id.unwrap(), store.asset_type(id.unwrap()).unwrap_or(AssetType::Unknown));
+        y_try(appended);
+
+        set_asset(name, appended.unwrap());
+        _next_id = std::max(_next_id, id.unwrap().id() + 1);
+        ++imported;
+    }
+
+    log_msg(fmt("% assets imported in pack", imported));
+
+    return save_or_reload_toc();
+}
+
+AssetStore::Result<> PackedAssetStore::compact() {
+    y_profile();
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    const u64 generation = _generation + 1;
+    const core::String new_pack_name = pack_file_name(generation);
+
+    // Copy in pack order so the old pack is read sequentially
+    core::Vector<AssetData*> entries;
+    for(auto& [name, data] : _assets) {
+        if(data.size) {
+            entries << &data;
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const AssetData* a, const AssetData* b) { return a->offset < b->offset; });
+
+    core::Vector<u64> offsets;
+    u64 size = 0;
+    {
+        y_profile_zone("copying");
+
+        auto src = io2::MappedFile::open(pack_file_name(_generation));
+        auto dst = io2::File::create(new_pack_name);
+        bool ok = dst && (src || entries.is_empty());
+        for(usize i = 0; ok && i != entries.size(); ++i) {
+            const AssetData* data = entries[i];
+            const u64 offset = align_up_to(size, entry_alignment);
+            ok = data->offset + data->size <= src.unwrap().size() &&
+                 write_padding(dst.unwrap(), usize(offset - size)) &&
+                 dst.unwrap().write(src.unwrap().data() + data->offset, usize(data->size));
+            offsets << offset;
+            size = offset + data->size;
+        }
+
+        if(!ok || !dst.unwrap().flush()) {
+            dst = core::Err();
+            FileSystemModel::local_filesystem()->remove(new_pack_name).ignore();
+            log_msg("Unable to compact asset pack", Log::Error);
+            return core::Err(ErrorType::FilesytemError);
+        }
+    }
+
+    const u64 previous_size = _pack_size;
+
+    for(usize i = 0; i != entries.size(); ++i) {
+        entries[i]->offset = offsets[i];
+    }
+
+    _generation = generation;
+    _pack_size = size;
+    _pack_view = io2::MappedFile();
+
+    if(!save_toc()) {
+        // Whichever pack the table on disk points to is kept, the other one is removed as stale
+        reload_all().ignore();
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    remove_stale_packs();
+
+    log_msg(fmt("Asset pack compacted from %MB to %MB", previous_size / (1024 * 1024), size / (1024 * 1024)));
+
+    return core::Ok();
+}
+
+void PackedAssetStore::compact_if_needed() {
+    const u64 wasted = wasted_size();
+    if(wasted > min_compaction_waste && wasted > _live_size) {
+        compact().ignore();
+    }
+}
+
+
+AssetId PackedAssetStore::next_id() {
+    const auto lock = y_profile_unique_lock(_lock);
+
+    return AssetId::from_id(_next_id++);
+}
+
+void PackedAssetStore::set_asset(const core::String& name, const AssetData& data) {
+    rebuild_id_map();
+
+    u64 previous_hash = 0;
+    if(const auto it = _ids->find(data.id); it != _ids->end()) {
+        previous_hash = it->second->second.content_hash;
+        if(it->second->first != name) {
+            _live_size -= aligned_entry_size(it->second->second.size);
+            _assets.erase(it->second);
+            _ids->erase(it);
+        }
+    }
+
+    auto it = _assets.find(name);
+    if(it != _assets.end()) {
+        _live_size -= aligned_entry_size(it->second.size);
+        it->second = data;
+    } else {
+        it = _assets.emplace(name, data).first;
+    }
+
+    _live_size += aligned_entry_size(data.size);
+    (*_ids)[data.id] = it;
+
+    if(_hashes) {
+        update_hashed_id(*_hashes, data.id, previous_hash, data.content_hash);
+    }
+}
+
+PackedAssetStore::Result<PackedAssetStore::AssetData> PackedAssetStore::append_data(io2::Reader& data, AssetId id, AssetType type) {
+    y_profile();
+
+    auto r = io2::File::open_append(pack_file_name(_generation));
+    if(!r) {
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    io2::File& file = r.unwrap();
+
+    const u64 offset = align_up_to(_pack_size, entry_alignment);
+    bool ok = write_padding(file, usize(offset - _pack_size));
+
+    u64 size = 0;
+    Xxh64 hasher;
+    u8 buffer[copy_buffer_size];
+    while(ok && !data.at_end()) {
+        const auto read = data.read_up_to(buffer, sizeof(buffer));
+        ok = read && file.write(buffer, read.unwrap());
+        if(ok) {
+            hasher.update(buffer, read.unwrap());
+            size += read.unwrap();
+        }
+    }
+
+    if(!ok || !file.flush()) {
+        // Whatever was partially written is wasted space
+        _pack_size = file.size();
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    _pack_size = offset + size;
+    return core::Ok(AssetData{id, type, offset, size, hasher.digest()});
+}
+
+PackedAssetStore::Result<> PackedAssetStore::append_journal(std::string_view name, const AssetData& data) {
+    y_profile();
+
+    const JournalEntry entry = {name, TocEntry{data.id, data.type, u32(name.size()), data.offset, data.size}, data.content_hash};
+
+    io2::Buffer buffer;
+    if(!serde3::WritableArchive(buffer).serialize(entry)) {
+        return core::Err(ErrorType::Unknown);
+    }
+
+    auto file = io2::File::open_append(journal_file_name());
+    if(!file || !file.unwrap().write(buffer.data(), buffer.size()) || !file.unwrap().flush()) {
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    if(++_journal_entries >= max_journal_entries) {
+        return save_toc();
+    }
+
+    return core::Ok();
+}
+
+PackedAssetStore::Result<> PackedAssetStore::save_toc() {
+    y_profile();
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    Toc toc;
+    TocHashes hashes;
+    toc.sequence = _sequence + 1;
+    toc.generation = _generation;
+    {
+        usize folders_size = 0;
+        for(const core::String& folder : _folders) {
+            folders_size += folder.size() + 1;
+        }
+
+        usize names_size = 0;
+        for(const auto& [name, data] : _assets) {
+            names_size += name.size();
+        }
+
+        // Strings don't grow geometrically
+        toc.folders.set_min_capacity(folders_size);
+        toc.names.set_min_capacity(names_size);
+        toc.entries.set_min_capacity(_assets.size());
+        hashes.hashes.set_min_capacity(_assets.size());
+    }
+
+    for(const core::String& folder : _folders) {
+        toc.folders += folder;
+        toc.folders += "\n";
+    }
+
+    for(const auto& [name, data] : _assets) {
+        toc.names += name;
+        toc.entries.emplace_back(TocEntry{data.id, data.type, u32(name.size()), data.offset, data.size});
+        hashes.hashes << data.content_hash;
+    }
+
+    const core::String file_name = toc_file_name();
+    const core::String tmp_file = file_name + "_";
+
+    {
+        auto file = io2::File::create(tmp_file);
+        if(!file || !serde3::WritableArchive(file.unwrap()).serialize(toc) || !serde3::WritableArchive(file.unwrap()).serialize(hashes)) {
+            return core::Err(ErrorType::FilesytemError);
+        }
+    }
+
+    if(!FileSystemModel::local_filesystem()->rename(tmp_file, file_name)) {
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    // Any journal left with the previous sequence number is ignored from now on
+    _sequence = toc.sequence;
+
+    return reset_journal();
+}
+
+PackedAssetStore::Result<> PackedAssetStore::save_or_reload_toc() {
+    y_profile();
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    if(!save_toc()) {
+        log_msg("Failed to save asset pack table of contents", Log::Error);
+        reload_all().unwrap();
+        return core::Err(ErrorType::FilesytemError);
+    }
+    return core::Ok();
+}
+
+PackedAssetStore::Result<> PackedAssetStore::reset_journal() {
+    y_profile();
+
+    _journal_entries = 0;
+
+    auto file = io2::File::create(journal_file_name());
+    if(!file || !file.unwrap().write_one(_sequence)) {
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    return core::Ok();
+}
+
+PackedAssetStore::Result<> PackedAssetStore::load_toc() {
+    y_profile();
+
+    _ids = nullptr;
+    _hashes = nullptr;
+    _folders.clear();
+    _assets.clear();
+    _live_size = 0;
+    _sequence = 0;
+    _generation = 0;
+
+    auto file = io2::MappedFile::open(toc_file_name());
+    if(!file) {
+        log_msg("Asset pack has no table of contents", Log::Warning);
+        return core::Ok();
+    }
+
+    Toc toc;
+    if(!serde3::ReadableArchive(file.unwrap()).deserialize(toc)) {
+        log_msg("Unable to read asset pack table of contents", Log::Error);
+        return core::Err(ErrorType::Unknown);
+    }
+
+    TocHashes hashes;
+    if(!file.unwrap().at_end()) {
+        if(!serde3::ReadableArchive(file.unwrap()).deserialize(hashes) || hashes.hashes.size() != toc.entries.size()) {
+            log_msg("Unable to read asset pack content hashes", Log::Error);
+            return core::Err(ErrorType::Unknown);
+        }
+    }
+
+    _sequence = toc.sequence;
+    _generation = toc.generation;
+
+    {
+        usize begin = 0;
+        for(usize i = 0; i != toc.folders.size(); ++i) {
+            if(toc.folders[i] == '\n') {
+                _folders.emplace_hint(_folders.end(), toc.folders.sub_str(begin, i - begin));
+                begin = i + 1;
+            }
+        }
+    }
+
+    {
+        usize name_offset = 0;
+        for(usize i = 0; i != toc.entries.size(); ++i) {
+            const TocEntry& entry = toc.entries[i];
+            if(name_offset + entry.name_size > toc.names.size()) {
+                log_msg("Asset pack table of contents is corrupted", Log::Error);
+                return core::Err(ErrorType::Unknown);
+            }
+
+            // Entries are sorted by name so every insertion is at the end
+            _assets.emplace_hint(_assets.end(), toc.names.sub_str(name_offset, entry.name_size), AssetData{entry.id, entry.type, entry.offset, entry.size, hashes.hashes.is_empty() ? 0 : hashes.hashes[i]});
+            _live_size += aligned_entry_size(entry.size);
+            name_offset += entry.name_size;
+        }
+    }
+
+    return core::Ok();
+}
+
+// Returns false if the journal needs to be folded in the table of contents
+bool PackedAssetStore::replay_journal() {
+    y_profile();
+
+    _journal_entries = 0;
+
+    auto r = io2::MappedFile::open(journal_file_name());
+    if(!r) {
+        return false;
+    }
+
+    io2::MappedFile& file = r.unwrap();
+    if(file.read_one<u64>().unwrap_or(u64(0)) != _sequence) {
+        log_msg("Asset pack journal is out of date", Log::Warning);
+        return false;
+    }
+
+    while(!file.at_end()) {
+        JournalEntry record;
+        if(!serde3::ReadableArchive(file).deserialize(record)) {
+            log_msg("Asset pack journal is truncated", Log::Warning);
+            return false;
+        }
+
+        const TocEntry& entry = record.entry;
+        set_asset(record.name, AssetData{entry.id, entry.type, entry.offset, entry.size, record.content_hash});
+        ++_journal_entries;
+    }
+
+    return _journal_entries < max_journal_entries;
+}
+
+void PackedAssetStore::remove_stale_packs() {
+    y_profile();
+
+    const FileSystemModel* fs = FileSystemModel::local_filesystem();
+
+    const core::String current = fs->filename(pack_file_name(_generation));
+
+    core::Vector<core::String> stale;
+    fs->for_each(_root, [&](const FileSystemModel::EntryInfo& info) {
+        if(info.type == FileSystemModel::EntryType::File && info.name.ends_with(".pack") && info.name != current) {
+            stale << fs->join(_root, info.name);
+        }
+    }).ignore();
+
+    for(const core::String& file : stale) {
+        // May fail on platforms that lock mapped files, we will try again next time
+        if(fs->remove(file)) {
+            log_msg(fmt("Removed stale asset pack %", file));
+        }
+    }
+}
+
+PackedAssetStore::Result<> PackedAssetStore::reload_all() {
+    y_profile();
+
+    const auto lock = y_profile_unique_lock(_lock);
+
+    _pack_view = io2::MappedFile();
+
+    y_try(load_toc());
+    const bool journal_ok = replay_journal();
+
+    _pack_size = 0;
+    if(auto file = io2::File::open(pack_file_name(_generation))) {
+        _pack_size = file.unwrap().size();
+    }
+
+    u64 max_id = 0;
+    std::string_view last_parent;
+    for(auto it = _assets.begin(); it != _assets.end();) {
+        const AssetData& data = it->second;
+        if(data.offset + data.size > _pack_size) {
+            log_msg(fmt("\"%\" has no data in asset pack", it->first), Log::Error);
+            _live_size -= aligned_entry_size(data.size);
+            it = _assets.erase(it);
+            continue;
+        }
+
+        // Assets are sorted, so siblings are next to each other
+        if(const std::string_view parent = strict_parent_path(it->first); !parent.empty() && parent != last_parent) {
+            if(_folders.emplace(parent).second) {
+                log_msg(fmt("\"%\" was not found in folder database", parent), Log::Warning);
+            }
+            last_parent = parent;
+        }
+
+        max_id = std::max(max_id, data.id.id());
+        ++it;
+    }
+
+    _ids = nullptr;
+    _hashes = nullptr;
+    _next_id = std::max(u64(std::time(nullptr)), max_id + 1);
+
+    if(!journal_ok) {
+        y_try(save_toc());
+    }
+
+    remove_stale_packs();
+
+    rebuild_id_map();
+
+    return core::Ok();
+}
+
+}
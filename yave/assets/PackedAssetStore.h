@@ -0,0 +1,162 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ASSETS_PACKEDASSETSTORE_H
+#define YAVE_ASSETS_PACKEDASSETSTORE_H
+
+#include <yave/utils/FileSystemModel.h>
+
+#include "AssetStore.h"
+
+#include <y/core/String.h>
+#include <y/core/HashMap.h>
+#include <y/io2/MappedFile.h>
+
+#include <mutex>
+#include <set>
+#include <map>
+
+namespace yave {
+
+// Stores all assets in a single append only pack file described by a binary table of contents.
+// Imports and writes only append to the pack and to a small journal, folder operations rewrite the table.
+// Overwritten and removed assets leave holes in the pack that are reclaimed by compaction.
+class PackedAssetStore final : NonMovable, public AssetStore {
+
+    class PackedFileSystemModel final : public FileSystemModel {
+        public:
+
+            core::String filename(std::string_view path) const override;
+            core::String  join(std::string_view path, std::string_view name) const override;
+
+            Result<core::String> current_path() const override;
+            Result<core::String> parent_path(std::string_view path) const override;
+
+            Result<bool> exists(std::string_view path) const override;
+            Result<EntryType> entry_type(std::string_view path) const override;
+
+            Result<core::String> absolute(std::string_view path) const override;
+            Result<> for_each(std::string_view path, const for_each_f& func) const override;
+            Result<> create_directory(std::string_view path) const override;
+            Result<> remove(std::string_view path) const override;
+            Result<> rename(std::string_view from, std::string_view to) const override;
+
+        private:
+            friend class PackedAssetStore;
+
+            PackedFileSystemModel(PackedAssetStore* parent);
+
+            PackedAssetStore* _parent = nullptr;
+    };
+
+    struct AssetData {
+        AssetId id;
+        AssetType type;
+        u64 offset;
+        u64 size;
+        u64 content_hash = 0;
+    };
+
+    public:
+        // Entries are aligned so that collections can be borrowed straight from the mapped pack
+        static constexpr usize entry_alignment = 64;
+
+        PackedAssetStore(const core::String& root = "./store.pack");
+        ~PackedAssetStore() override;
+
+        // Copies every folder and asset of store, ids are preserved
+        Result<> import_store(const AssetStore& store);
+
+        Result<> compact();
+
+        usize pack_size() const;
+        usize wasted_size() const;
+
+        const FileSystemModel* filesystem() const override;
+
+        Result<AssetId> import(io2::Reader& data, std::string_view dst_name, AssetType type) override;
+        Result<> write(AssetId id, io2::Reader& data) override;
+
+        Result<AssetId> id(std::string_view name) const override;
+        Result<core::String> name(AssetId id) const override;
+
+        Result<io2::ReaderPtr> data(AssetId id) const override;
+
+        Result<> remove(AssetId id) override;
+        Result<> rename(AssetId id, std::string_view new_name) override;
+        Result<> remove(std::string_view name) override;
+        Result<> rename(std::string_view from, std::string_view to) override;
+
+        Result<AssetType> asset_type(AssetId id) const override;
+
+        Result<AssetId> find_by_content(io2::Reader& data) const override;
+
+    private:
+        AssetId next_id();
+        void rebuild_id_map() const;
+        void rebuild_hash_map() const;
+
+        core::String toc_file_name() const;
+        core::String journal_file_name() const;
+        core::String pack_file_name(u64 generation) const;
+
+        Result<AssetData> append_data(io2::Reader& data, AssetId id, AssetType type);
+        Result<> append_journal(std::string_view name, const AssetData& data);
+        void set_asset(const core::String& name, const AssetData& data);
+
+        Result<> save_toc();
+        Result<> save_or_reload_toc();
+        Result<> reset_journal();
+        void compact_if_needed();
+
+        Result<> load_toc();
+        bool replay_journal();
+        void remove_stale_packs();
+
+        Result<> reload_all();
+
+        core::String _root;
+
+        u64 _next_id = 0;
+        u64 _sequence = 0;
+        u64 _generation = 0;
+        u64 _pack_size = 0;
+        u64 _live_size = 0;
+        usize _journal_entries = 0;
+
+        std::set<core::String> _folders;
+        std::map<core::String, AssetData> _assets;
+
+        mutable std::unique_ptr<core::FlatHashMap<AssetId, std::map<core::String, AssetData>::const_iterator>> _ids;
+
+        // Ids by content hash. Removed assets are not taken out, so entries are checked against the asset data before being used
+        mutable std::unique_ptr<core::FlatHashMap<u64, core::Vector<AssetId>>> _hashes;
+
+        mutable io2::MappedFile _pack_view;
+
+        mutable std::recursive_mutex _lock;
+
+        PackedFileSystemModel _filesystem;
+};
+}
+
+
+#endif // YAVE_ASSETS_PACKEDASSETSTORE_H
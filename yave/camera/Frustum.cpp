@@ -41,26 +41,42 @@ bool Frustum::is_inside(const math::Vec3& pos, float radius) const {
 }
 
 // https://www.lighthouse3d.com/tutorials/view-frustum-culling/geometric-approach-testing-boxes-ii/
-Intersection Frustum::intersection(const AABB &aabb) const {
+// The p and n vertices are never built: their distances to a plane are dist +/- radius
+Intersection Frustum::intersection(const AABB& aabb) const {
+    return intersection(aabb, -1.0f);
+}
+
+Intersection Frustum::intersection(const AABB& aabb, float far_dist) const {
+    return intersection(aabb.center(), aabb.half_extent(), far_dist);
+}
+
+Intersection Frustum::intersection(const math::Vec3& box_center, const math::Vec3& half_extent, float far_dist) const {
     Intersection inter = Intersection::Inside;
 
-    const math::Vec3 bbox_min = aabb.min() - _pos;
-    const math::Vec3 bbox_max = aabb.max() - _pos;
+    const math::Vec3 center = box_center - _pos;
 
     for(const math::Vec3& normal : _normals) {
-        math::Vec3 p = bbox_min;
-        math::Vec3 n = bbox_max;
-        for(usize c = 0; c != 3; ++c) {
-            if(normal[c] > 0.0f) {
-                p[c] = bbox_max[c];
-                n[c] = bbox_min[c];
-            }
+        const float dist = normal.dot(center);
+        const float radius = normal.abs().dot(half_extent);
+
+        if(dist + radius < 0.0f) {
+            return Intersection::Outside;
         }
+        if(dist - radius < 0.0f) {
+            inter = Intersection::Intersects;
+        }
+    }
 
-        if(normal.dot(p) < 0.0f) {
+    // The far plane faces the other way
+    if(far_dist > 0.0f) {
+        const math::Vec3& normal = _normals[0];
+        const float dist = normal.dot(center);
+        const float radius = normal.abs().dot(half_extent);
+
+        if(dist - radius > far_dist) {
             return Intersection::Outside;
         }
-        if(normal.dot(n) < 0.0f) {
+        if(dist + radius > far_dist) {
             inter = Intersection::Intersects;
         }
     }
@@ -68,36 +84,112 @@ Intersection Frustum::intersection(const AABB &aabb) const {
     return inter;
 }
 
-Intersection Frustum::intersection(const AABB &aabb, float far_dist) const {
-    const Intersection inter = intersection(aabb);
+// Same math as intersection() with the boxes in lanes, so both agree exactly
+void Frustum::cull(const AABBBatch& boxes, core::MutableSpan<u32> mask, float far_dist) const {
+    y_profile();
 
-    // Not exactly efficient
-    if(inter != Intersection::Outside && far_dist > 0.0f) {
-        const math::Vec3 bbox_min = aabb.min() - _pos;
-        const math::Vec3 bbox_max = aabb.max() - _pos;
+    const usize box_count = boxes.size();
+    for(usize k = 0; k != 3; ++k) {
+        y_debug_assert(boxes.center[k].size() == box_count);
+        y_debug_assert(boxes.half_extent[k].size() == box_count);
+    }
+    y_debug_assert(boxes.radius.is_empty() || boxes.radius.size() == box_count);
+#ifdef Y_DEBUG
+    for(usize i = 0; i != boxes.radius.size(); ++i) {
+        const math::Vec3 half_extent(boxes.half_extent[0][i], boxes.half_extent[1][i], boxes.half_extent[2][i]);
+        y_debug_assert(boxes.radius[i] >= half_extent.length() * 0.9999f);
+    }
+#endif
+    y_debug_assert(mask.size() >= cull_mask_size(box_count));
 
-        const math::Vec3& normal = _normals[0];
+    std::fill_n(mask.data(), cull_mask_size(box_count), 0u);
 
-        math::Vec3 p = bbox_min;
-        math::Vec3 n = bbox_max;
-        for(usize c = 0; c != 3; ++c) {
-            if(normal[c] < 0.0f) {
-                p[c] = bbox_max[c];
-                n[c] = bbox_min[c];
-            }
+    usize i = 0;
+
+#ifdef Y_SIMD
+    namespace simd = math::simd;
+
+    const bool use_far = far_dist > 0.0f;
+    const bool use_spheres = !boxes.radius.is_empty();
+    const simd::f32x4 zero = simd::splat(0.0f);
+    const simd::f32x4 far = simd::splat(far_dist);
+
+    std::array<simd::f32x4, 3> pos;
+    std::array<std::array<simd::f32x4, 3>, 5> normals;
+    std::array<std::array<simd::f32x4, 3>, 5> abs_normals;
+    for(usize k = 0; k != 3; ++k) {
+        pos[k] = simd::splat(_pos[k]);
+        for(usize p = 0; p != _normals.size(); ++p) {
+            normals[p][k] = simd::splat(_normals[p][k]);
+            abs_normals[p][k] = simd::splat(std::abs(_normals[p][k]));
         }
+    }
 
-        if(normal.dot(p) > -far_dist) {
-            return Intersection::Outside;
+    const auto dot = [](const std::array<simd::f32x4, 3>& a, const std::array<simd::f32x4, 3>& b) {
+        return simd::add(simd::add(simd::mul(a[0], b[0]), simd::mul(a[1], b[1])), simd::mul(a[2], b[2]));
+    };
+
+    for(; i + 4 <= box_count; i += 4) {
+        std::array<simd::f32x4, 3> center;
+        for(usize k = 0; k != 3; ++k) {
+            center[k] = simd::sub(simd::load(boxes.center[k].data() + i), pos[k]);
         }
-        if(normal.dot(n) > -far_dist) {
-            return Intersection::Intersects;
+
+        std::array<simd::f32x4, 5> dists;
+        for(usize p = 0; p != dists.size(); ++p) {
+            dists[p] = dot(normals[p], center);
         }
-    }
 
+        u32 visible = 0;
+        bool done = false;
+
+        // Spheres that are fully inside or fully outside decide for their box
+        if(use_spheres) {
+            const simd::f32x4 radius = simd::load(boxes.radius.data() + i);
+            simd::m32x4 outside = simd::mask_none();
+            simd::m32x4 intersects = simd::mask_none();
+            for(const simd::f32x4& dist : dists) {
+                outside = simd::mask_or(outside, simd::less(simd::add(dist, radius), zero));
+                intersects = simd::mask_or(intersects, simd::less(simd::sub(dist, radius), zero));
+            }
+            if(use_far) {
+                outside = simd::mask_or(outside, simd::greater(simd::sub(dists[0], radius), far));
+                intersects = simd::mask_or(intersects, simd::greater(simd::add(dists[0], radius), far));
+            }
 
-    return inter;
-}
+            const u32 outside_bits = simd::mask_bits(outside);
+            visible = ~outside_bits & 0xF;
+            done = !(simd::mask_bits(intersects) & visible);
+        }
 
+        if(!done) {
+            std::array<simd::f32x4, 3> half_extent;
+            for(usize k = 0; k != 3; ++k) {
+                half_extent[k] = simd::load(boxes.half_extent[k].data() + i);
+            }
+
+            simd::m32x4 outside = simd::mask_none();
+            for(usize p = 0; p != dists.size(); ++p) {
+                const simd::f32x4 radius = dot(abs_normals[p], half_extent);
+                outside = simd::mask_or(outside, simd::less(simd::add(dists[p], radius), zero));
+                if(p == 0 && use_far) {
+                    outside = simd::mask_or(outside, simd::greater(simd::sub(dists[0], radius), far));
+                }
+            }
+            visible = ~simd::mask_bits(outside) & 0xF;
+        }
+
+        mask[i / 32] |= visible << (i % 32);
+    }
+#endif
+
+    for(; i != box_count; ++i) {
+        const math::Vec3 center(boxes.center[0][i], boxes.center[1][i], boxes.center[2][i]);
+        const math::Vec3 half_extent(boxes.half_extent[0][i], boxes.half_extent[1][i], boxes.half_extent[2][i]);
+        if(intersection(center, half_extent, far_dist) != Intersection::Outside) {
+            mask[i / 32] |= 1u << (i % 32);
+        }
+    }
 }
 
+}
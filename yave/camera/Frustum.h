@@ -24,6 +24,8 @@ SOFTWARE.
 
 #include <yave/meshes/AABB.h>
 
+#include <y/core/Span.h>
+
 #include <array>
 
 namespace yave {
@@ -34,6 +36,19 @@ enum class Intersection {
     Outside
 };
 
+// Boxes in SoA form for batched culling, all spans must have the same size.
+// If radius is not empty, each box is first tested against a sphere of that radius around its center.
+// This is only conservative if radius[i] is at least the length of half_extent[i] (the sphere encloses the box).
+struct AABBBatch {
+    std::array<core::Span<float>, 3> center;
+    std::array<core::Span<float>, 3> half_extent;
+    core::Span<float> radius;
+
+    usize size() const {
+        return center[0].size();
+    }
+};
+
 class Frustum {
 
     public:
@@ -46,7 +61,20 @@ class Frustum {
         Intersection intersection(const AABB& aabb) const;
         Intersection intersection(const AABB& aabb, float far_dist) const;
 
+        // Sets bit i of mask (bit i % 32 of mask[i / 32]) if box i is not outside
+        void cull(const AABBBatch& boxes, core::MutableSpan<u32> mask, float far_dist = -1.0f) const;
+
+        static usize cull_mask_size(usize box_count) {
+            return (box_count + 31) / 32;
+        }
+
+        static bool is_visible(core::Span<u32> mask, usize index) {
+            return mask[index / 32] & (1u << (index % 32));
+        }
+
     private:
+        Intersection intersection(const math::Vec3& box_center, const math::Vec3& half_extent, float far_dist) const;
+
         std::array<math::Vec3, 5> _normals;
         math::Vec3 _pos;
 
@@ -0,0 +1,51 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "HierarchyComponent.h"
+
+namespace yave {
+
+HierarchyComponent::HierarchyComponent(const math::Transform<>& local, ecs::EntityId parent) : _local(local), _parent(parent) {
+}
+
+const math::Transform<>& HierarchyComponent::local_transform() const {
+    return _local;
+}
+
+void HierarchyComponent::set_local_transform(const math::Transform<>& tr) {
+    _local = tr;
+}
+
+ecs::EntityId HierarchyComponent::parent() const {
+    return _parent;
+}
+
+bool HierarchyComponent::has_parent() const {
+    return _parent.is_valid();
+}
+
+void HierarchyComponent::set_parent(ecs::EntityId parent) {
+    _parent = parent;
+}
+
+}
+
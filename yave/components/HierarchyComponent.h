@@ -0,0 +1,56 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_COMPONENTS_HIERARCHYCOMPONENT_H
+#define YAVE_COMPONENTS_HIERARCHYCOMPONENT_H
+
+#include <yave/ecs/ecs.h>
+#include <y/reflect/reflect.h>
+
+#include "TransformableComponent.h"
+
+namespace yave {
+
+// Places an entity relative to its parent: the HierarchySystem computes the world transform of the
+// TransformableComponent from the local transform and the world transform of the parent.
+// Changes are found using ecs::Changed: call EntityWorld::mark_changed after modifying it in place.
+class HierarchyComponent final : public ecs::RequiredComponents<TransformableComponent> {
+    public:
+        HierarchyComponent(const math::Transform<>& local = {}, ecs::EntityId parent = ecs::EntityId());
+
+        const math::Transform<>& local_transform() const;
+        void set_local_transform(const math::Transform<>& tr);
+
+        // Entities without a parent, or whose parent isn't part of the hierarchy, are roots: their local transform is their world transform
+        ecs::EntityId parent() const;
+        bool has_parent() const;
+        void set_parent(ecs::EntityId parent);
+
+        y_reflect(HierarchyComponent, _local, _parent)
+
+    private:
+        math::Transform<> _local;
+        ecs::EntityId _parent;
+};
+
+}
+
+#endif // YAVE_COMPONENTS_HIERARCHYCOMPONENT_H
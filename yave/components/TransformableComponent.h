@@ -31,6 +31,9 @@ namespace yave {
 
 class TransformableComponent final {
     public:
+        // Moving a transform marks its octree node as dirty, which is shared between entities
+        static constexpr bool parallel_mutation = false;
+
         TransformableComponent(const math::Transform<>& transform = {});
         ~TransformableComponent();
 
@@ -0,0 +1,269 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "CommandBuffer.h"
+
+#include <algorithm>
+
+namespace yave {
+namespace ecs {
+
+// Removing from the back of the dense array first means that an erase never moves an id that is yet to be removed.
+// Dense indices are marked in a bitset which is then read backward: this sorts them without comparisons and drops duplicates.
+// Ids that aren't in the set are ignored.
+static void collect_removals(const SparseIdSetBase& set, core::Span<EntityId> candidates, core::Vector<u64>& marks, core::Vector<EntityId>& removals) {
+    removals.make_empty();
+    marks.make_empty();
+    marks.set_min_size((set.size() + 63) / 64, u64(0));
+
+    for(const EntityId id : candidates) {
+        if(set.contains(id)) {
+            const usize index = set.dense_index_of(id.index());
+            marks[index / 64] |= u64(1) << (index % 64);
+        }
+    }
+
+    const core::Span<EntityId> dense = set.ids();
+    for(usize w = marks.size(); w != 0; --w) {
+        const u64 word = marks[w - 1];
+        if(!word) {
+            continue;
+        }
+        for(usize b = 64; b != 0; --b) {
+            if((word >> (b - 1)) & 1) {
+                removals << dense[(w - 1) * 64 + b - 1];
+            }
+        }
+    }
+}
+
+bool CommandBuffer::is_empty() const {
+    return !_pending_count &&
+           !_component_add_count &&
+           _component_removals.is_empty() &&
+           _tag_adds.is_empty() &&
+           _tag_removals.is_empty() &&
+           _entity_removals.is_empty();
+}
+
+void CommandBuffer::clear() {
+    for(auto& commands : _components) {
+        if(commands) {
+            commands->clear();
+        }
+    }
+
+    _pending_count = 0;
+    _component_add_count = 0;
+    _component_removals.make_empty();
+    _tag_adds.make_empty();
+    _tag_removals.make_empty();
+    _entity_removals.make_empty();
+}
+
+CommandBuffer::PendingEntity CommandBuffer::create_entity() {
+    return PendingEntity(_pending_count++);
+}
+
+void CommandBuffer::remove_entity(EntityId id) {
+    _entity_removals << id;
+}
+
+void CommandBuffer::add_tag(EntityId id, Tag tag) {
+    y_always_assert(tag.is_valid() && !tag.is_implicit(), "Implicit tags can't be added directly");
+    tag_targets(_tag_adds, tag) << id;
+}
+
+void CommandBuffer::add_tag(PendingEntity entity, Tag tag) {
+    y_always_assert(tag.is_valid() && !tag.is_implicit(), "Implicit tags can't be added directly");
+    tag_targets(_tag_adds, tag) << entity;
+}
+
+void CommandBuffer::remove_tag(EntityId id, Tag tag) {
+    y_always_assert(!tag.is_implicit(), "Implicit tags can't be removed directly");
+    tag_targets(_tag_removals, tag) << id;
+}
+
+// Commands are grouped by tag when recorded, there are usually very few different tags in a buffer
+core::Vector<CommandBuffer::Target>& CommandBuffer::tag_targets(core::Vector<TagCommands>& commands, Tag tag) {
+    if(!commands.is_empty() && commands.last().tag == tag) {
+        return commands.last().targets;
+    }
+    for(TagCommands& command : commands) {
+        if(command.tag == tag) {
+            return command.targets;
+        }
+    }
+    return commands.emplace_back(TagCommands{tag, {}}).targets;
+}
+
+EntityId CommandBuffer::created_id(PendingEntity entity) const {
+    y_debug_assert(entity.index() < _created.size());
+    return _created[entity.index()];
+}
+
+void CommandBuffer::play_back(EntityWorld& world) {
+    y_profile();
+
+    create_entities(world);
+
+    for(auto& commands : _components) {
+        if(commands) {
+            commands->play_back(world, _created);
+        }
+    }
+
+    add_tags(world);
+    remove_components(world);
+    remove_tags(world);
+    remove_entities(world);
+
+    clear();
+}
+
+void CommandBuffer::create_entities(EntityWorld& world) {
+    _created = world.create_entities(_pending_count);
+}
+
+void CommandBuffer::add_tags(EntityWorld& world) {
+    if(_tag_adds.is_empty()) {
+        return;
+    }
+
+    y_profile_zone("adding tags");
+
+    for(const TagCommands& command : _tag_adds) {
+        SparseIdSet& set = world.create_tag_set(command.tag);
+        for(const Target& target : command.targets) {
+            const EntityId id = target.resolve(_created);
+            if(world.exists(id)) {
+                set.insert(id);
+            }
+        }
+    }
+}
+
+void CommandBuffer::remove_components(EntityWorld& world) {
+    if(_component_removals.is_empty()) {
+        return;
+    }
+
+    y_profile_zone("removing components");
+
+    std::sort(_component_removals.begin(), _component_removals.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    core::Vector<EntityId> candidates;
+    core::Vector<u64> marks;
+    core::Vector<EntityId> removals;
+    for(usize i = 0; i != _component_removals.size();) {
+        const ComponentTypeIndex type = _component_removals[i].first;
+
+        candidates.make_empty();
+        for(; i != _component_removals.size() && _component_removals[i].first == type; ++i) {
+            candidates << _component_removals[i].second;
+        }
+
+        ComponentContainerBase* container = world.find_container(type);
+        collect_removals(container->id_set(), candidates, marks, removals);
+        for(const EntityId id : removals) {
+            container->remove(id);
+        }
+    }
+}
+
+void CommandBuffer::remove_tags(EntityWorld& world) {
+    if(_tag_removals.is_empty()) {
+        return;
+    }
+
+    y_profile_zone("removing tags");
+
+    core::Vector<EntityId> candidates;
+    core::Vector<u64> marks;
+    core::Vector<EntityId> removals;
+    for(const TagCommands& command : _tag_removals) {
+        if(SparseIdSet* set = world.raw_tag_set(command.tag)) {
+            candidates.make_empty();
+            for(const Target& target : command.targets) {
+                candidates << target.id;
+            }
+
+            collect_removals(*set, candidates, marks, removals);
+            for(const EntityId id : removals) {
+                set->erase(id);
+            }
+        }
+    }
+}
+
+void CommandBuffer::remove_entities(EntityWorld& world) {
+    if(_entity_removals.is_empty()) {
+        return;
+    }
+
+    y_profile_zone("removing entities");
+
+    // Duplicates are dropped when collecting the removals of each set and when recycling
+    for(usize i = 0; i != _entity_removals.size();) {
+        if(world.exists(_entity_removals[i])) {
+            ++i;
+        } else {
+            _entity_removals.erase_unordered(_entity_removals.begin() + i);
+        }
+    }
+
+    // Each set is visited once for the whole batch, instead of once per entity
+    core::Vector<u64> marks;
+    core::Vector<EntityId> removals;
+    for(auto& container : world._containers) {
+        if(!container || container->id_set().is_empty()) {
+            continue;
+        }
+
+        collect_removals(container->id_set(), _entity_removals, marks, removals);
+        for(const EntityId id : removals) {
+            container->remove(id);
+        }
+    }
+
+    for(auto& [tag, set] : world._tags) {
+        unused(tag);
+        if(set.is_empty()) {
+            continue;
+        }
+
+        collect_removals(set, _entity_removals, marks, removals);
+        for(const EntityId id : removals) {
+            set.erase(id);
+        }
+    }
+
+    for(const EntityId id : _entity_removals) {
+        // Skips duplicates
+        if(world.exists(id)) {
+            world._entities.recycle(id);
+        }
+    }
+}
+
+}
+}
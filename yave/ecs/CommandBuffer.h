@@ -0,0 +1,191 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ECS_COMMANDBUFFER_H
+#define YAVE_ECS_COMMANDBUFFER_H
+
+#include "EntityWorld.h"
+
+namespace yave {
+namespace ecs {
+
+// Records structural changes (entity creations and removals, components and tags) to apply them to a world later.
+// Recording doesn't touch the world: each thread can fill its own buffer without locking, buffers are played back at a sync point.
+// Playback is batched and doesn't follow recording order: creations are applied first, then additions, then removals.
+// Commands on entities that don't exist anymore when the buffer is played back are ignored.
+class CommandBuffer : NonCopyable {
+    public:
+        // Entity created by the buffer, it only gets an id when the buffer is played back
+        class PendingEntity {
+            public:
+                u32 index() const {
+                    return _index;
+                }
+
+            private:
+                friend class CommandBuffer;
+
+                PendingEntity(u32 index) : _index(index) {
+                }
+
+                u32 _index = 0;
+        };
+
+        CommandBuffer() = default;
+        CommandBuffer(CommandBuffer&&) = default;
+        CommandBuffer& operator=(CommandBuffer&&) = default;
+
+        bool is_empty() const;
+        void clear();
+
+        PendingEntity create_entity();
+
+        template<typename... Args>
+        PendingEntity create_entity(StaticArchetype<Args...>) {
+            const PendingEntity entity = create_entity();
+            (add_component<Args>(entity), ...);
+            return entity;
+        }
+
+        void remove_entity(EntityId id);
+
+        template<typename T, typename... Args>
+        void add_component(EntityId id, Args&&... args) {
+            component_commands<T>().adds.emplace_back(Target(id), T{y_fwd(args)...});
+            ++_component_add_count;
+        }
+
+        template<typename T, typename... Args>
+        void add_component(PendingEntity entity, Args&&... args) {
+            component_commands<T>().adds.emplace_back(Target(entity), T{y_fwd(args)...});
+            ++_component_add_count;
+        }
+
+        template<typename T>
+        void remove_component(EntityId id) {
+            _component_removals.emplace_back(type_index<T>(), id);
+        }
+
+        void add_tag(EntityId id, Tag tag);
+        void add_tag(PendingEntity entity, Tag tag);
+
+        void remove_tag(EntityId id, Tag tag);
+
+        // Applies and clears all recorded commands, nothing else should access the world during playback
+        void play_back(EntityWorld& world);
+
+        // Returns the id given to a pending entity by the last playback
+        EntityId created_id(PendingEntity entity) const;
+
+    private:
+        struct Target {
+            static constexpr u32 not_pending = u32(-1);
+
+            Target(EntityId i) : id(i) {
+            }
+
+            Target(PendingEntity entity) : pending(entity.index()) {
+            }
+
+            EntityId resolve(core::Span<EntityId> created) const {
+                return pending == not_pending ? id : created[pending];
+            }
+
+            EntityId id;
+            u32 pending = not_pending;
+        };
+
+        class ComponentCommandsBase : NonMovable {
+            public:
+                virtual ~ComponentCommandsBase() = default;
+
+                virtual void play_back(EntityWorld& world, core::Span<EntityId> created) = 0;
+                virtual void clear() = 0;
+        };
+
+        template<typename T>
+        class ComponentCommands final : public ComponentCommandsBase {
+            public:
+                void play_back(EntityWorld& world, core::Span<EntityId> created) override {
+                    if(adds.is_empty()) {
+                        return;
+                    }
+
+                    auto& set = world.component_set<T>();
+                    set.set_min_capacity(set.size() + adds.size());
+
+                    for(auto& [target, component] : adds) {
+                        const EntityId id = target.resolve(created);
+                        if(world.exists(id)) {
+                            world.add_component<T>(id, std::move(component));
+                        }
+                    }
+                    adds.make_empty();
+                }
+
+                void clear() override {
+                    adds.make_empty();
+                }
+
+                core::Vector<std::pair<Target, T>> adds;
+        };
+
+        struct TagCommands {
+            Tag tag;
+            core::Vector<Target> targets;
+        };
+
+        template<typename T>
+        ComponentCommands<T>& component_commands() {
+            const ComponentTypeIndex type = type_index<T>();
+            _components.set_min_size(type + 1);
+            if(!_components[type]) {
+                _components[type] = std::make_unique<ComponentCommands<T>>();
+            }
+            return *static_cast<ComponentCommands<T>*>(_components[type].get());
+        }
+
+        static core::Vector<Target>& tag_targets(core::Vector<TagCommands>& commands, Tag tag);
+
+        void create_entities(EntityWorld& world);
+        void add_tags(EntityWorld& world);
+        void remove_components(EntityWorld& world);
+        void remove_tags(EntityWorld& world);
+        void remove_entities(EntityWorld& world);
+
+        u32 _pending_count = 0;
+        usize _component_add_count = 0;
+
+        core::Vector<std::unique_ptr<ComponentCommandsBase>> _components;
+        core::Vector<std::pair<ComponentTypeIndex, EntityId>> _component_removals;
+
+        core::Vector<TagCommands> _tag_adds;
+        core::Vector<TagCommands> _tag_removals;
+
+        core::Vector<EntityId> _entity_removals;
+
+        core::Vector<EntityId> _created;
+};
+
+}
+}
+
+#endif // YAVE_ECS_COMMANDBUFFER_H
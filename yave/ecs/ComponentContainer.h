@@ -25,10 +25,13 @@ SOFTWARE.
 #include "ecs.h"
 #include "SparseComponentSet.h"
 #include "ComponentRuntimeInfo.h"
+#include "ComponentGroup.h"
 
 Y_TODO(try replacing this?)
 #include <y/serde3/archives.h>
 
+#include <atomic>
+
 namespace yave {
 namespace ecs {
 
@@ -47,6 +50,15 @@ class ComponentBoxBase : NonMovable {
         virtual void add_to(EntityWorld& world, EntityId id) const = 0;
         // virtual void add_or_replace_to(EntityWorld& world, EntityId id) const = 0;
 
+        // Same as runtime_info().type_id, but much cheaper
+        virtual ComponentTypeIndex type_id() const = 0;
+
+        // Adds a copy of the component to every entity
+        virtual void add_to(EntityWorld& world, core::Span<EntityId> ids) const = 0;
+
+        // Adds the component of each box to the matching entity, all boxes must have the same type as this one
+        virtual void add_each_to(EntityWorld& world, core::Span<const ComponentBoxBase*> boxes, core::Span<EntityId> ids) const = 0;
+
         y_serde3_poly_abstract_base(ComponentBoxBase)
 };
 
@@ -60,6 +72,11 @@ class ComponentBox final : public ComponentBoxBase {
         void add_to(EntityWorld& world, EntityId id) const override;
         // void add_or_replace_to(EntityWorld& world, EntityId id) const override;
 
+        ComponentTypeIndex type_id() const override;
+
+        void add_to(EntityWorld& world, core::Span<EntityId> ids) const override;
+        void add_each_to(EntityWorld& world, core::Span<const ComponentBoxBase*> boxes, core::Span<EntityId> ids) const override;
+
         const T& component() const {
             return _component;
         }
@@ -80,10 +97,20 @@ class ComponentContainerBase : NonMovable {
         virtual ComponentRuntimeInfo runtime_info() const = 0;
 
         virtual void add(EntityWorld& world, EntityId id) = 0;
+        virtual void add(EntityWorld& world, core::Span<EntityId> ids) = 0;
         virtual void remove(EntityId id) = 0;
 
+        virtual void set_min_capacity(usize capacity, SparseIdSetBase::index_type max_index) = 0;
+
         virtual std::unique_ptr<ComponentBoxBase> create_box(EntityId id) const = 0;
 
+        // Returns nullptr if the component type can not be copied
+        virtual std::unique_ptr<ComponentContainerBase> clone() const = 0;
+
+        // Replaces every component by the ones of other, which must hold the same component type.
+        // The copied components are flagged as added.
+        virtual void copy_from(const ComponentContainerBase& other) = 0;
+
 
         inline bool contains(EntityId id) const {
             return id_set().contains(id);
@@ -102,17 +129,44 @@ class ComponentContainerBase : NonMovable {
         }
 
         inline core::Span<EntityId> recently_added() const {
-            return _recently_added;
+            return _added.ids();
+        }
+
+        // Ids whose component has been added or replaced since the last tick
+        inline const SparseIdSetBase& added_set() const {
+            return _added;
+        }
+
+        // Ids whose component has been changed since the last tick
+        inline const SparseIdSetBase& changed_set() const {
+            return _changed;
+        }
+
+        inline void mark_changed(EntityId id) {
+            if(contains(id)) {
+                touch();
+                _changed.insert(id);
+            }
+        }
+
+        // True if nothing has been modified since the last time the container was copied from or into a snapshot
+        inline bool is_shared() const {
+            return _shared.load(std::memory_order_relaxed);
         }
 
 
         template<typename T, typename... Args>
         inline T& add(EntityWorld& world, EntityId id, Args&&... args) {
             auto& set = component_set_fast<T>();
-            _recently_added.emplace_back(id);
+            _added.insert(id);
+            _changed.insert(id);
             if(!set.contains_index(id.index())) {
                 add_required_components<T>(world, id);
-                return set.insert(id, y_fwd(args)...);
+                set.insert(id, y_fwd(args)...);
+                if(_group) {
+                    _group->add(id);
+                }
+                return set[id];
             } else {
                 if constexpr(sizeof...(Args)) {
                     return set[id] = T{y_fwd(args)...};
@@ -167,30 +221,64 @@ class ComponentContainerBase : NonMovable {
 
 
     protected:
-        ComponentContainerBase(ComponentTypeIndex type_id) : _type_id(type_id) {
+        ComponentContainerBase(ComponentTypeIndex type_id) : _type_id(type_id), _added(false), _changed(false) {
         }
 
         template<typename T>
         void add_required_components(EntityWorld& world, EntityId id);
 
+        virtual void swap_dense(SparseIdSetBase::index_type a, SparseIdSetBase::index_type b) = 0;
+
+        void forget_recent(EntityId id) {
+            if(_added.contains(id)) {
+                _added.erase(id);
+            }
+            if(_changed.contains(id)) {
+                _changed.erase(id);
+            }
+        }
+
+        // Every non const access goes through this: the container can't be shared with a snapshot anymore
+        void touch() {
+            if(_shared.load(std::memory_order_relaxed)) {
+                _shared.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        void mark_all_added() {
+            _added.copy_from(id_set());
+            _changed.copy_from(id_set());
+        }
+
+        ComponentGroup* _group = nullptr;
+
     private:
         friend class EntityWorld;
+        friend class ComponentGroup;
 
         void clear_recent() {
-            return _recently_added.make_empty();
+            _added.clear();
+            _changed.clear();
+        }
+
+        void set_shared() const {
+            _shared.store(true, std::memory_order_relaxed);
         }
 
     private:
         const ComponentTypeIndex _type_id;
 
-        Y_TODO(make better version of this)
-        core::Vector<EntityId> _recently_added;
+        SparseIdSet _added;
+        SparseIdSet _changed;
+
+        mutable std::atomic<bool> _shared = false;
 
 
         // Filthy hack to avoid having to cast to ComponentContainer<T> when we already know T
         template<typename T>
         inline auto& component_set_fast() {
             y_debug_assert(type_index<T>() == _type_id);
+            touch();
             return *reinterpret_cast<SparseComponentSet<T>*>(this + 1);
         }
 
@@ -217,12 +305,27 @@ class ComponentContainer final : public ComponentContainerBase {
             ComponentContainerBase::add<T>(world, id);
         }
 
+        void add(EntityWorld& world, core::Span<EntityId> ids) override {
+            for(const EntityId id : ids) {
+                ComponentContainerBase::add<T>(world, id);
+            }
+        }
+
         void remove(EntityId id) override {
             if(_components.contains(id)) {
+                if(_group) {
+                    _group->remove(id);
+                }
+                touch();
+                forget_recent(id);
                 _components.erase(id);
             }
         }
 
+        void set_min_capacity(usize capacity, SparseIdSetBase::index_type max_index) override {
+            _components.set_min_capacity(capacity, max_index);
+        }
+
         std::unique_ptr<ComponentBoxBase> create_box(EntityId id) const override {
             unused(id);
             if constexpr(std::is_copy_constructible_v<T>) {
@@ -231,6 +334,26 @@ class ComponentContainer final : public ComponentContainerBase {
             return nullptr;
         }
 
+        std::unique_ptr<ComponentContainerBase> clone() const override {
+            if constexpr(std::is_copy_constructible_v<T>) {
+                auto container = std::make_unique<ComponentContainer<T>>();
+                container->_components.copy_from(_components);
+                return container;
+            }
+            return nullptr;
+        }
+
+        void copy_from(const ComponentContainerBase& other) override {
+            y_debug_assert(other.type_id() == type_id());
+            if constexpr(std::is_copy_constructible_v<T>) {
+                touch();
+                _components.copy_from(static_cast<const ComponentContainer<T>&>(other)._components);
+                mark_all_added();
+            } else {
+                y_fatal("Component type can not be copied");
+            }
+        }
+
 
         y_no_serde3_expr(serde3::has_no_serde3_v<T>)
 
@@ -239,6 +362,11 @@ class ComponentContainer final : public ComponentContainerBase {
 
 
     private:
+        void swap_dense(SparseIdSetBase::index_type a, SparseIdSetBase::index_type b) override {
+            touch();
+            _components.swap_dense(a, b);
+        }
+
         SparseComponentSet<T> _components;
 };
 
@@ -0,0 +1,119 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "ComponentGroup.h"
+#include "ComponentContainer.h"
+
+#include <algorithm>
+
+namespace yave {
+namespace ecs {
+
+ComponentGroup::ComponentGroup(core::Span<ComponentTypeIndex> types) : _types(types.begin(), types.end()) {
+    y_always_assert(!_types.is_empty(), "Component group can not be empty");
+}
+
+core::Span<ComponentTypeIndex> ComponentGroup::types() const {
+    return _types;
+}
+
+core::Span<EntityId> ComponentGroup::ids() const {
+    if(_containers.is_empty()) {
+        return {};
+    }
+    return core::Span<EntityId>(_containers[0]->ids().data(), _size);
+}
+
+usize ComponentGroup::size() const {
+    return _size;
+}
+
+bool ComponentGroup::owns(const SparseIdSetBase* set) const {
+    return std::any_of(_containers.begin(), _containers.end(), [=](const ComponentContainerBase* container) { return &container->id_set() == set; });
+}
+
+bool ComponentGroup::matches(core::Span<ComponentTypeIndex> types) const {
+    usize count = 0;
+    for(const ComponentTypeIndex type : types) {
+        if(type == invalid_type_index) {
+            continue;
+        }
+        if(std::find(_types.begin(), _types.end(), type) == _types.end()) {
+            return false;
+        }
+        ++count;
+    }
+    return count == _types.size();
+}
+
+void ComponentGroup::attach(core::Span<ComponentContainerBase*> containers) {
+    y_debug_assert(containers.size() == _types.size());
+
+    _containers = core::Vector<ComponentContainerBase*>(containers.begin(), containers.end());
+    _size = 0;
+
+    for(ComponentContainerBase* container : _containers) {
+        y_always_assert(!container->_group || container->_group == this, "Component is already part of a group");
+        container->_group = this;
+    }
+
+    // add only ever moves ids that have already been visited, so we can iterate by index while packing
+    const SparseIdSetBase& first = _containers[0]->id_set();
+    for(usize i = 0; i != first.size(); ++i) {
+        add(first.ids()[i]);
+    }
+}
+
+void ComponentGroup::add(EntityId id) {
+    y_debug_assert(!_containers.is_empty());
+
+    if(_containers[0]->id_set().dense_index_of(id) < _size) {
+        return;
+    }
+
+    for(const ComponentContainerBase* container : _containers) {
+        if(!container->contains(id)) {
+            return;
+        }
+    }
+
+    for(ComponentContainerBase* container : _containers) {
+        container->swap_dense(container->id_set().dense_index_of(id), SparseIdSetBase::index_type(_size));
+    }
+    ++_size;
+}
+
+void ComponentGroup::remove(EntityId id) {
+    y_debug_assert(!_containers.is_empty());
+
+    if(_containers[0]->id_set().dense_index_of(id) >= _size) {
+        return;
+    }
+
+    --_size;
+    for(ComponentContainerBase* container : _containers) {
+        container->swap_dense(container->id_set().dense_index_of(id), SparseIdSetBase::index_type(_size));
+    }
+}
+
+}
+}
@@ -0,0 +1,71 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ECS_COMPONENTGROUP_H
+#define YAVE_ECS_COMPONENTGROUP_H
+
+#include "SparseComponentSet.h"
+
+namespace yave {
+namespace ecs {
+
+// Entities that have every component of a group are kept at the front of each of the group's sets, in the same order.
+// Queries on exactly the components of a group can then read all of them at the same dense index, without going through the sparse arrays.
+// Adding or removing a component of the group moves the group's components around: pointers to them are invalidated.
+class ComponentGroup : NonMovable {
+    public:
+        ComponentGroup(core::Span<ComponentTypeIndex> types);
+
+        core::Span<ComponentTypeIndex> types() const;
+
+        // Entities that have every component of the group, in the order of their components in the group's sets
+        core::Span<EntityId> ids() const;
+
+        usize size() const;
+
+        bool owns(const SparseIdSetBase* set) const;
+
+        // Returns true if the group contains exactly the given components (invalid indices are ignored)
+        bool matches(core::Span<ComponentTypeIndex> types) const;
+
+        static constexpr ComponentTypeIndex invalid_type_index = ComponentTypeIndex(-1);
+
+    private:
+        friend class EntityWorld;
+        friend class ComponentContainerBase;
+
+        template<typename T>
+        friend class ComponentContainer;
+
+        void attach(core::Span<ComponentContainerBase*> containers);
+
+        void add(EntityId id);
+        void remove(EntityId id);
+
+        core::Vector<ComponentTypeIndex> _types;
+        core::Vector<ComponentContainerBase*> _containers;
+        usize _size = 0;
+};
+
+}
+}
+
+#endif // YAVE_ECS_COMPONENTGROUP_H
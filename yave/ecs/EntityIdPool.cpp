@@ -54,6 +54,18 @@ EntityId EntityIdPool::create() {
     return _ids[index];
 }
 
+void EntityIdPool::create(core::MutableSpan<EntityId> ids) {
+    usize i = 0;
+    for(; i != ids.size() && !_free.is_empty(); ++i) {
+        ids[i] = create();
+    }
+
+    _ids.set_min_capacity(_ids.size() + (ids.size() - i));
+    for(; i != ids.size(); ++i) {
+        const usize index = _ids.size();
+        ids[i] = _ids.emplace_back(EntityId(u32(index)));
+    }
+}
 
 void EntityIdPool::recycle(EntityId id) {
     y_debug_assert(contains(id));
@@ -39,6 +39,8 @@ class EntityIdPool {
         EntityIdPool() = default;
         EntityIdPool(EntityIdPool&&) = default;
         EntityIdPool& operator=(EntityIdPool&&) = default;
+        EntityIdPool(const EntityIdPool&) = default;
+        EntityIdPool& operator=(const EntityIdPool&) = default;
 
         usize size() const;
         bool contains(EntityId id) const;
@@ -48,6 +50,9 @@ class EntityIdPool {
         EntityId create();
         void recycle(EntityId id);
 
+        // Fills ids with new ids: free ones are reused first, the others are allocated as a contiguous block
+        void create(core::MutableSpan<EntityId> ids);
+
 
         auto ids() const {
             return core::Range(
@@ -21,13 +21,17 @@ SOFTWARE.
 **********************************/
 
 #include "EntityWorld.h"
-
+#include "EntityScene.h"
 
 #include <y/utils/log.h>
 #include <y/utils/format.h>
 
 #include <yave/assets/AssetLoadingContext.h>
 
+#include <y/concurrent/TaskGraph.h>
+
+#include <algorithm>
+
 
 namespace yave {
 namespace ecs {
@@ -49,6 +53,61 @@ static auto create_component_containers() {
     return containers;
 }
 
+static SparseIdSetBase::index_type max_index(core::Span<EntityId> ids) {
+    SparseIdSetBase::index_type max = 0;
+    for(const EntityId id : ids) {
+        max = std::max(max, id.index());
+    }
+    return max;
+}
+
+// Runs systems that don't conflict concurrently, conflicting ones keep their registration order
+template<typename F>
+static void run_system_batch(core::Span<std::unique_ptr<System>> systems, F&& func) {
+    if(systems.size() <= 1) {
+        for(auto& system : systems) {
+            func(*system);
+        }
+        return;
+    }
+
+    concurrent::TaskGraph graph;
+    for(usize i = 0; i != systems.size(); ++i) {
+        graph.add_node([&, i] { func(*systems[i]); });
+        for(usize j = 0; j != i; ++j) {
+            if(systems[j]->conflicts_with(*systems[i])) {
+                graph.add_edge(j, i);
+            }
+        }
+    }
+
+    graph.run();
+    graph.wait();
+}
+
+// Exclusive systems split the list into batches and run on the calling thread
+template<typename F>
+static void run_systems(core::Span<std::unique_ptr<System>> systems, F&& func) {
+    usize begin = 0;
+    while(begin != systems.size()) {
+        usize end = begin;
+        while(end != systems.size() && !systems[end]->is_exclusive()) {
+            ++end;
+        }
+
+        run_system_batch(core::Span<std::unique_ptr<System>>(systems.data() + begin, end - begin), func);
+
+        if(end != systems.size()) {
+            func(*systems[end++]);
+        }
+
+        begin = end;
+    }
+}
+
+
+
+
 EntityWorld::EntityWorld() : _containers(create_component_containers()) {
 }
 
@@ -76,6 +135,12 @@ void EntityWorld::swap(EntityWorld& other) {
         std::swap(_required_components, other._required_components);
         std::swap(_systems, other._systems);
         std::swap(_world_components, other._world_components);
+        std::swap(_groups, other._groups);
+        std::swap(_shared_containers, other._shared_containers);
+        update_tag_sets();
+        other.update_tag_sets();
+        ++_layout_version;
+        ++other._layout_version;
     }
     for(const ComponentTypeIndex c : _required_components) {
         unused(c);
@@ -85,10 +150,10 @@ void EntityWorld::swap(EntityWorld& other) {
 
 void EntityWorld::tick() {
     y_profile();
-    for(auto& system : _systems) {
-        y_profile_dyn_zone(system->name().data());
-        system->tick(*this);
-    }
+    run_systems(_systems, [this](System& system) {
+        y_profile_dyn_zone(system.name().data());
+        system.tick(*this);
+    });
     for(auto& container : _containers) {
         if(container) {
             container->clear_recent();
@@ -98,11 +163,11 @@ void EntityWorld::tick() {
 
 void EntityWorld::update(float dt) {
     y_profile();
-    for(auto& system : _systems) {
-        y_profile_dyn_zone(system->name().data());
-        system->update(*this, dt);
-        system->schedule_fixed_update(*this, dt);
-    }
+    run_systems(_systems, [this, dt](System& system) {
+        y_profile_dyn_zone(system.name().data());
+        system.update(*this, dt);
+        system.schedule_fixed_update(*this, dt);
+    });
 }
 
 usize EntityWorld::entity_count() const {
@@ -145,6 +210,112 @@ EntityId EntityWorld::create_entity(const EntityPrefab& prefab) {
     return id;
 }
 
+core::Vector<EntityId> EntityWorld::create_entities(usize count) {
+    y_profile();
+
+    core::Vector<EntityId> ids(count, EntityId());
+    _entities.create(ids);
+
+    const SparseIdSetBase::index_type max = max_index(ids);
+    for(const ComponentTypeIndex c : _required_components) {
+        ComponentContainerBase* container = find_container(c);
+        y_debug_assert(container && container->type_id() == c);
+        container->set_min_capacity(container->ids().size() + count, max);
+        container->add(*this, ids);
+    }
+    return ids;
+}
+
+core::Vector<EntityId> EntityWorld::create_entities(const EntityPrefab& prefab, usize count) {
+    y_profile();
+
+    core::Vector<EntityId> ids = create_entities(count);
+
+    const SparseIdSetBase::index_type max = max_index(ids);
+    for(const auto& comp : prefab.components()) {
+        if(!comp) {
+            log_msg("Unable to add null component", Log::Error);
+        } else {
+            ComponentContainerBase* container = find_container(comp->type_id());
+            container->set_min_capacity(container->ids().size() + count, max);
+            comp->add_to(*this, ids);
+        }
+    }
+    return ids;
+}
+
+core::Vector<EntityId> EntityWorld::instantiate(const EntityScene& scene) {
+    y_profile();
+
+    const core::Span<EntityPrefab> prefabs = scene.prefabs();
+    core::Vector<EntityId> ids = create_entities(prefabs.size());
+    const SparseIdSetBase::index_type max = max_index(ids);
+
+    struct Component {
+        ComponentTypeIndex type;
+        EntityId id;
+        const ComponentBoxBase* box;
+    };
+
+    core::Vector<Component> components;
+    core::Vector<usize> offsets;
+    core::Vector<const ComponentBoxBase*> boxes;
+    core::Vector<EntityId> targets;
+
+    // Prefabs are processed by chunks, so that their boxes are still in cache when their components are added
+    static constexpr usize chunk_size = 1024;
+    for(usize chunk = 0; chunk < prefabs.size(); chunk += chunk_size) {
+        const usize chunk_end = std::min(prefabs.size(), chunk + chunk_size);
+
+        components.make_empty();
+        offsets.make_empty();
+        offsets.set_min_size(_containers.size() + 1, usize(0));
+        for(usize i = chunk; i != chunk_end; ++i) {
+            for(const auto& comp : prefabs[i].components()) {
+                if(!comp) {
+                    log_msg("Unable to add null component", Log::Error);
+                    continue;
+                }
+
+                const ComponentTypeIndex type = comp->type_id();
+                components.emplace_back(Component{type, ids[i], comp.get()});
+                offsets.set_min_size(type + 2, usize(0));
+                ++offsets[type + 1];
+            }
+        }
+
+        // Components are bucketed by type so that each type is added in one go
+        for(usize i = 1; i < offsets.size(); ++i) {
+            offsets[i] += offsets[i - 1];
+        }
+
+        boxes.make_empty();
+        boxes.set_min_size(components.size(), nullptr);
+        targets.make_empty();
+        targets.set_min_size(components.size(), EntityId());
+        for(const Component& comp : components) {
+            const usize index = offsets[comp.type]++;
+            boxes[index] = comp.box;
+            targets[index] = comp.id;
+        }
+
+        // offsets[type] is now the end of the bucket of type
+        usize begin = 0;
+        for(usize type = 0; type + 1 < offsets.size(); ++type) {
+            const usize end = offsets[type];
+            const usize count = end - begin;
+            if(count) {
+                ComponentContainerBase* container = find_container(ComponentTypeIndex(type));
+                container->set_min_capacity(container->ids().size() + count, max);
+                boxes[begin]->add_each_to(*this, core::Span<const ComponentBoxBase*>(boxes.data() + begin, count), core::Span<EntityId>(targets.data() + begin, count));
+            }
+            begin = end;
+        }
+    }
+
+    return ids;
+}
+
 void EntityWorld::remove_entity(EntityId id) {
     check_exists(id);
     for(auto& container : _containers) {
@@ -191,67 +362,212 @@ core::Span<EntityId> EntityWorld::recently_added(ComponentTypeIndex type_id) con
     return find_container(type_id)->recently_added();
 }
 
-core::Span<EntityId> EntityWorld::with_tag(const core::String& tag) const {
+core::Span<EntityId> EntityWorld::with_tag(Tag tag) const {
     const SparseIdSetBase* set = tag_set(tag);
     return set ? set->ids() : core::Span<EntityId>();
 }
 
-const SparseIdSet* EntityWorld::raw_tag_set(const core::String& tag) const {
-    if(const auto it = _tags.find(tag); it != _tags.end()) {
-        return &it->second;
-    }
-    return nullptr;
+const SparseIdSet* EntityWorld::raw_tag_set(Tag tag) const {
+    y_debug_assert(!tag.is_implicit());
+    return tag.id() < _tag_sets.size() ? _tag_sets[tag.id()] : nullptr;
 }
 
-const SparseIdSetBase* EntityWorld::tag_set(const core::String& tag) const {
-    if(tag.is_empty()) {
-        return nullptr;
+SparseIdSet* EntityWorld::raw_tag_set(Tag tag) {
+    y_debug_assert(!tag.is_implicit());
+    return tag.id() < _tag_sets.size() ? _tag_sets[tag.id()] : nullptr;
+}
+
+SparseIdSet& EntityWorld::create_tag_set(Tag tag) {
+    if(SparseIdSet* set = raw_tag_set(tag)) {
+        return *set;
     }
 
-    if(tag[0] == '@') {
-        for(const auto& container : _containers) {
-            if(container->runtime_info().clean_component_name() == tag.sub_str(1)) {
-                return &container->id_set();
-            }
+    _tags.insert({core::String(tag.name()), SparseIdSet()});
+    update_tag_sets();
+    ++_layout_version;
+
+    SparseIdSet* set = raw_tag_set(tag);
+    y_debug_assert(set);
+    return *set;
+}
+
+// Inserting in or erasing from _tags can move all the sets around
+void EntityWorld::update_tag_sets() {
+    _tag_sets.make_empty();
+    for(auto& [name, set] : _tags) {
+        const Tag tag(name);
+        if(tag.is_valid() && !tag.is_implicit()) {
+            _tag_sets.set_min_size(tag.id() + 1, nullptr);
+            _tag_sets[tag.id()] = &set;
         }
+    }
+}
+
+const SparseIdSetBase* EntityWorld::tag_set(Tag tag) const {
+    if(!tag.is_valid()) {
         return nullptr;
     }
 
-    if(tag[0] == '!') {
+    if(tag.is_negated()) {
         y_fatal("'!' tags can't have a set, use queries instead");
     }
 
+    if(tag.is_component()) {
+        return tag.id() < _containers.size() && _containers[tag.id()] ? &_containers[tag.id()]->id_set() : nullptr;
+    }
+
     return raw_tag_set(tag);
 }
 
-void EntityWorld::add_tag(EntityId id, const core::String& tag) {
+void EntityWorld::add_tag(EntityId id, Tag tag) {
     check_exists(id);
-    y_always_assert(!is_tag_implicit(tag), "Implicit tags can't be added directly");
-    _tags[tag].insert(id);
+    y_always_assert(tag.is_valid() && !tag.is_implicit(), "Implicit tags can't be added directly");
+    create_tag_set(tag).insert(id);
 }
 
-void EntityWorld::remove_tag(EntityId id, const core::String& tag) {
+void EntityWorld::remove_tag(EntityId id, Tag tag) {
     check_exists(id);
-    y_always_assert(!is_tag_implicit(tag), "Implicit tags can't be removed directly");
-    auto& tag_set = _tags[tag];
-    if(tag_set.contains(id)) {
-        tag_set.erase(id);
+    y_always_assert(!tag.is_implicit(), "Implicit tags can't be removed directly");
+    if(SparseIdSet* set = raw_tag_set(tag); set && set->contains(id)) {
+        set->erase(id);
     }
 }
 
-void EntityWorld::clear_tag(const core::String& tag) {
-    y_always_assert(!is_tag_implicit(tag), "Implicit tags can't be removed directly");
-    _tags.erase(tag);
+void EntityWorld::clear_tag(Tag tag) {
+    y_always_assert(!tag.is_implicit(), "Implicit tags can't be removed directly");
+    if(raw_tag_set(tag)) {
+        _tags.erase(core::String(tag.name()));
+        update_tag_sets();
+    }
+    ++_layout_version;
 }
 
-bool EntityWorld::has_tag(EntityId id, const core::String& tag) const {
+bool EntityWorld::has_tag(EntityId id, Tag tag) const {
     check_exists(id);
     const SparseIdSetBase* set = tag_set(tag);
     return set ? set->contains(id) : false;
 }
 
-bool EntityWorld::is_tag_implicit(std::string_view tag) {
-    return !tag.empty() && (tag[0] == '@' || tag[0] == '!');
+const ComponentGroup& EntityWorld::add_component_group(core::Span<ComponentTypeIndex> types) {
+    auto& group = _groups.emplace_back(std::make_unique<ComponentGroup>(types));
+    attach_group(*group);
+    return *group;
+}
+
+void EntityWorld::attach_group(ComponentGroup& group) {
+    core::Vector<ComponentContainerBase*> containers;
+    for(const ComponentTypeIndex type : group.types()) {
+        containers << find_container(type);
+    }
+    group.attach(containers);
+}
+
+WorldSnapshot EntityWorld::snapshot(SnapshotMode mode) const {
+    y_profile();
+
+    WorldSnapshot snapshot;
+    snapshot._entities = _entities;
+
+    snapshot._containers.set_min_size(_containers.size());
+    _shared_containers.set_min_size(_containers.size());
+    for(usize i = 0; i != _containers.size(); ++i) {
+        const ComponentContainerBase* container = _containers[i].get();
+        if(!container) {
+            continue;
+        }
+
+        if(mode == SnapshotMode::CopyOnWrite && container->is_shared()) {
+            if(auto shared = _shared_containers[i].lock()) {
+                snapshot._containers[i] = std::move(shared);
+                continue;
+            }
+        }
+
+        std::shared_ptr<const ComponentContainerBase> copy = container->clone();
+        if(copy) {
+            _shared_containers[i] = copy;
+            container->set_shared();
+        }
+        snapshot._containers[i] = std::move(copy);
+    }
+
+    for(const auto& [tag, set] : _tags) {
+        auto& [name, copy] = snapshot._tags.emplace_back(tag, SparseIdSet());
+        unused(name);
+        copy.copy_from(set);
+    }
+
+    for(const auto& group : _groups) {
+        snapshot._group_sizes << group->size();
+    }
+
+    return snapshot;
+}
+
+void EntityWorld::restore(const WorldSnapshot& snapshot) {
+    y_profile();
+
+    // Components that can't be copied stay where they are, as long as their entity still exists
+    // This has to be done first, while the groups are still consistent with the containers
+    for(usize i = 0; i != _containers.size(); ++i) {
+        ComponentContainerBase* container = _containers[i].get();
+        if(container && (i >= snapshot._containers.size() || !snapshot._containers[i])) {
+            core::Vector<EntityId> removed;
+            for(const EntityId id : container->ids()) {
+                if(!snapshot._entities.contains(id)) {
+                    removed << id;
+                }
+            }
+            for(const EntityId id : removed) {
+                container->remove(id);
+            }
+        }
+    }
+
+    _shared_containers.set_min_size(_containers.size());
+    for(usize i = 0; i != std::min(_containers.size(), snapshot._containers.size()); ++i) {
+        ComponentContainerBase* container = _containers[i].get();
+        const auto& copy = snapshot._containers[i];
+        if(!container || !copy) {
+            continue;
+        }
+
+        // Untouched since it was copied into this snapshot: nothing to do
+        if(container->is_shared() && _shared_containers[i].lock() == copy) {
+            continue;
+        }
+
+        container->copy_from(*copy);
+        _shared_containers[i] = copy;
+        container->set_shared();
+    }
+
+    for(auto& [tag, set] : _tags) {
+        unused(tag);
+        set.clear();
+    }
+    for(const auto& [tag, set] : snapshot._tags) {
+        _tags[tag].copy_from(set);
+    }
+    update_tag_sets();
+
+    _entities = snapshot._entities;
+
+    // Restored sets are in the order they were in when the snapshot was taken, so are the groups
+    for(usize i = 0; i != _groups.size(); ++i) {
+        ComponentGroup& group = *_groups[i];
+        const bool restored = i < snapshot._group_sizes.size() && std::all_of(group.types().begin(), group.types().end(), [&](ComponentTypeIndex type) {
+            return type < snapshot._containers.size() && snapshot._containers[type];
+        });
+
+        if(restored) {
+            group._size = snapshot._group_sizes[i];
+        } else {
+            attach_group(group);
+        }
+    }
+
+    ++_layout_version;
 }
 
 core::Span<ComponentTypeIndex> EntityWorld::required_components() const {
@@ -289,6 +605,12 @@ void EntityWorld::post_deserialize() {
         }
     }
     _containers = std::move(patched);
+    update_tag_sets();
+    ++_layout_version;
+
+    for(auto& group : _groups) {
+        attach_group(*group);
+    }
 
     for(auto& system : _systems) {
         y_debug_assert(system);
@@ -24,19 +24,25 @@ SOFTWARE.
 
 #include "EntityIdPool.h"
 #include "Query.h"
+#include "ComponentGroup.h"
 #include "Archetype.h"
 #include "EntityPrefab.h"
 #include "System.h"
 #include "tags.h"
+#include "WorldSnapshot.h"
 
 #include "WorldComponentContainer.h"
 #include "ComponentContainer.h"
 
 #include <y/core/ScratchPad.h>
 
+#include <mutex>
+
 namespace yave {
 namespace ecs {
 
+class EntityScene;
+
 class EntityWorld {
     public:
         EntityWorld();
@@ -57,6 +63,13 @@ class EntityWorld {
         EntityId create_entity(const Archetype& archetype);
         EntityId create_entity(const EntityPrefab& prefab);
 
+        // Batch versions of create_entity: ids are allocated as a block and containers only grow once
+        core::Vector<EntityId> create_entities(usize count);
+        core::Vector<EntityId> create_entities(const EntityPrefab& prefab, usize count);
+
+        // Creates one entity per prefab of the scene, ids are returned in the same order as the prefabs
+        core::Vector<EntityId> instantiate(const EntityScene& scene);
+
         void remove_entity(EntityId id);
 
         EntityId id_from_index(u32 index) const;
@@ -66,9 +79,9 @@ class EntityWorld {
         core::Span<EntityId> component_ids(ComponentTypeIndex type_id) const;
         core::Span<EntityId> recently_added(ComponentTypeIndex type_id) const;
 
-        core::Span<EntityId> with_tag(const core::String& tag) const;
+        core::Span<EntityId> with_tag(Tag tag) const;
 
-        const SparseIdSetBase* tag_set(const core::String& tag) const;
+        const SparseIdSetBase* tag_set(Tag tag) const;
 
         core::Span<ComponentTypeIndex> required_components() const;
 
@@ -143,15 +156,13 @@ class EntityWorld {
 
         // ---------------------------------------- Components ----------------------------------------
 
-        void add_tag(EntityId id, const core::String& tag);
-
-        void remove_tag(EntityId id, const core::String& tag);
+        void add_tag(EntityId id, Tag tag);
 
-        void clear_tag(const core::String& tag);
+        void remove_tag(EntityId id, Tag tag);
 
-        bool has_tag(EntityId id, const core::String& tag) const;
+        void clear_tag(Tag tag);
 
-        static bool is_tag_implicit(std::string_view tag);
+        bool has_tag(EntityId id, Tag tag) const;
 
         // ---------------------------------------- Enumerations ----------------------------------------
 
@@ -264,34 +275,45 @@ class EntityWorld {
             return recently_added(type_index<T>());
         }
 
+        // Flags the component as changed for this tick, for use with Changed<T> queries.
+        // Only adding or replacing a component flags it automatically: code that modifies a component in place should call this.
+        template<typename T>
+        void mark_changed(EntityId id) {
+            find_container<T>()->mark_changed(id);
+        }
+
 
 
         // ---------------------------------------- Queries ----------------------------------------
 
         template<typename... Args>
-        auto query(core::Span<core::String> tags = {}) {
-            const auto sets = typed_component_sets_or_none<Args...>();
-            return Query<Args...>(sets, build_id_sets_for_query(sets, tags));
+        auto query(core::Span<Tag> tags = {}) {
+            Query<Args...> query;
+            touch_mutable<Args...>();
+            match_query(query, tags);
+            return query;
         }
 
         template<typename... Args>
-        auto query(core::Span<core::String> tags = {}) const {
+        auto query(core::Span<Tag> tags = {}) const {
             static_assert((traits::is_component_const_v<Args> && ...));
-            const auto sets = typed_component_sets_or_none<Args...>();
-            return Query<Args...>(sets, build_id_sets_for_query(sets, tags));
+            Query<Args...> query;
+            match_query(query, tags);
+            return query;
         }
 
         template<typename... Args>
-        auto query(core::Span<EntityId> ids, core::Span<core::String> tags = {}) {
+        auto query(core::Span<EntityId> ids, core::Span<Tag> tags = {}) {
+            touch_mutable<Args...>();
             const auto sets = typed_component_sets_or_none<Args...>();
-            return Query<Args...>(sets, build_id_sets_for_query(sets, tags), ids);
+            return Query<Args...>(sets, build_id_sets_for_query<Args...>(sets, tags), ids);
         }
 
         template<typename... Args>
-        auto query(core::Span<EntityId> ids, core::Span<core::String> tags = {}) const {
+        auto query(core::Span<EntityId> ids, core::Span<Tag> tags = {}) const {
             static_assert((traits::is_component_const_v<Args> && ...));
             const auto sets = typed_component_sets_or_none<Args...>();
-            return Query<Args...>(sets, build_id_sets_for_query(sets, tags), ids);
+            return Query<Args...>(sets, build_id_sets_for_query<Args...>(sets, tags), ids);
         }
 
         template<typename... Args>
@@ -304,6 +326,52 @@ class EntityWorld {
             return query<Args...>();
         }
 
+        // Cached queries are kept by the world and only matched again when a component or tag set they use changes.
+        // The returned query is a view of the cached match list, nothing is copied. It is only valid until the same cached query
+        // is requested again after one of those sets has changed (adding or removing components or tags), which asserts in debug.
+        template<typename... Args>
+        Query<Args...> cached_query(core::Span<Tag> tags = {}) {
+            touch_mutable<Args...>();
+            return find_cached_query<Args...>(tags);
+        }
+
+        template<typename... Args>
+        Query<Args...> cached_query(core::Span<Tag> tags = {}) const {
+            static_assert((traits::is_component_const_v<Args> && ...));
+            return find_cached_query<Args...>(tags);
+        }
+
+
+
+        // ---------------------------------------- Groups ----------------------------------------
+
+        // Keeps entities that have all of Args packed together, see ComponentGroup
+        template<typename... Args>
+        const ComponentGroup& add_component_group() {
+            static_assert(sizeof...(Args) != 0);
+            const std::array<ComponentTypeIndex, sizeof...(Args)> types = {find_container<Args>()->type_id()...};
+            return add_component_group(types);
+        }
+
+        const ComponentGroup& add_component_group(core::Span<ComponentTypeIndex> types);
+
+        core::Span<std::unique_ptr<ComponentGroup>> component_groups() const {
+            return _groups;
+        }
+
+
+
+        // ---------------------------------------- Snapshots ----------------------------------------
+
+        // Copies the entities, components and tags of the world. Systems and world components are not part of the snapshot.
+        // In CopyOnWrite mode, containers that haven't been modified since the last snapshot or restore are shared instead of copied.
+        WorldSnapshot snapshot(SnapshotMode mode = SnapshotMode::Copy) const;
+
+        // Brings the entities, components and tags back to the state of the snapshot.
+        // Restored components are flagged as added so systems pick them up on the next tick.
+        // Components that can't be copied are only removed from entities that don't exist in the snapshot.
+        void restore(const WorldSnapshot& snapshot);
+
 
 
         // ---------------------------------------- Misc ----------------------------------------
@@ -330,6 +398,11 @@ class EntityWorld {
         template<typename T>
         friend class ComponentContainer;
 
+        template<typename T>
+        friend class ComponentBox;
+
+        friend class CommandBuffer;
+
 
         template<typename T>
         const ComponentContainerBase* find_container() const {
@@ -355,10 +428,11 @@ class EntityWorld {
             } else {
                 // We need non consts here and we want to avoir returning non const everywhere else
                 // This shouldn't be UB as component containers are never const
+                // Going through the const set avoids unsharing the container for read only queries, mutable ones are unshared by touch_mutable
                 using component_type = traits::component_raw_type_t<T>;
-                ComponentContainerBase* container = const_cast<ComponentContainerBase*>(find_container<component_type>());
+                const ComponentContainerBase* container = find_container<component_type>();
                 y_debug_assert(container);
-                return std::tuple{&container->component_set<component_type>()};
+                return std::tuple{const_cast<SparseComponentSet<component_type>*>(&container->component_set<component_type>())};
             }
         }
 
@@ -371,23 +445,121 @@ class EntityWorld {
             }
         }
 
-        template<typename T>
-        auto build_id_sets_for_query(const T& sets, core::Span<core::String> tags) const {
+        template<typename... Args, typename T>
+        auto build_id_sets_for_query(const T& sets, core::Span<Tag> tags) const {
             const usize set_count = std::tuple_size_v<T>;
             core::ScratchPad<QueryUtils::SetMatch> matches(set_count + tags.size());
-            QueryUtils::fill_match_array(matches, sets);
+            QueryUtils::fill_match_array<Args...>(matches, sets);
+            if constexpr(((traits::component_filter_v<Args> != traits::ComponentFilter::None) || ...)) {
+                usize i = 0;
+                ((apply_filter<Args>(matches[i++])), ...);
+            }
             for(usize i = 0; i != tags.size(); ++i) {
-                const bool is_neg = tags[i].starts_with("!");
                 matches[set_count + i] = {
-                    tag_set(is_neg ? core::String(tags[i].sub_str(1)) : tags[i]),
-                    !is_neg
+                    tag_set(tags[i].positive()),
+                    !tags[i].is_negated()
                 };
             }
             return matches;
         }
 
 
-        const SparseIdSet* raw_tag_set(const core::String& tag) const;
+        // Added and Changed only match the subset of the component set that was touched this tick
+        template<typename T>
+        void apply_filter(QueryUtils::SetMatch& match) const {
+            constexpr traits::ComponentFilter filter = traits::component_filter_v<T>;
+            if constexpr(filter != traits::ComponentFilter::None) {
+                const ComponentContainerBase* container = find_container<traits::component_raw_type_t<T>>();
+                match.set = filter == traits::ComponentFilter::Added ? &container->added_set() : &container->changed_set();
+            }
+        }
+
+        // Queries with Mutate access can write to their components, so the containers can't stay shared with a snapshot
+        template<typename... Args>
+        void touch_mutable() {
+            ((traits::is_component_const_v<Args> ? void() : find_container<traits::component_raw_type_t<Args>>()->touch()), ...);
+        }
+
+        template<typename... Args>
+        void match_query(Query<Args...>& query, core::Span<Tag> tags, CachedQueryBase* cached = nullptr) const {
+            const auto sets = typed_component_sets_or_none<Args...>();
+            auto matches = build_id_sets_for_query<Args...>(sets, tags);
+
+            query._sets = sets;
+            if(const ComponentGroup* group = find_group<Args...>()) {
+                // Sets owned by the group are already accounted for by its packed ids
+                const auto filters = std::partition(matches.begin(), matches.end(), [=](const auto& match) { return match.include && group->owns(match.set); });
+                query.match_packed(group->ids(), core::Span<QueryUtils::SetMatch>(filters, usize(matches.end() - filters)));
+            } else {
+                query.match(matches);
+            }
+
+            if(cached) {
+                cached->set_up_to_date(matches, _layout_version);
+            }
+        }
+
+        template<typename... Args>
+        const ComponentGroup* find_group() const {
+            if(_groups.is_empty()) {
+                return nullptr;
+            }
+
+            const std::array<ComponentTypeIndex, sizeof...(Args)> required = {
+                (traits::component_required_v<Args> ? type_index<traits::component_raw_type_t<Args>>() : ComponentGroup::invalid_type_index)...
+            };
+            for(const auto& group : _groups) {
+                if(group->matches(required)) {
+                    return group.get();
+                }
+            }
+            return nullptr;
+        }
+
+        template<typename... Args>
+        Query<Args...> find_cached_query(core::Span<Tag> tags) const {
+            using cached_type = CachedQuery<Args...>;
+
+            u64 key = cached_type::type;
+            for(const Tag tag : tags) {
+                hash_combine(key, (u64(tag.id()) << 2) | (u64(tag.is_component()) << 1) | u64(tag.is_negated()));
+            }
+
+            const std::unique_lock lock(_cached_queries_lock);
+
+            // Queries with colliding keys share a bucket
+            auto& bucket = _cached_queries[key];
+
+            cached_type* cached = nullptr;
+            for(const auto& query : bucket) {
+                if(query->matches(cached_type::type, tags)) {
+                    y_debug_assert(dynamic_cast<cached_type*>(query.get()));
+                    cached = static_cast<cached_type*>(query.get());
+                    break;
+                }
+            }
+
+            if(!cached) {
+                auto query = std::make_unique<cached_type>(tags);
+                cached = query.get();
+                bucket.emplace_back(std::move(query));
+            }
+
+            if(!cached->is_up_to_date(_layout_version)) {
+                match_query(cached->_query, tags, cached);
+            }
+
+            return cached->_query.view(*cached);
+        }
+
+
+        const SparseIdSet* raw_tag_set(Tag tag) const;
+        SparseIdSet* raw_tag_set(Tag tag);
+
+        SparseIdSet& create_tag_set(Tag tag);
+        void update_tag_sets();
+
+        void attach_group(ComponentGroup& group);
 
         const ComponentContainerBase* find_container(ComponentTypeIndex type_id) const;
         ComponentContainerBase* find_container(ComponentTypeIndex type_id);
@@ -397,12 +569,27 @@ class EntityWorld {
 
         core::Vector<std::unique_ptr<ComponentContainerBase>> _containers;
         core::FlatHashMap<core::String, SparseIdSet> _tags;
+
+        // Sets of _tags indexed by tag id, rebuilt every time a tag set is created or destroyed
+        core::Vector<SparseIdSet*> _tag_sets;
         EntityIdPool _entities;
 
         core::Vector<ComponentTypeIndex> _required_components;
 
         core::Vector<std::unique_ptr<System>> _systems;
         core::Vector<std::unique_ptr<WorldComponentContainerBase>> _world_components;
+
+        // Changes when sets are created, destroyed or moved, which invalidates the pointers held by cached queries
+        u64 _layout_version = 0;
+
+        core::Vector<std::unique_ptr<ComponentGroup>> _groups;
+
+        // Last snapshot copy of each container, reused by copy on write snapshots while the container is still shared
+        mutable core::Vector<std::weak_ptr<const ComponentContainerBase>> _shared_containers;
+
+        // Keyed by a hash of the query type and tags
+        mutable core::FlatHashMap<u64, core::Vector<std::unique_ptr<CachedQueryBase>>> _cached_queries;
+        mutable std::mutex _cached_queries_lock;
 };
 
 }
@@ -77,6 +77,29 @@ void ComponentBox<T>::add_to(EntityWorld& world, EntityId id) const {
     world.add_component<T>(id, _component);
 }
 
+template<typename T>
+ComponentTypeIndex ComponentBox<T>::type_id() const {
+    return type_index<T>();
+}
+
+template<typename T>
+void ComponentBox<T>::add_to(EntityWorld& world, core::Span<EntityId> ids) const {
+    ComponentContainerBase* container = world.find_container<T>();
+    for(const EntityId id : ids) {
+        container->template add<T>(world, id, _component);
+    }
+}
+
+template<typename T>
+void ComponentBox<T>::add_each_to(EntityWorld& world, core::Span<const ComponentBoxBase*> boxes, core::Span<EntityId> ids) const {
+    y_debug_assert(boxes.size() == ids.size());
+    ComponentContainerBase* container = world.find_container<T>();
+    for(usize i = 0; i != ids.size(); ++i) {
+        y_debug_assert(boxes[i]->type_id() == type_index<T>());
+        container->template add<T>(world, ids[i], static_cast<const ComponentBox<T>*>(boxes[i])->_component);
+    }
+}
+
 }
 }
 
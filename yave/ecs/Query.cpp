@@ -22,16 +22,114 @@ SOFTWARE.
 
 #include "Query.h"
 
+#include <y/core/ScratchPad.h>
+
 #include <y/utils/log.h>
 #include <y/utils/format.h>
 
+#include <algorithm>
+
 namespace yave {
 namespace ecs {
 
+// Ids are matched by blocks: each rule filters the ids of the block that passed the previous ones, in place.
+// This keeps the inner loops tight and free of unpredictable branches.
+static constexpr usize block_size = 256;
+
+// Returns the position of the id in the dense array, or invalid_index.
+// Lookups that can't be done are redirected to index 0, which exists since the set isn't empty, and masked out afterward.
+static inline u32 dense_index(const QueryUtils::BatchMatch& match, u32 index) {
+    static constexpr u32 invalid_index = SparseIdSetBase::invalid_index;
+    const auto [page, offset] = PagedSparseArray::page_index(index);
+    if(match.presence) {
+        // Tag sets are small: their bitset is much more likely to be in cache than their sparse array
+        const bool in_range = index < match.presence_size;
+        const bool present = in_range && ((match.presence[in_range ? index / 64 : 0] >> (index % 64)) & 1);
+        const u32 dense = match.pages[present ? page : 0][offset];
+        return present ? dense : invalid_index;
+    }
+    // Pages that aren't allocated point to a page of invalid indices, so only the page table needs a bound check
+    const bool in_range = page < match.page_count;
+    const u32 dense = match.pages[in_range ? page : 0][offset];
+    return in_range ? dense : invalid_index;
+}
+
+static usize filter_block(const QueryUtils::BatchMatch& match, EntityId* selection, usize count) {
+    if(match.is_empty) {
+        return match.include ? 0 : count;
+    }
+
+    usize kept = 0;
+    for(usize i = 0; i != count; ++i) {
+        const EntityId id = selection[i];
+        const u32 index = dense_index(match, id.index());
+        const bool found = index != SparseIdSetBase::invalid_index;
+        const bool contained = found & (match.dense[found ? index : 0] == id);
+        selection[kept] = id;
+        kept += contained == match.include;
+    }
+    return kept;
+}
+
+QueryUtils::BatchMatch QueryUtils::batch_match(const SetMatch& match) {
+    y_debug_assert(match.set);
+
+    const SparseIdSetBase& set = *match.set;
+    BatchMatch batch;
+    batch.pages = set._sparse.pages().data();
+    batch.page_count = set._sparse.pages().size();
+    batch.dense = set._dense.data();
+    batch.include = match.include;
+    batch.is_empty = set._dense.is_empty();
+    if(!set._presence.is_empty()) {
+        batch.presence = set._presence.data();
+        batch.presence_size = set._presence.size() * 64;
+    }
+    return batch;
+}
+
 core::Vector<EntityId> QueryUtils::matching(core::Span<SetMatch> matches, core::Span<EntityId> ids) {
+    core::Vector<EntityId> match;
+    matching(matches, ids, match);
+    return match;
+}
+
+void QueryUtils::matching(core::Span<SetMatch> matches, core::Span<EntityId> ids, core::Vector<EntityId>& match) {
+    y_profile();
+
+    match.make_empty();
+
+    core::ScratchPad<BatchMatch> batches(matches.size());
+    usize batch_count = 0;
+    for(const SetMatch& m : matches) {
+        if(!m.set) {
+            if(m.include) {
+                // Nothing can match a missing set
+                return;
+            }
+            continue;
+        }
+        batches[batch_count++] = batch_match(m);
+    }
+
+    match.set_min_capacity(ids.size());
+
+    EntityId selection[block_size];
+    for(usize i = 0; i < ids.size(); i += block_size) {
+        usize count = std::min(block_size, ids.size() - i);
+        std::copy_n(ids.data() + i, count, selection);
+        for(usize k = 0; count && k != batch_count; ++k) {
+            count = filter_block(batches[k], selection, count);
+        }
+        match.push_back(selection, selection + count);
+    }
+}
+
+void QueryUtils::matching_scalar(core::Span<SetMatch> matches, core::Span<EntityId> ids, core::Vector<EntityId>& match) {
     y_profile();
 
-    auto match = core::vector_with_capacity<EntityId>(ids.size());
+    match.make_empty();
+    match.set_min_capacity(ids.size());
     for(EntityId id : ids) {
         bool matched = true;
         for(usize i = 0; matched && i != matches.size(); ++i) {
@@ -42,10 +140,7 @@ core::Vector<EntityId> QueryUtils::matching(core::Span<SetMatch> matches, core::
             match.push_back(id);
         }
     }
-
-    return match;
 }
-
 }
 }
 
@@ -24,8 +24,14 @@ SOFTWARE.
 
 #include "traits.h"
 #include "SparseComponentSet.h"
+#include "tags.h"
+
+#include <y/concurrent/parallel.h>
+
+#include <y/core/String.h>
 
 #include <y/utils/iter.h>
+#include <y/utils/hash.h>
 
 #include <y/utils/log.h>
 
@@ -74,27 +80,94 @@ struct QueryUtils {
         }
     };
 
+    // Ids are matched by blocks, one rule at a time, without branching on the individual lookups
     static core::Vector<EntityId> matching(core::Span<SetMatch> matches, core::Span<EntityId> ids);
+    static void matching(core::Span<SetMatch> matches, core::Span<EntityId> ids, core::Vector<EntityId>& match);
+
+    // Reference implementation, one id at a time. Gives the same result as matching.
+    static void matching_scalar(core::Span<SetMatch> matches, core::Span<EntityId> ids, core::Vector<EntityId>& match);
 
-    template<usize I = 0, typename T>
+    // Args are needed to know which sets are required: the set tuple only has the raw component types
+    template<typename... Args, typename T>
     static void fill_match_array(core::MutableSpan<SetMatch> matches, const T& sets) {
-        if constexpr(I < std::tuple_size_v<T>) {
-            matches[I] = {
-                std::get<I>(sets),
-                traits::component_required_v<std::tuple_element_t<I, T>>
-            };
-            fill_match_array<I + 1>(matches, sets);
-        }
+        static_assert(sizeof...(Args) == std::tuple_size_v<T>);
+        const std::array<bool, sizeof...(Args)> required = {traits::component_required_v<Args>...};
+        std::apply([&](auto*... set) {
+            usize i = 0;
+            ((matches[i] = {set, required[i]}, ++i), ...);
+        }, sets);
     }
 
-    template<typename T>
+    template<typename... Args, typename T>
     static auto create_match_array(const T& sets) {
         std::array<SetMatch, std::tuple_size_v<T>> matches = {};
-        fill_match_array(matches, sets);
+        fill_match_array<Args...>(matches, sets);
         return matches;
     }
+
+    // Raw view of a set used by the batched matching
+    struct BatchMatch {
+        const SparseIdSetBase::index_type* const* pages = nullptr;
+        usize page_count = 0;
+        const EntityId* dense = nullptr;
+        const u64* presence = nullptr;
+        usize presence_size = 0;
+        bool include = true;
+        bool is_empty = true;
+    };
+
+    private:
+        static BatchMatch batch_match(const SetMatch& match);
+};
+
+
+class CachedQueryBase : NonMovable {
+    public:
+        virtual ~CachedQueryBase() = default;
+
+        // Incremented every time the query is matched again, which invalidates the views of the previous match
+        u64 generation() const {
+            return _generation.load(std::memory_order_acquire);
+        }
+
+    protected:
+        friend class EntityWorld;
+
+        CachedQueryBase(u64 type, core::Span<Tag> tags) : _type(type), _tags(tags.begin(), tags.end()) {
+        }
+
+        bool matches(u64 type, core::Span<Tag> tags) const {
+            return _type == type && std::equal(_tags.begin(), _tags.end(), tags.begin(), tags.end());
+        }
+
+        bool is_up_to_date(u64 layout_version) const {
+            if(layout_version != _layout_version) {
+                return false;
+            }
+            return std::all_of(_versions.begin(), _versions.end(), [](const auto& v) { return v.first->version() == v.second; });
+        }
+
+        void set_up_to_date(core::Span<QueryUtils::SetMatch> matches, u64 layout_version) {
+            _generation.fetch_add(1, std::memory_order_release);
+            _layout_version = layout_version;
+            _versions.make_empty();
+            for(const auto& match : matches) {
+                if(match.set) {
+                    _versions.emplace_back(match.set, match.set->version());
+                }
+            }
+        }
+
+    private:
+        u64 _type = 0;
+        core::Vector<Tag> _tags;
+        core::Vector<std::pair<const SparseIdSetBase*, u64>> _versions;
+        u64 _layout_version = u64(-1);
+        std::atomic<u64> _generation = 0;
 };
 
+template<typename... Args>
+class CachedQuery;
 
 template<typename... Args>
 class Query : NonCopyable {
@@ -103,25 +176,30 @@ class Query : NonCopyable {
     using all_components = std::tuple<traits::component_type_t<Args>...>;
 
     static constexpr bool is_empty = sizeof...(Args) == 0;
+    static constexpr bool is_parallel_safe = (traits::is_component_parallel_safe_v<Args> && ...);
     static constexpr std::array component_included = {traits::component_required_v<Args>..., false};
 
+    static constexpr u32 unpacked_index = u32(-1);
+
+    // Packed queries read every component at the same dense index (see ComponentGroup)
     template<usize I = 0>
-    static auto make_component_tuple(const set_tuple& sets, EntityId id) {
+    static auto make_component_tuple(const set_tuple& sets, EntityId id, u32 dense_index) {
         if constexpr(!component_included[I]) {
             return std::tie();
         } else {
             y_debug_assert(std::get<I>(sets));
             auto&& s = *std::get<I>(sets);
-            std::tuple<std::tuple_element_t<I, all_components>&> tpl = std::tie(s[id]);
+            y_debug_assert(dense_index == unpacked_index || s.ids()[dense_index] == id);
+            std::tuple<std::tuple_element_t<I, all_components>&> tpl = std::tie(dense_index == unpacked_index ? s[id] : s.values()[dense_index]);
             if constexpr(I + 1 == sizeof...(Args)) {
                 return tpl;
             } else {
-                return std::tuple_cat(tpl, make_component_tuple<I + 1>(sets, id));
+                return std::tuple_cat(tpl, make_component_tuple<I + 1>(sets, id, dense_index));
             }
         }
     }
     public:
-        using component_tuple = decltype(make_component_tuple(set_tuple{}, EntityId{}));
+        using component_tuple = decltype(make_component_tuple(set_tuple{}, EntityId{}, 0));
 
         class IdComponents {
             public:
@@ -150,14 +228,14 @@ class Query : NonCopyable {
 
     private:
         struct IdComponentsReturnPolicy {
-            inline static decltype(auto) make(EntityId id, const set_tuple& sets) {
-                return IdComponents(id, make_component_tuple(sets, id));
+            inline static decltype(auto) make(EntityId id, u32 dense_index, const set_tuple& sets) {
+                return IdComponents(id, make_component_tuple(sets, id, dense_index));
             }
         };
 
         struct ComponentsReturnPolicy {
-            inline static component_tuple make(EntityId id, const set_tuple& sets) {
-                return make_component_tuple(sets, id);
+            inline static component_tuple make(EntityId id, u32 dense_index, const set_tuple& sets) {
+                return make_component_tuple(sets, id, dense_index);
             }
         };
 
@@ -168,12 +246,15 @@ class Query : NonCopyable {
 
                 inline Iterator& operator++() {
                     ++_it;
+                    if(_index) {
+                        ++_index;
+                    }
                     return *this;
                 }
 
                 inline Iterator operator++(int) {
                     const Iterator it = *this;
-                    ++_it;
+                    operator++();
                     return it;
                 }
 
@@ -187,16 +268,17 @@ class Query : NonCopyable {
 
                 inline auto operator*() const {
                     y_debug_assert(_it && _it->is_valid());
-                    return ReturnPolicy::make(*_it, _sets);
+                    return ReturnPolicy::make(*_it, _index ? *_index : unpacked_index, _sets);
                 }
 
             private:
                 friend class Query;
 
-                inline Iterator(const EntityId* it, const set_tuple& sets) : _it(it), _sets(sets) {
+                inline Iterator(const EntityId* it, const u32* index, const set_tuple& sets) : _it(it), _index(index), _sets(sets) {
                 }
 
                 const EntityId* _it = nullptr;
+                const u32* _index = nullptr;
                 set_tuple _sets;
         };
 
@@ -207,15 +289,16 @@ class Query : NonCopyable {
         using const_component_iterator = Iterator<ComponentsReturnPolicy>;
 
         const_iterator begin() const {
-            return const_iterator(_ids.begin(), _sets);
+            return const_iterator(matched_ids().begin(), dense_index(0), _sets);
         }
 
         const_iterator end() const {
-            return const_iterator(_ids.end(), _sets);
+            const core::Span<EntityId> ids = matched_ids();
+            return const_iterator(ids.end(), dense_index(ids.size()), _sets);
         }
 
         usize size() const {
-            return _ids.size();
+            return matched_ids().size();
         }
 
         // These have lifetime problems when writing:
@@ -224,30 +307,66 @@ class Query : NonCopyable {
         // We can kinda work around this using ref-qualifiers to make sure the Query is an lvalue.
         // const& doesn't work here sadly (because it makes query<A>().ids() valid again)
         core::Range<const_iterator> id_components() & {
-            return {const_iterator(_ids.begin(), _sets), const_iterator(_ids.end(), _sets)};
+            return {begin(), end()};
         }
 
         core::Range<const_component_iterator> components() & {
-            return {const_component_iterator(_ids.begin(), _sets), const_component_iterator(_ids.end(), _sets)};
+            const core::Span<EntityId> ids = matched_ids();
+            return {const_component_iterator(ids.begin(), dense_index(0), _sets), const_component_iterator(ids.end(), dense_index(ids.size()), _sets)};
         }
 
         core::Span<EntityId> ids() & {
-            return _ids;
+            return matched_ids();
         }
 
         core::Vector<EntityId> ids() && {
+            if(_view_of) {
+                return core::Vector<EntityId>(matched_ids());
+            }
             return std::move(_ids);
         }
 
+        // True if the query only points to the match list of a cached query, see EntityWorld::cached_query
+        bool is_view() const {
+            return _view_of;
+        }
+
+        // Returns the [begin, end) sub-range of the matched entities
+        core::Range<const_iterator> chunk(usize begin, usize end) & {
+            const core::Span<EntityId> ids = matched_ids();
+            y_debug_assert(begin <= end && end <= ids.size());
+            return {const_iterator(ids.begin() + begin, dense_index(begin), _sets), const_iterator(ids.begin() + end, dense_index(end), _sets)};
+        }
+
+        // Calls func(chunk) on contiguous chunks of at least grain entities, from several threads at once.
+        // Returns once every chunk has been processed.
+        template<typename F>
+        void for_each_chunk_parallel(F&& func, usize grain = default_grain) & {
+            static_assert(is_parallel_safe, "Query mutates components that can not be mutated in parallel");
+            concurrent::parallel_for_chunks(0, size(), grain, [&](usize b, usize e) {
+                func(chunk(b, e));
+            });
+        }
+
+        template<typename F>
+        void for_each_parallel(F&& func, usize grain = default_grain) & {
+            for_each_chunk_parallel([&](core::Range<const_iterator> range) {
+                for(auto id_comp : range) {
+                    func(id_comp);
+                }
+            }, grain);
+        }
+
+        static constexpr usize default_grain = 256;
+
     private:
         friend class EntityWorld;
+        friend class CachedQuery<Args...>;
+
+        Query() = default;
 
         Query(const set_tuple& sets, core::MutableSpan<QueryUtils::SetMatch> matches) : _sets(sets) {
-            if(!matches.is_empty() && std::all_of(matches.begin(), matches.end(), [](auto match) { return !match.is_empty(); })) {
-                std::sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) { return a.sorting_key() < b.sorting_key(); });
-                y_always_assert(matches[0].include, "Query needs at least one inclusive matching rule");
-                _ids = QueryUtils::matching(core::Span<QueryUtils::SetMatch>(matches.begin() + 1, matches.size() - 1), matches[0].ids());
-            }
+            match(matches);
         }
 
         Query(const set_tuple& sets, core::MutableSpan<QueryUtils::SetMatch> matches, core::Span<EntityId> range)  : _sets(sets) {
@@ -257,10 +376,59 @@ class Query : NonCopyable {
             }
         }
 
-        Query(const set_tuple& sets) : Query(sets, QueryUtils::create_match_array(sets)) {
+        // Reuses the storage of _ids, so matching again doesn't allocate once the query has been run
+        void match(core::MutableSpan<QueryUtils::SetMatch> matches) {
+            _ids.make_empty();
+            _dense_indices.make_empty();
+            if(!matches.is_empty() && std::all_of(matches.begin(), matches.end(), [](auto match) { return !match.is_empty(); })) {
+                std::sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) { return a.sorting_key() < b.sorting_key(); });
+                y_always_assert(matches[0].include, "Query needs at least one inclusive matching rule");
+                QueryUtils::matching(core::Span<QueryUtils::SetMatch>(matches.begin() + 1, matches.size() - 1), matches[0].ids(), _ids);
+            }
+        }
+
+        // packed are the ids of a group that owns exactly the required components, filters are the remaining matching rules
+        void match_packed(core::Span<EntityId> packed, core::Span<QueryUtils::SetMatch> filters) {
+            y_profile();
+
+            _ids.make_empty();
+            _dense_indices.make_empty();
+            _ids.set_min_capacity(packed.size());
+            _dense_indices.set_min_capacity(packed.size());
+            for(usize i = 0; i != packed.size(); ++i) {
+                const EntityId id = packed[i];
+                if(std::all_of(filters.begin(), filters.end(), [=](const auto& match) { return match.contains(id); })) {
+                    _ids.push_back(id);
+                    _dense_indices.push_back(u32(i));
+                }
+            }
+        }
+
+        core::Span<EntityId> matched_ids() const {
+            y_debug_assert(!_view_of || _view_of->generation() == _view_generation); // The cached query has been matched again
+            return _view_of ? _view_ids : core::Span<EntityId>(_ids);
         }
 
-        Query(const set_tuple& sets, core::Span<EntityId> range) : Query(sets, QueryUtils::create_match_array(sets), range) {
+        const u32* dense_index(usize i) const {
+            const core::Span<u32> indices = _view_of ? _view_dense_indices : core::Span<u32>(_dense_indices);
+            return indices.is_empty() ? nullptr : indices.data() + i;
+        }
+
+        // Points to the match lists of this query without copying them, only valid until cached is matched again
+        Query view(const CachedQueryBase& cached) const {
+            Query query;
+            query._sets = _sets;
+            query._view_of = &cached;
+            query._view_generation = cached.generation();
+            query._view_ids = _ids;
+            query._view_dense_indices = _dense_indices;
+            return query;
+        }
+
+        Query(const set_tuple& sets) : Query(sets, QueryUtils::create_match_array<Args...>(sets)) {
+        }
+
+        Query(const set_tuple& sets, core::Span<EntityId> range) : Query(sets, QueryUtils::create_match_array<Args...>(sets), range) {
         }
 
     private:
@@ -268,7 +436,32 @@ class Query : NonCopyable {
 
         core::Vector<EntityId> _ids;
 
+        // Position of the components of each id in their sets for packed queries, empty otherwise
+        core::Vector<u32> _dense_indices;
+
+        // Views of a cached query use these instead of _ids and _dense_indices
+        const CachedQueryBase* _view_of = nullptr;
+        u64 _view_generation = 0;
+        core::Span<EntityId> _view_ids;
+        core::Span<u32> _view_dense_indices;
+
+
+};
+
+
+// Query owned by the world, only matched again when one of the sets it depends on has changed
+template<typename... Args>
+class CachedQuery final : public CachedQueryBase {
+    public:
+        static constexpr u64 type = ct_type_hash_v<Query<Args...>>;
+
+        CachedQuery(core::Span<Tag> tags) : CachedQueryBase(type, tags) {
+        }
+
+    private:
+        friend class EntityWorld;
 
+        Query<Args...> _query;
 };
 
 }
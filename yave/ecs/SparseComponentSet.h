@@ -30,6 +30,8 @@ SOFTWARE.
 
 #include <tuple>
 #include <iterator>
+#include <array>
+#include <memory>
 
 // #define YAVE_ECS_COMPONENT_SET_AUDIT
 
@@ -37,20 +39,180 @@ SOFTWARE.
 namespace yave {
 namespace ecs {
 
-class SparseIdSetBase : NonCopyable {
+struct QueryUtils;
 
+// Maps entity indices to positions in a dense array.
+// Storage is split in pages that are only allocated for the ranges of indices in use:
+// missing pages all point to the same read-only page of invalid indices, and pages are freed when they become empty.
+class PagedSparseArray : NonCopyable {
     public:
         using index_type = u32;
-        using size_type = usize;
 
         static constexpr index_type invalid_index = index_type(-1);
 
+        static constexpr usize page_shift = 10;
+        static constexpr usize page_size = usize(1) << page_shift;
+        static constexpr usize page_mask = page_size - 1;
+
+        PagedSparseArray() = default;
+
+        PagedSparseArray(PagedSparseArray&& other) {
+            swap(other);
+        }
+
+        PagedSparseArray& operator=(PagedSparseArray&& other) {
+            swap(other);
+            return *this;
+        }
+
+        ~PagedSparseArray() {
+            clear();
+        }
+
+        static std::pair<usize, usize> page_index(index_type index) {
+            return {usize(index >> page_shift), usize(index & page_mask)};
+        }
+
+        // Returns invalid_index for indices past the last page
+        index_type operator[](index_type index) const {
+            const auto [page, offset] = page_index(index);
+            return page < _pages.size() ? _pages[page][offset] : invalid_index;
+        }
+
+        void set(index_type index, index_type value) {
+            y_debug_assert(value != invalid_index);
+
+            const auto [page, offset] = page_index(index);
+            grow(index);
+            if(!_counts[page]) {
+                allocate_page(page);
+            }
+
+            index_type& slot = mutable_page(page)[offset];
+            _counts[page] += (slot == invalid_index);
+            slot = value;
+        }
+
+        void reset(index_type index) {
+            const auto [page, offset] = page_index(index);
+            y_debug_assert(page < _pages.size() && _counts[page]);
+
+            index_type& slot = mutable_page(page)[offset];
+            y_debug_assert(slot != invalid_index);
+            slot = invalid_index;
+
+            if(!--_counts[page]) {
+                release_page(page);
+            }
+        }
+
+        // Only grows the page table, pages are allocated on first write
+        void grow(index_type max_index) {
+            const usize page_count = page_index(max_index).first + 1;
+            if(page_count > _pages.size()) {
+                _pages.set_min_size(page_count, empty_page());
+                _counts.set_min_size(page_count, u32(0));
+            }
+        }
+
+        void clear() {
+            for(usize i = 0; i != _pages.size(); ++i) {
+                if(_counts[i]) {
+                    release_page(i);
+                }
+            }
+            _pages.clear();
+            _counts.clear();
+        }
+
+        // Only copies the pages that are allocated
+        void copy_from(const PagedSparseArray& other) {
+            clear();
+            _pages.assign(other._pages.begin(), other._pages.end());
+            _counts.assign(other._counts.begin(), other._counts.end());
+            for(usize i = 0; i != _pages.size(); ++i) {
+                if(_counts[i]) {
+                    index_type* data = new index_type[page_size];
+                    std::copy_n(other._pages[i], page_size, data);
+                    _pages[i] = data;
+                }
+            }
+            _allocated_pages = other._allocated_pages;
+        }
+
+        void swap(PagedSparseArray& other) {
+            _pages.swap(other._pages);
+            _counts.swap(other._counts);
+            std::swap(_allocated_pages, other._allocated_pages);
+        }
+
+        core::Span<const index_type*> pages() const {
+            return _pages;
+        }
+
+        usize allocated_pages() const {
+            return _allocated_pages;
+        }
+
+        usize memory_usage() const {
+            return _pages.size() * (sizeof(const index_type*) + sizeof(u32)) + _allocated_pages * page_size * sizeof(index_type);
+        }
+
+    private:
+        static const index_type* empty_page() {
+            static const std::array<index_type, page_size> page = [] {
+                std::array<index_type, page_size> p = {};
+                p.fill(invalid_index);
+                return p;
+            }();
+            return page.data();
+        }
+
+        // Only valid for allocated pages: the empty page is never written to
+        index_type* mutable_page(usize page) {
+            y_debug_assert(_pages[page] != empty_page());
+            return const_cast<index_type*>(_pages[page]);
+        }
+
+        void allocate_page(usize page) {
+            y_debug_assert(_pages[page] == empty_page());
+            index_type* data = new index_type[page_size];
+            std::fill_n(data, page_size, invalid_index);
+            _pages[page] = data;
+            ++_allocated_pages;
+        }
+
+        void release_page(usize page) {
+            y_debug_assert(_pages[page] != empty_page());
+            delete[] _pages[page];
+            _pages[page] = empty_page();
+            _counts[page] = 0;
+            --_allocated_pages;
+        }
+
+        core::Vector<const index_type*> _pages;
+
+        // Number of valid indices in each page, 0 for pages that aren't allocated
+        core::Vector<u32> _counts;
+
+        usize _allocated_pages = 0;
+};
+
+class SparseIdSetBase : NonCopyable {
+
+    public:
+        using index_type = PagedSparseArray::index_type;
+        using size_type = usize;
+
+        static constexpr index_type invalid_index = PagedSparseArray::invalid_index;
+
         bool contains(EntityId id) const {
-            return contains_index(id.index()) && _dense[_sparse[id.index()]] == id;
+            const index_type dense_index = _sparse[id.index()];
+            return dense_index != invalid_index && _dense[dense_index] == id;
         }
 
         bool contains_index(index_type index) const {
-            return index < _sparse.size() && _sparse[index] != invalid_index;
+            return _sparse[index] != invalid_index;
         }
 
         usize size() const {
@@ -70,20 +232,46 @@ class SparseIdSetBase : NonCopyable {
         }
 
         index_type dense_index_of(index_type index) const {
-            return index < _sparse.size() ? _sparse[index] : invalid_index;
+            return _sparse[index];
         }
 
         const SparseIdSetBase& smallest(const SparseIdSetBase& other) const {
             return size() < other.size() ? *this : other;
         }
 
+        // Changes every time ids are added or removed, used to know when cached queries are stale
+        u64 version() const {
+            return _version;
+        }
+
+        // One bit per entity index, set if the index is in the set. Only tag sets maintain it, it is empty otherwise.
+        // It covers every index up to the highest one ever inserted and never shrinks.
+        core::Span<u64> presence_bits() const {
+            return _presence;
+        }
+
+        // Memory used to map entity indices to dense indices, in bytes
+        usize sparse_memory_usage() const {
+            return _sparse.memory_usage();
+        }
+
     protected:
+        friend struct QueryUtils;
+
         void grow_sparse(index_type max_index) {
-            _sparse.set_min_size(usize(max_index + 1), invalid_index);
+            _sparse.grow(max_index);
+        }
+
+        void copy_ids(const SparseIdSetBase& other) {
+            _dense.assign(other._dense.begin(), other._dense.end());
+            _sparse.copy_from(other._sparse);
+            ++_version;
         }
 
         core::Vector<EntityId> _dense;
-        core::Vector<index_type> _sparse;
+        PagedSparseArray _sparse;
+        core::Vector<u64> _presence;
+        u64 _version = 0;
 };
 
 
@@ -91,13 +279,24 @@ class SparseIdSet : public SparseIdSetBase {
     public:
         using value_type = ecs::EntityId;
 
+        SparseIdSet() = default;
+
+        // Sets that are never matched as tags (like the added and changed sets of containers) can skip the presence bits,
+        // which cost a bit per entity index
+        explicit SparseIdSet(bool track_presence) : _track_presence(track_presence) {
+        }
+
         void insert(EntityId id) {
             if(!contains(id)) {
                 const index_type index = id.index();
-                grow_sparse(index);
-
-                _sparse[index] = index_type(_dense.size());
+                _sparse.set(index, index_type(_dense.size()));
                 _dense.emplace_back(id);
+                ++_version;
+
+                if(_track_presence) {
+                    _presence.set_min_size(usize(index / 64 + 1), u64(0));
+                    _presence[index / 64] |= u64(1) << (index % 64);
+                }
             }
         }
 
@@ -116,13 +315,50 @@ class SparseIdSet : public SparseIdSetBase {
             _dense.pop();
 
             const index_type last_sparse_index = last.index();
-            _sparse[last_sparse_index] = dense_index;
-            _sparse[index] = invalid_index;
+            _sparse.set(last_sparse_index, dense_index);
+            _sparse.reset(index);
+            ++_version;
 
+            if(_track_presence) {
+                _presence[index / 64] &= ~(u64(1) << (index % 64));
+            }
 
             y_debug_assert(!contains(id));
         }
 
+        // Component sets don't track presence, it is rebuilt from the ids when copying one
+        void copy_from(const SparseIdSetBase& other) {
+            copy_ids(other);
+            _presence.make_empty();
+            if(!_track_presence) {
+                return;
+            }
+
+            const core::Span<u64> presence = other.presence_bits();
+            if(!presence.is_empty()) {
+                _presence.assign(presence.begin(), presence.end());
+            } else {
+                for(const EntityId id : _dense) {
+                    const index_type index = id.index();
+                    _presence.set_min_size(usize(index / 64 + 1), u64(0));
+                    _presence[index / 64] |= u64(1) << (index % 64);
+                }
+            }
+        }
+
+        // Only touches the slots of the ids in the set, not the whole sparse array
+        void clear() {
+            for(const EntityId id : _dense) {
+                const index_type index = id.index();
+                _sparse.reset(index);
+                if(_track_presence) {
+                    _presence[index / 64] &= ~(u64(1) << (index % 64));
+                }
+            }
+            _dense.make_empty();
+            ++_version;
+        }
+
         auto begin() const {
             return ids().begin();
         }
@@ -138,6 +374,9 @@ class SparseIdSet : public SparseIdSetBase {
         auto end() {
             return ids().end();
         }
+
+    private:
+        bool _track_presence = true;
 };
 
 static_assert(is_iterable_v<SparseIdSet>);
@@ -240,12 +479,10 @@ class SparseComponentSetBase : public SparseIdSetBase {
         reference insert(EntityId id, Args&&... args) {
             y_debug_assert(!contains(id));
 
-            const index_type index = id.index();
-            grow_sparse(index);
-
-            _sparse[index] = index_type(_dense.size());
+            _sparse.set(id.index(), index_type(_dense.size()));
             _dense.emplace_back(id);
             _values.emplace_back(y_fwd(args)...);
+            ++_version;
 
             audit();
 
@@ -273,8 +510,9 @@ class SparseComponentSetBase : public SparseIdSetBase {
             _values.pop();
 
             const index_type last_sparse_index = last.index();
-            _sparse[last_sparse_index] = dense_index;
-            _sparse[index] = invalid_index;
+            _sparse.set(last_sparse_index, dense_index);
+            _sparse.reset(index);
+            ++_version;
 
             audit();
 
@@ -293,41 +531,67 @@ class SparseComponentSetBase : public SparseIdSetBase {
         }
 
         pointer try_get(EntityId id) {
-            const index_type index = id.index();
-            if(index >= _sparse.size()) {
-                return nullptr;
-            }
-            const index_type pi = _sparse[index];
+            const index_type pi = _sparse[id.index()];
             return pi < _values.size() ? &_values[pi] : nullptr;
         }
 
         const_pointer try_get(EntityId id) const {
-            const index_type index = id.index();
-            if(index >= _sparse.size()) {
-                return nullptr;
-            }
-            const index_type pi = _sparse[index];
+            const index_type pi = _sparse[id.index()];
             return pi < _values.size() ? &_values[pi] : nullptr;
         }
 
+        // Exchanges the positions of two elements in the dense arrays
+        void swap_dense(index_type a, index_type b) {
+            y_debug_assert(a < _dense.size() && b < _dense.size());
+            if(a == b) {
+                return;
+            }
+
+            std::swap(_dense[a], _dense[b]);
+            std::swap(_values[a], _values[b]);
+            _sparse.set(_dense[a].index(), a);
+            _sparse.set(_dense[b].index(), b);
+            ++_version;
+
+            audit();
+        }
+
         void set_min_capacity(usize cap) {
             _values.set_min_capacity(cap);
             _dense.set_min_capacity(cap);
         }
 
+        // Also grows the sparse array so that inserting ids up to max_index doesn't reallocate it
+        void set_min_capacity(usize cap, index_type max_index) {
+            set_min_capacity(cap);
+            grow_sparse(max_index);
+        }
+
         void clear() {
             _values.clear();
             _dense.clear();
             _sparse.clear();
+            ++_version;
             audit();
         }
 
 
+        // Trivially copyable components are copied as a single block
+        void copy_from(const SparseComponentSetBase& other) {
+            if(&other != this) {
+                copy_ids(other);
+                _values.assign(other._values.begin(), other._values.end());
+            }
+            audit();
+        }
+
         void swap(SparseComponentSetBase& v) {
             if(&v != this) {
                 _values.swap(v._values);
                 _dense.swap(v._dense);
                 _sparse.swap(v._sparse);
+                ++_version;
+                ++v._version;
             }
             audit();
         }
@@ -379,14 +643,15 @@ class SparseComponentSetBase : public SparseIdSetBase {
 #ifdef YAVE_ECS_COMPONENT_SET_AUDIT
             y_debug_assert(_dense.size() == _values.size());
             usize total = 0;
-            for(usize i = 0; i != _sparse.size(); ++i) {
-                for(usize o = 0; o != page_size; ++o) {
-                    const page_index_type index = _sparse[i][o];
-                    if(index != page_invalid_index) {
+            const core::Span<const index_type*> pages = _sparse.pages();
+            for(usize i = 0; i != pages.size(); ++i) {
+                for(usize o = 0; o != PagedSparseArray::page_size; ++o) {
+                    const index_type index = pages[i][o];
+                    if(index != invalid_index) {
                         y_debug_assert(index < _dense.size());
                         const EntityId id = _dense[index];
                         y_debug_assert(id.is_valid());
-                        y_debug_assert(page_index(id.index()) == std::pair(i, o));
+                        y_debug_assert(PagedSparseArray::page_index(id.index()) == std::pair(i, o));
                         ++total;
                     }
                 }
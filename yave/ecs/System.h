@@ -22,9 +22,10 @@ SOFTWARE.
 #ifndef YAVE_ECS_SYSTEM_H
 #define YAVE_ECS_SYSTEM_H
 
-#include <yave/ecs/ecs.h>
+#include <yave/ecs/traits.h>
 
 #include <y/core/String.h>
+#include <y/core/Vector.h>
 
 namespace yave {
 namespace ecs {
@@ -69,6 +70,44 @@ class System : NonCopyable {
             return _fixed_update_time;
         }
 
+        // Systems that didn't declare their accesses are assumed to touch everything:
+        // they never run concurrently with other systems and always run on the thread that updates the world.
+        bool is_exclusive() const {
+            return !_access_declared;
+        }
+
+        core::Span<ComponentTypeIndex> read_components() const {
+            return _read;
+        }
+
+        core::Span<ComponentTypeIndex> mutated_components() const {
+            return _mutated;
+        }
+
+        bool conflicts_with(const System& other) const {
+            if(is_exclusive() || other.is_exclusive()) {
+                return true;
+            }
+
+            const auto contains = [](core::Span<ComponentTypeIndex> types, ComponentTypeIndex type) {
+                return std::find(types.begin(), types.end(), type) != types.end();
+            };
+
+            for(const ComponentTypeIndex type : _mutated) {
+                if(contains(other._mutated, type) || contains(other._read, type)) {
+                    return true;
+                }
+            }
+
+            for(const ComponentTypeIndex type : _read) {
+                if(contains(other._mutated, type)) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
         void schedule_fixed_update(EntityWorld& world, float dt) {
             if(_fixed_update_time <= 0.0f) {
                 if(_fixed_update_time > -1.0f) {
@@ -84,10 +123,39 @@ class System : NonCopyable {
             }
         }
 
+    protected:
+        // Uses the same vocabulary as queries: declare_access<ecs::Mutate<A>, B>() means that A is written and B is only read.
+        // Systems that add or remove components or entities should not declare anything.
+        template<typename... Args>
+        void declare_access() {
+            _access_declared = true;
+            (declare_access(type_index<traits::component_raw_type_t<Args>>(), !traits::is_component_const_v<Args>), ...);
+        }
+
+        void declare_access(ComponentTypeIndex type, bool mutate) {
+            _access_declared = true;
+
+            const auto it = std::find(_read.begin(), _read.end(), type);
+            if(mutate) {
+                if(it != _read.end()) {
+                    _read.erase_unordered(it);
+                }
+                if(std::find(_mutated.begin(), _mutated.end(), type) == _mutated.end()) {
+                    _mutated << type;
+                }
+            } else if(it == _read.end() && std::find(_mutated.begin(), _mutated.end(), type) == _mutated.end()) {
+                _read << type;
+            }
+        }
+
     private:
         core::String _name;
         float _fixed_update_time = 0.0f;
         float _fixed_update_acc = 0.0f;
+
+        bool _access_declared = false;
+        core::Vector<ComponentTypeIndex> _read;
+        core::Vector<ComponentTypeIndex> _mutated;
 };
 
 }
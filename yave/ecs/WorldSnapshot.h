@@ -0,0 +1,73 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ECS_WORLDSNAPSHOT_H
+#define YAVE_ECS_WORLDSNAPSHOT_H
+
+#include "EntityIdPool.h"
+#include "SparseComponentSet.h"
+
+#include <y/core/String.h>
+
+#include <memory>
+
+namespace yave {
+namespace ecs {
+
+enum class SnapshotMode {
+    // Every component container is copied
+    Copy,
+
+    // Containers that haven't been modified since the last snapshot are shared with it
+    CopyOnWrite
+};
+
+// Copy of the entities, components and tags of an EntityWorld, see EntityWorld::snapshot and EntityWorld::restore.
+// Containers are immutable once in a snapshot, so they can be shared between snapshots and with the world.
+class WorldSnapshot : NonCopyable {
+    public:
+        WorldSnapshot() = default;
+
+        WorldSnapshot(WorldSnapshot&&) = default;
+        WorldSnapshot& operator=(WorldSnapshot&&) = default;
+
+        usize entity_count() const {
+            return _entities.size();
+        }
+
+        bool is_empty() const {
+            return _containers.is_empty();
+        }
+
+    private:
+        friend class EntityWorld;
+
+        // Indexed by component type, null for component types that can't be copied
+        core::Vector<std::shared_ptr<const ComponentContainerBase>> _containers;
+        core::Vector<std::pair<core::String, SparseIdSet>> _tags;
+        EntityIdPool _entities;
+        core::Vector<usize> _group_sizes;
+};
+
+}
+}
+
+#endif // YAVE_ECS_WORLDSNAPSHOT_H
@@ -0,0 +1,143 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "tags.h"
+#include "ComponentContainer.h"
+
+#include <y/core/HashMap.h>
+
+#include <memory>
+#include <mutex>
+
+namespace yave {
+namespace ecs {
+
+namespace {
+class TagRegistry : NonMovable {
+    public:
+        TagRegistry() {
+#define REGISTER_TAG(tag) y_always_assert(intern(#tag) == tags::detail::tag##_id, "Built-in tag registered out of order");
+            YAVE_ECS_BUILTIN_TAGS(REGISTER_TAG)
+#undef REGISTER_TAG
+        }
+
+        TagId intern(std::string_view name) {
+            const std::unique_lock lock(_lock);
+
+            const core::String key = name;
+            if(const auto it = _ids.find(key); it != _ids.end()) {
+                return it->second;
+            }
+
+            const TagId id = TagId(_names.size());
+            _names.emplace_back(std::make_unique<core::String>(key));
+            _ids.insert({key, id});
+            return id;
+        }
+
+        std::string_view name(TagId id) const {
+            const std::unique_lock lock(_lock);
+            y_debug_assert(id < _names.size());
+            return _names[id]->view();
+        }
+
+        // Component types are only listed once, the first time a component tag is used
+        ComponentTypeIndex component_type(std::string_view name) {
+            const std::unique_lock lock(_lock);
+            fill_component_types();
+
+            if(const auto it = _component_types.find(core::String(name)); it != _component_types.end()) {
+                return it->second;
+            }
+            return Tag::invalid_id;
+        }
+
+        std::string_view component_name(ComponentTypeIndex type) {
+            const std::unique_lock lock(_lock);
+            fill_component_types();
+
+            return type < _component_names.size() ? _component_names[type] : std::string_view();
+        }
+
+    private:
+        void fill_component_types() {
+            if(!_component_names.is_empty()) {
+                return;
+            }
+
+            for(const auto* poly_base = ComponentContainerBase::_y_serde3_poly_base.first; poly_base; poly_base = poly_base->next) {
+                if(poly_base->create) {
+                    const std::unique_ptr<ComponentContainerBase> container = poly_base->create();
+                    const ComponentTypeIndex type = container->type_id();
+                    const std::string_view name = container->runtime_info().clean_component_name();
+
+                    _component_names.set_min_size(type + 1);
+                    _component_names[type] = name;
+                    _component_types.insert({core::String(name), type});
+                }
+            }
+        }
+
+        mutable std::mutex _lock;
+
+        core::FlatHashMap<core::String, TagId> _ids;
+        core::Vector<std::unique_ptr<core::String>> _names;
+
+        core::FlatHashMap<core::String, ComponentTypeIndex> _component_types;
+        core::Vector<std::string_view> _component_names;
+};
+
+static TagRegistry& tag_registry() {
+    static TagRegistry registry;
+    return registry;
+}
+}
+
+
+Tag::Tag(std::string_view name) {
+    if(name.empty()) {
+        return;
+    }
+
+    if(name[0] == '!') {
+        *this = !Tag(name.substr(1));
+        return;
+    }
+
+    if(name[0] == '@') {
+        *this = from_component(tag_registry().component_type(name.substr(1)));
+        return;
+    }
+
+    _id = tag_registry().intern(name);
+}
+
+std::string_view Tag::name() const {
+    if(!is_valid()) {
+        return {};
+    }
+    return is_component() ? tag_registry().component_name(_id) : tag_registry().name(_id);
+}
+
+}
+}
+
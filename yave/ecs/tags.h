@@ -22,24 +22,114 @@ SOFTWARE.
 #ifndef YAVE_ECS_TAGS_H
 #define YAVE_ECS_TAGS_H
 
-#include <yave/yave.h>
+#include "ecs.h"
 
 #include <y/core/String.h>
 
 namespace yave {
 namespace ecs {
-namespace tags {
 
-#define DECLARE_TAG(tag)                                \
-static const core::String tag = #tag;                   \
-static const core::String not_##tag = "!"#tag;
+using TagId = u32;
+
+// Tags are interned: every tag name is given a small id, shared by all worlds, the first time it is used.
+// "!tag" matches entities without the tag and "@Component" entities with the component, neither have a set of their own.
+// Building a tag from a string has to look it up, queries that run every frame should use the constants in ecs::tags.
+class Tag {
+    public:
+        static constexpr TagId invalid_id = TagId(-1);
+
+        constexpr Tag() = default;
+
+        Tag(std::string_view name);
+
+        Tag(const core::String& name) : Tag(name.view()) {
+        }
+
+        Tag(const char* name) : Tag(std::string_view(name)) {
+        }
+
+        static constexpr Tag from_id(TagId id) {
+            return Tag(id, 0);
+        }
+
+        // For component tags, the id is the index of the component type
+        static constexpr Tag from_component(ComponentTypeIndex type) {
+            return Tag(type, component_flag);
+        }
+
+        constexpr TagId id() const {
+            return _id;
+        }
+
+        constexpr bool is_valid() const {
+            return _id != invalid_id;
+        }
+
+        constexpr bool is_negated() const {
+            return _flags & negated_flag;
+        }
+
+        constexpr bool is_component() const {
+            return _flags & component_flag;
+        }
 
+        // Implicit tags can't be added or removed directly
+        constexpr bool is_implicit() const {
+            return _flags != 0;
+        }
 
+        constexpr Tag positive() const {
+            return Tag(_id, _flags & ~negated_flag);
+        }
 
-DECLARE_TAG(hidden)
-DECLARE_TAG(selected)
+        constexpr Tag operator!() const {
+            return Tag(_id, _flags ^ negated_flag);
+        }
 
+        constexpr bool operator==(const Tag& other) const {
+            return _id == other._id && _flags == other._flags;
+        }
 
+        constexpr bool operator!=(const Tag& other) const {
+            return !operator==(other);
+        }
+
+        // Name of the tag, without any prefix
+        std::string_view name() const;
+
+    private:
+        static constexpr u32 negated_flag = 0x01;
+        static constexpr u32 component_flag = 0x02;
+
+        constexpr Tag(TagId id, u32 flags) : _id(id), _flags(flags) {
+        }
+
+        TagId _id = invalid_id;
+        u32 _flags = 0;
+};
+
+
+namespace tags {
+
+// Built-in tags have fixed ids, in declaration order
+#define YAVE_ECS_BUILTIN_TAGS(X)    \
+    X(hidden)                       \
+    X(selected)
+
+namespace detail {
+#define DECLARE_TAG_ID(tag) tag##_id,
+enum BuiltinTagId : TagId {
+    YAVE_ECS_BUILTIN_TAGS(DECLARE_TAG_ID)
+    builtin_tag_count
+};
+#undef DECLARE_TAG_ID
+}
+
+#define DECLARE_TAG(tag)                                                \
+inline constexpr Tag tag = Tag::from_id(detail::tag##_id);              \
+inline constexpr Tag not_##tag = !tag;
+
+YAVE_ECS_BUILTIN_TAGS(DECLARE_TAG)
 
 #undef DECLARE_TAG
 
@@ -49,4 +139,3 @@ DECLARE_TAG(selected)
 
 
 #endif // YAVE_ECS_TAGS_H
-
@@ -36,14 +36,30 @@ struct Mutate {};
 template<typename T>
 struct Not {};
 
+// Only matches entities whose T has been added or replaced since the last tick
+template<typename T>
+struct Added {};
+
+// Only matches entities whose T has been changed since the last tick.
+// Components are changed when added or replaced, or through EntityWorld::mark_changed. Writing to them through a query doesn't flag them.
+template<typename T>
+struct Changed {};
+
 
 
 namespace traits {
+enum class ComponentFilter {
+    None,
+    Added,
+    Changed
+};
+
 template<typename T>
 struct component_type {
     using raw_type = remove_cvref_t<T>;
     using type = const raw_type;
     static constexpr bool required = true;
+    static constexpr ComponentFilter filter = ComponentFilter::None;
 };
 
 
@@ -52,6 +68,7 @@ struct component_type<Mutate<T>> {
     using raw_type = typename component_type<T>::raw_type;
     using type = std::remove_const_t<typename component_type<T>::type>;
     static constexpr bool required = component_type<T>::required;
+    static constexpr ComponentFilter filter = component_type<T>::filter;
 };
 
 template<typename T>
@@ -59,6 +76,23 @@ struct component_type<Not<T>> {
     using raw_type = typename component_type<T>::raw_type;
     using type = typename component_type<T>::type;
     static constexpr bool required = !component_type<T>::required;
+    static constexpr ComponentFilter filter = component_type<T>::filter;
+};
+
+template<typename T>
+struct component_type<Added<T>> {
+    using raw_type = typename component_type<T>::raw_type;
+    using type = typename component_type<T>::type;
+    static constexpr bool required = component_type<T>::required;
+    static constexpr ComponentFilter filter = ComponentFilter::Added;
+};
+
+template<typename T>
+struct component_type<Changed<T>> {
+    using raw_type = typename component_type<T>::raw_type;
+    using type = typename component_type<T>::type;
+    static constexpr bool required = component_type<T>::required;
+    static constexpr ComponentFilter filter = ComponentFilter::Changed;
 };
 
 
@@ -73,8 +107,23 @@ using component_type_t = typename component_type<T>::type;
 template<typename T>
 static constexpr bool component_required_v = component_type<T>::required;
 
+template<typename T>
+static constexpr ComponentFilter component_filter_v = component_type<T>::filter;
+
 template<typename T>
 static constexpr bool is_component_const_v = std::is_const_v<typename component_type<T>::type> || !component_required_v<T>;
+
+
+// Components whose mutators touch state shared between entities can opt out of parallel mutation
+// by declaring "static constexpr bool parallel_mutation = false;"
+template<typename T, typename = void>
+struct allows_parallel_mutation : std::true_type {};
+
+template<typename T>
+struct allows_parallel_mutation<T, std::void_t<decltype(T::parallel_mutation)>> : std::bool_constant<T::parallel_mutation> {};
+
+template<typename T>
+static constexpr bool is_component_parallel_safe_v = is_component_const_v<T> || allows_parallel_mutation<component_raw_type_t<T>>::value;
 }
 
 }
@@ -90,7 +90,7 @@ static auto&& check_exists(C& c, T t) {
 }
 
 template<typename C, typename B>
-static void build_barriers(const C& resources, B& barriers, core::FlatHashMap<FrameGraphResourceId, PipelineStage>& to_barrier, FrameGraphFrameResources& frame_res) {
+static void build_barriers(const C& resources, B& barriers, memory::FlatHashMap<FrameGraphResourceId, PipelineStage>& to_barrier, FrameGraphFrameResources& frame_res) {
     for(auto&& [res, info] : resources) {
         // barrier around attachments are handled by the renderpass
         const PipelineStage stage = info.stage & ~PipelineStage::AllAttachmentOutBit;
@@ -110,7 +110,7 @@ static void build_barriers(const C& resources, B& barriers, core::FlatHashMap<Fr
 }
 
 static void copy_image(CmdBufferRecorder& recorder, FrameGraphImageId src, FrameGraphMutableImageId dst,
-                        core::FlatHashMap<FrameGraphResourceId, PipelineStage>& to_barrier, const FrameGraphFrameResources& resources) {
+                        memory::FlatHashMap<FrameGraphResourceId, PipelineStage>& to_barrier, const FrameGraphFrameResources& resources) {
 
     Y_TODO(We might end up barriering twice here)
     if(resources.are_aliased(src, dst)) {
@@ -127,7 +127,7 @@ static void copy_image(CmdBufferRecorder& recorder, FrameGraphImageId src, Frame
 
 [[maybe_unused]]
 static void copy_images(CmdBufferRecorder& recorder, core::Span<std::pair<FrameGraphImageId, FrameGraphMutableImageId>> copies,
-                        core::FlatHashMap<FrameGraphResourceId, PipelineStage>& to_barrier, const FrameGraphFrameResources& resources) {
+                        memory::FlatHashMap<FrameGraphResourceId, PipelineStage>& to_barrier, const FrameGraphFrameResources& resources) {
 
     for(auto [src, dst] : copies) {
         copy_image(recorder, src, dst, to_barrier, resources);
@@ -144,7 +144,14 @@ FrameGraphRegion::~FrameGraphRegion() {
 FrameGraphRegion::FrameGraphRegion(FrameGraph* parent, usize index) : _parent(parent), _index(index) {
 }
 
-FrameGraph::FrameGraph(std::shared_ptr<FrameGraphResourcePool> pool) : _resources(std::make_unique<FrameGraphFrameResources>(std::move(pool))) {
+FrameGraph::FrameGraph(std::shared_ptr<FrameGraphResourcePool> pool) :
+        _allocator(64 * 1024),
+        _resources(std::make_unique<FrameGraphFrameResources>(std::move(pool))),
+        _passes(_allocator),
+        _images(_allocator),
+        _buffers(_allocator),
+        _image_copies(_allocator),
+        _regions(_allocator) {
 }
 
 FrameGraph::~FrameGraph() {
@@ -156,7 +163,7 @@ const FrameGraphFrameResources& FrameGraph::resources() const {
 
 FrameGraphRegion FrameGraph::region(std::string_view name) {
     const usize index = _regions.size();
-    _regions.emplace_back(Region{name, _pass_index + 1, _pass_index + 1});
+    _regions.emplace_back(Region{core::String(name, _allocator), _pass_index + 1, _pass_index + 1});
     return FrameGraphRegion(this, index);
 }
 
@@ -225,7 +232,7 @@ void FrameGraph::render(CmdBufferRecorder& recorder) {
     usize copy_index = 0;
     std::sort(_image_copies.begin(), _image_copies.end(), [&](const auto& a, const auto& b) { return a.pass_index < b.pass_index; });
 
-    core::FlatHashMap<FrameGraphResourceId, PipelineStage> to_barrier;
+    memory::FlatHashMap<FrameGraphResourceId, PipelineStage> to_barrier(_allocator);
     to_barrier.set_min_capacity(_images.size() + _buffers.size());
 
     {
@@ -464,27 +471,9 @@ void FrameGraph::register_image_copy(FrameGraphMutableImageId dst, FrameGraphIma
 InlineDescriptor FrameGraph::copy_inline_descriptor(InlineDescriptor desc) {
     const usize desc_word_size = desc.size_in_words();
 
-    for(InlineStorage& storage : _inline_storage) {
-        if(storage.storage.size() - storage.used < desc_word_size) {
-            continue;
-        }
-
-        u32* begin = storage.storage.data() + storage.used;
-        const InlineDescriptor ret(core::Span<u32>(begin, desc_word_size));
-        std::copy_n(desc.words(), desc_word_size, begin);
-        storage.used += desc_word_size;
-        return ret;
-    }
-
-    // 64KB blocks
-    const usize size = std::max(usize(16 * 1024), desc_word_size);
-    InlineStorage& storage = _inline_storage.emplace_back(size);
-
-    u32* begin = storage.storage.data() + storage.used;
-    const InlineDescriptor ret(core::Span<u32>(begin, desc_word_size));
+    u32* begin = static_cast<u32*>(_allocator.allocate(desc_word_size * sizeof(u32), alignof(u32)));
     std::copy_n(desc.words(), desc_word_size, begin);
-    storage.used += desc_word_size;
-    return ret;
+    return InlineDescriptor(core::Span<u32>(begin, desc_word_size));
 }
 
 void FrameGraph::map_buffer(FrameGraphMutableBufferId res, const FrameGraphPass* pass) {
@@ -494,6 +483,10 @@ void FrameGraph::map_buffer(FrameGraphMutableBufferId res, const FrameGraphPass*
     info.register_use(pass->_index, true);
 }
 
+memory::PolymorphicAllocatorBase& FrameGraph::allocator() {
+    return _allocator;
+}
+
 bool FrameGraph::is_attachment(FrameGraphImageId res) const {
     const auto& info = check_exists(_images, res);
     return (info.usage & ImageUsage::Attachment) != ImageUsage::None;
@@ -27,6 +27,8 @@ SOFTWARE.
 #include <y/core/Vector.h>
 #include <y/core/String.h>
 #include <y/core/HashMap.h>
+#include <y/memory/containers.h>
+#include <y/memory/MonotonicAllocator.h>
 
 #include <memory>
 
@@ -88,13 +90,6 @@ class FrameGraph : NonMovable {
         FrameGraphImageId src;
     };
 
-    struct InlineStorage {
-        InlineStorage(usize size) : storage(size) {}
-
-        core::FixedArray<u32> storage;
-        usize used = 0;
-    };
-
     static constexpr bool allow_image_aliasing = true;
 
     public:
@@ -148,20 +143,25 @@ class FrameGraph : NonMovable {
         void alloc_resources();
         void alloc_image(FrameGraphImageId res, const ImageCreateInfo& info) const;
 
+        memory::PolymorphicAllocatorBase& allocator();
+
+        // Everything the graph and its passes allocate only lives for one frame:
+        // it comes from a single chained arena instead of thousands of small heap allocations.
+        memory::MonotonicAllocator _allocator;
+
         std::unique_ptr<FrameGraphFrameResources> _resources;
 
-        core::Vector<std::unique_ptr<FrameGraphPass>> _passes;
+        memory::Vector<std::unique_ptr<FrameGraphPass>> _passes;
 
         using hash_t = std::hash<FrameGraphResourceId>;
-        core::Vector<std::pair<FrameGraphMutableImageId, ImageCreateInfo>> _images;
-        core::Vector<std::pair<FrameGraphMutableBufferId, BufferCreateInfo>> _buffers;
+        memory::Vector<std::pair<FrameGraphMutableImageId, ImageCreateInfo>> _images;
+        memory::Vector<std::pair<FrameGraphMutableBufferId, BufferCreateInfo>> _buffers;
 
-        core::Vector<ImageCopyInfo> _image_copies;
-        core::Vector<InlineStorage> _inline_storage;
+        memory::Vector<ImageCopyInfo> _image_copies;
 
         usize _pass_index = 0;
 
-        core::Vector<Region> _regions;
+        memory::Vector<Region> _regions;
 
 };
 
@@ -30,7 +30,15 @@ SOFTWARE.
 
 namespace yave {
 
-FrameGraphPass::FrameGraphPass(std::string_view name, FrameGraph* parent, usize index) : _name(name), _parent(parent), _index(index) {
+FrameGraphPass::FrameGraphPass(std::string_view name, FrameGraph* parent, usize index) :
+        _name(name, parent->allocator()),
+        _parent(parent),
+        _index(index),
+        _images(parent->allocator()),
+        _buffers(parent->allocator()),
+        _bindings(parent->allocator()),
+        _descriptor_sets(parent->allocator()),
+        _colors(parent->allocator()) {
 }
 
 const core::String& FrameGraphPass::name() const {
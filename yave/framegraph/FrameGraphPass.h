@@ -30,7 +30,7 @@ SOFTWARE.
 #include <yave/graphics/barriers/PipelineStage.h>
 
 #include <y/core/String.h>
-#include <y/core/HashMap.h>
+#include <y/memory/containers.h>
 
 namespace yave {
 
@@ -72,14 +72,14 @@ class FrameGraphPass final : NonMovable {
         const usize _index;
 
         using hash_t = std::hash<FrameGraphResourceId>;
-        core::FlatHashMap<FrameGraphImageId, ResourceUsageInfo, hash_t> _images;
-        core::FlatHashMap<FrameGraphBufferId, ResourceUsageInfo, hash_t> _buffers;
+        memory::FlatHashMap<FrameGraphImageId, ResourceUsageInfo, hash_t> _images;
+        memory::FlatHashMap<FrameGraphBufferId, ResourceUsageInfo, hash_t> _buffers;
 
-        core::Vector<core::Vector<FrameGraphDescriptorBinding>> _bindings;
-        core::Vector<DescriptorSet> _descriptor_sets;
+        memory::Vector<memory::Vector<FrameGraphDescriptorBinding>> _bindings;
+        memory::Vector<DescriptorSet> _descriptor_sets;
 
         Attachment _depth;
-        core::Vector<Attachment> _colors;
+        memory::Vector<Attachment> _colors;
 
         Framebuffer _framebuffer;
 };
@@ -181,7 +181,7 @@ void FrameGraphPassBuilder::add_descriptor_binding(Descriptor bind, usize ds_ind
 
 usize FrameGraphPassBuilder::next_descriptor_set_index() {
     auto& bindings = _pass->_bindings;
-    bindings.emplace_back();
+    bindings.emplace_back(parent()->allocator());
     return bindings.size() - 1;
 }
 
@@ -212,7 +212,9 @@ void FrameGraphPassBuilder::add_to_pass(FrameGraphBufferId res, BufferUsage usag
 
 void FrameGraphPassBuilder::add_uniform(FrameGraphDescriptorBinding binding, usize ds_index) {
     auto& bindings = _pass->_bindings;
-    bindings.set_min_size(ds_index + 1);
+    while(bindings.size() <= ds_index) {
+        bindings.emplace_back(parent()->allocator());
+    }
     bindings[ds_index].push_back(binding);
 }
 
@@ -113,9 +113,8 @@ ImageData::ImageData(const math::Vec2ui& size, const void* data, ImageFormat for
         _format(format),
         _mips(u32(mips)) {
 
-    const usize data_size = byte_size();
-    _data = core::FixedArray<byte>(data_size);
-    std::memcpy(_data.data(), data, data_size);
+    const byte* data_bytes = static_cast<const byte*>(data);
+    _data.to_owned().assign(data_bytes, data_bytes + byte_size());
 }
 
 }
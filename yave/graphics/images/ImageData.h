@@ -25,6 +25,7 @@ SOFTWARE.
 #include <y/reflect/reflect.h>
 #include <y/math/Vec.h>
 #include <y/core/FixedArray.h>
+#include <y/core/BorrowableVector.h>
 
 #include "ImageFormat.h"
 
@@ -70,7 +71,8 @@ class ImageData : NonCopyable {
 
         u32 _mips = 1;
 
-        core::FixedArray<byte> _data;
+        // Borrowed from the asset file when loaded from a mapped store
+        core::BorrowableVector<byte, core::FixedArray<byte>> _data;
 };
 
 }
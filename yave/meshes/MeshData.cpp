@@ -50,14 +50,17 @@ void MeshData::add_sub_mesh(core::Span<PackedVertex> vertices, core::Span<Indexe
     y_debug_assert(!vertices.is_empty());
     y_debug_assert(!triangles.is_empty());
 
-    const u32 vertex_offset = u32(_vertices.size());
-    const u32 first_triangle = u32(_triangles.size());
+    core::Vector<PackedVertex>& all_vertices = _vertices.to_owned();
+    core::Vector<IndexedTriangle>& all_triangles = _triangles.to_owned();
 
-    _vertices.set_min_capacity(_vertices.size() + vertices.size());
-    _triangles.set_min_capacity(_triangles.size() + triangles.size());
+    const u32 vertex_offset = u32(all_vertices.size());
+    const u32 first_triangle = u32(all_triangles.size());
 
-    std::copy(vertices.begin(), vertices.end(), std::back_inserter(_vertices));
-    std::transform(triangles.begin(), triangles.end(), std::back_inserter(_triangles), [=](IndexedTriangle tri) {
+    all_vertices.set_min_capacity(all_vertices.size() + vertices.size());
+    all_triangles.set_min_capacity(all_triangles.size() + triangles.size());
+
+    std::copy(vertices.begin(), vertices.end(), std::back_inserter(all_vertices));
+    std::transform(triangles.begin(), triangles.end(), std::back_inserter(all_triangles), [=](IndexedTriangle tri) {
         return IndexedTriangle {
             tri[0] + vertex_offset,
             tri[1] + vertex_offset,
@@ -26,6 +26,7 @@ SOFTWARE.
 #include "AABB.h"
 
 #include <y/reflect/reflect.h>
+#include <y/core/BorrowableVector.h>
 
 #include <memory>
 
@@ -71,8 +72,9 @@ class MeshData {
 
         AABB _aabb;
 
-        core::Vector<PackedVertex> _vertices;
-        core::Vector<IndexedTriangle> _triangles;
+        // Borrowed from the asset file when loaded from a mapped store
+        core::BorrowableVector<PackedVertex> _vertices;
+        core::BorrowableVector<IndexedTriangle> _triangles;
         core::Vector<SubMesh> _sub_meshes;
 
         std::unique_ptr<SkeletonData> _skeleton;
@@ -144,34 +144,82 @@ static FrameGraphMutableImageId ambient_pass(FrameGraph& framegraph,
 
 
 
+// Lights are culled in parallel by blocks, then written in query order at the offset of their block.
+// This keeps the same lights from one frame to the next when there are more than max_count of them.
+// Returns the number of visible lights, which can be more than max_count.
+template<typename Q, typename V, typename W>
+static u32 gather_lights(Q& query, usize max_count, V&& is_visible, W&& write) {
+    static constexpr usize block_size = 256;
+
+    const usize size = query.size();
+    const usize block_count = (size + block_size - 1) / block_size;
+
+    core::Vector<u8> visible(size, u8(0));
+    core::Vector<u32> offsets(block_count + 1, u32(0));
+    concurrent::parallel_for(0, block_count, 1, [&](usize block) {
+        const usize begin = block * block_size;
+        usize i = begin;
+        u32 count = 0;
+        for(const auto& id_comp : query.chunk(begin, std::min(size, begin + block_size))) {
+            if(is_visible(id_comp)) {
+                visible[i] = 1;
+                ++count;
+            }
+            ++i;
+        }
+        offsets[block + 1] = count;
+    });
+
+    for(usize block = 0; block != block_count; ++block) {
+        offsets[block + 1] += offsets[block];
+    }
+
+    concurrent::parallel_for(0, block_count, 1, [&](usize block) {
+        const usize begin = block * block_size;
+        usize i = begin;
+        usize index = offsets[block];
+        for(const auto& id_comp : query.chunk(begin, std::min(size, begin + block_size))) {
+            if(index >= max_count) {
+                break;
+            }
+            if(visible[i++]) {
+                write(id_comp, index++);
+            }
+        }
+    });
+
+    return offsets[block_count];
+}
+
 static u32 fill_point_light_buffer(uniform::PointLight* points, const SceneView& scene) {
     y_profile();
 
     Y_TODO(Use octree)
     const Frustum frustum = scene.camera().frustum();
 
-    u32 count = 0;
-
     const std::array tags = {ecs::tags::not_hidden};
-    for(auto point : scene.world().query<TransformableComponent, PointLightComponent>(tags)) {
-        const auto& [t, l] = point.components();
+    auto point_lights = scene.world().cached_query<TransformableComponent, PointLightComponent>(tags);
 
-        const float scaled_radius = l.radius() * t.transform().scale().max_component();
-        if(!frustum.is_inside(t.position(), scaled_radius)) {
-            continue;
-        }
+    const auto scaled_radius = [](const TransformableComponent& t, const PointLightComponent& l) {
+        return l.radius() * t.transform().scale().max_component();
+    };
 
-        points[count++] = {
+    const u32 count = gather_lights(point_lights, max_point_lights, [&](const auto& point) {
+        const auto& [t, l] = point.components();
+        return frustum.is_inside(t.position(), scaled_radius(t, l));
+    }, [&](const auto& point, usize index) {
+        const auto& [t, l] = point.components();
+        points[index] = {
             t.position(),
-            scaled_radius,
+            scaled_radius(t, l),
             l.color() * l.intensity(),
             std::max(math::epsilon<float>, l.falloff())
         };
+    });
 
-        if(count == max_point_lights) {
-            log_msg("Too many point lights, discarding...", Log::Warning);
-            break;
-        }
+    if(count > max_point_lights) {
+        log_msg("Too many point lights, discarding...", Log::Warning);
+        return u32(max_point_lights);
     }
     return count;
 }
@@ -190,15 +238,19 @@ static u32 fill_spot_light_buffer(
     Y_TODO(Use octree)
     const Frustum frustum = scene.camera().frustum();
 
-    u32 count = 0;
-
     const std::array tags = {ecs::tags::not_hidden};
-    for(auto spot : scene.world().query<TransformableComponent, SpotLightComponent>(tags)) {
-        const auto& [t, l] = spot.components();
+    auto spot_lights = scene.world().cached_query<TransformableComponent, SpotLightComponent>(tags);
+
+    struct SpotBounds {
+        math::Vec3 forward;
+        float scaled_radius;
+        math::Vec3 encl_sphere_center;
+        float encl_sphere_radius;
+    };
 
+    const auto compute_bounds = [](const TransformableComponent& t, const SpotLightComponent& l) {
         const math::Vec3 forward = t.forward().normalized();
         const float scale = t.transform().scale().max_component();
-        const float scaled_radius = l.radius() * scale;
 
         auto enclosing_sphere = l.enclosing_sphere();
         {
@@ -206,10 +258,21 @@ static u32 fill_spot_light_buffer(
             enclosing_sphere.radius *= scale;
         }
 
-        const math::Vec3 encl_sphere_center =  t.position() + forward * enclosing_sphere.dist_to_center;
-        if(!frustum.is_inside(encl_sphere_center, enclosing_sphere.radius)) {
-            continue;
-        }
+        return SpotBounds {
+            forward,
+            l.radius() * scale,
+            t.position() + forward * enclosing_sphere.dist_to_center,
+            enclosing_sphere.radius
+        };
+    };
+
+    const u32 count = gather_lights(spot_lights, max_spot_lights, [&](const auto& spot) {
+        const auto& [t, l] = spot.components();
+        const SpotBounds bounds = compute_bounds(t, l);
+        return frustum.is_inside(bounds.encl_sphere_center, bounds.encl_sphere_radius);
+    }, [&](const auto& spot, usize index) {
+        const auto& [t, l] = spot.components();
+        const SpotBounds bounds = compute_bounds(t, l);
 
         u32 shadow_index = u32(-1);
         if(l.cast_shadow() && render_shadows) {
@@ -219,31 +282,30 @@ static u32 fill_spot_light_buffer(
         }
 
         if constexpr(Transforms) {
-            const float geom_radius = scaled_radius * 1.1f;
+            const float geom_radius = bounds.scaled_radius * 1.1f;
             const float two_tan_angle = std::tan(l.half_angle()) * 2.0f;
-            transforms[count] = t.transform().non_uniformly_scaled(math::Vec3(two_tan_angle, 1.0f, two_tan_angle) * geom_radius);
+            transforms[index] = t.transform().non_uniformly_scaled(math::Vec3(two_tan_angle, 1.0f, two_tan_angle) * geom_radius);
         }
 
-        spots[count++] = {
+        spots[index] = {
             t.position(),
-            scaled_radius,
+            bounds.scaled_radius,
             l.color() * l.intensity(),
             std::max(math::epsilon<float>, l.falloff()),
-            forward,
+            bounds.forward,
             std::cos(l.half_angle()),
-            encl_sphere_center,
-            enclosing_sphere.radius,
+            bounds.encl_sphere_center,
+            bounds.encl_sphere_radius,
             std::max(math::epsilon<float>, l.angle_exponent()),
             shadow_index,
             {}
         };
+    });
 
-        if(count == max_spot_lights) {
-            log_msg("Too many spot lights, discarding...", Log::Warning);
-            break;
-        }
+    if(count > max_spot_lights) {
+        log_msg("Too many spot lights, discarding...", Log::Warning);
+        return u32(max_spot_lights);
     }
-
     return count;
 }
 
@@ -72,9 +72,18 @@ static usize render_world(const SceneRenderSubPass* sub_pass, RenderPassRecorder
     recorder.set_main_descriptor_set(descriptor_set);
     recorder.bind_per_instance_attrib_buffers(transforms);
 
-    auto render_query = [&](auto query) {
+    auto render_query = [&](auto&& query) {
+        // Transforms are uploaded in parallel, recording stays on this thread
+        const usize first = index;
+        concurrent::parallel_for_chunks(0, query.size(), query.default_grain, [&](usize b, usize e) {
+            usize i = first + b;
+            for(const auto& id_comp : query.chunk(b, e)) {
+                const auto& [tr, mesh] = id_comp.components();
+                transform_mapping[i++] = tr.transform();
+            }
+        });
+
         for(const auto& [tr, mesh] : query.components()) {
-            transform_mapping[index] = tr.transform();
             mesh.render(recorder, Renderable::SceneData{u32(index)});
             ++index;
         }
@@ -85,7 +94,7 @@ static usize render_world(const SceneRenderSubPass* sub_pass, RenderPassRecorder
         const core::Vector<ecs::EntityId> visible = octree_system->octree().find_entities(camera.frustum(), camera.far_plane_dist());
         render_query(world.query<TransformableComponent, StaticMeshComponent>(visible, tags));
     } else {
-        render_query(world.query<TransformableComponent, StaticMeshComponent>(tags));
+        render_query(world.cached_query<TransformableComponent, StaticMeshComponent>(tags));
     }
 
     y_profile_msg(fmt_c_str("% meshes", index));
@@ -127,7 +127,7 @@ void bind_ecs_types(sol::state_view state) {
         };
 
         type["query"] = [](const ecs::EntityWorld& world, sol::variadic_args va) -> core::Vector<ecs::EntityId> {
-            core::ScratchVector<core::String> tags(va.size());
+            core::ScratchVector<ecs::Tag> tags(va.size());
             for(auto v : va) {
                 tags.emplace_back(v.as<std::string_view>());
             }
@@ -142,8 +142,8 @@ void bind_ecs_types(sol::state_view state) {
             return type_names;
         };
 
-        type["add_tag"] = &ecs::EntityWorld::add_tag;
-        type["remove_tag"] = &ecs::EntityWorld::remove_tag;
+        type["add_tag"] = [](ecs::EntityWorld& world, ecs::EntityId id, std::string_view tag) { world.add_tag(id, tag); };
+        type["remove_tag"] = [](ecs::EntityWorld& world, ecs::EntityId id, std::string_view tag) { world.remove_tag(id, tag); };
     }
 }
 
@@ -29,6 +29,7 @@ SOFTWARE.
 namespace yave {
 
 ASUpdateSystem::ASUpdateSystem() : ecs::System("ASUpdateSystem") {
+    declare_access<ecs::Mutate<RayTracingComponent>, StaticMeshComponent>();
 }
 
 void ASUpdateSystem::setup(ecs::EntityWorld& world) {
@@ -47,14 +48,24 @@ void ASUpdateSystem::run_tick(ecs::EntityWorld& world, bool only_recent) {
         return;
     }
 
-    const core::Span<ecs::EntityId> rt_ids = only_recent
-        ? world.recently_added<RayTracingComponent>()
-        : world.component_ids<RayTracingComponent>();
+    if(only_recent) {
+        for(const ecs::EntityId id : world.recently_added<RayTracingComponent>()) {
+            _to_update.insert(id);
+        }
 
-    _to_update.push_back(rt_ids.begin(), rt_ids.end());
+        // Meshes that changed since the last tick need their acceleration structures to be rebuilt
+        const core::Vector<ecs::EntityId> changed = world.query<RayTracingComponent, ecs::Changed<StaticMeshComponent>>().ids();
+        for(const ecs::EntityId id : changed) {
+            _to_update.insert(id);
+        }
+    } else {
+        for(const ecs::EntityId id : world.component_ids<RayTracingComponent>()) {
+            _to_update.insert(id);
+        }
+    }
 
     auto to_keep = core::vector_with_capacity<ecs::EntityId>(_to_update.size());
-    for(auto&& id_comp : world.query<ecs::Mutate<RayTracingComponent>, StaticMeshComponent>(_to_update)) {
+    for(auto&& id_comp : world.query<ecs::Mutate<RayTracingComponent>, StaticMeshComponent>(_to_update.ids())) {
         const StaticMeshComponent& mesh = id_comp.component<StaticMeshComponent>();
         if(!mesh.is_fully_loaded()) {
             to_keep << id_comp.id();
@@ -64,7 +75,10 @@ void ASUpdateSystem::run_tick(ecs::EntityWorld& world, bool only_recent) {
         id_comp.component<RayTracingComponent>() = RayTracingComponent(mesh);
     }
 
-    _to_update.swap(to_keep);
+    _to_update.clear();
+    for(const ecs::EntityId id : to_keep) {
+        _to_update.insert(id);
+    }
 }
 
 }
@@ -23,6 +23,7 @@ SOFTWARE.
 #define YAVE_SYSTEMS_ASUPDATESYSTEM_H
 
 #include <yave/ecs/System.h>
+#include <yave/ecs/SparseComponentSet.h>
 
 #include <y/core/Vector.h>
 
@@ -39,7 +40,8 @@ class ASUpdateSystem : public ecs::System {
     private:
         void run_tick(ecs::EntityWorld& world, bool only_recent);
 
-        core::Vector<ecs::EntityId> _to_update;
+        // A set, since an entity can be added and changed in the same tick, or still be waiting for its mesh
+        ecs::SparseIdSet _to_update;
 };
 
 }
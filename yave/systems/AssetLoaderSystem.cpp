@@ -29,6 +29,9 @@ namespace yave {
 AssetLoaderSystem::LoadableComponentTypeInfo* AssetLoaderSystem::_first_info = nullptr;
 
 AssetLoaderSystem::AssetLoaderSystem(AssetLoader& loader) : ecs::System("AssetLoaderSystem"), _loader(&loader) {
+    for(const LoadableComponentTypeInfo* info = _first_info; info; info = info->next) {
+        declare_access(info->type, true);
+    }
 }
 
 void AssetLoaderSystem::setup(ecs::EntityWorld& world) {
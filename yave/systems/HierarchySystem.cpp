@@ -0,0 +1,269 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "HierarchySystem.h"
+
+#include <yave/components/HierarchyComponent.h>
+#include <yave/components/TransformableComponent.h>
+#include <yave/ecs/EntityWorld.h>
+
+#include <y/concurrent/parallel.h>
+
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <algorithm>
+
+namespace yave {
+
+// Levels smaller than this are processed on the calling thread
+static constexpr usize propagation_grain = 1024;
+
+HierarchySystem::HierarchySystem() : ecs::System("HierarchySystem") {
+    declare_access<ecs::Mutate<TransformableComponent>, HierarchyComponent>();
+}
+
+void HierarchySystem::setup(ecs::EntityWorld& world) {
+    run_tick(world, true);
+}
+
+void HierarchySystem::tick(ecs::EntityWorld& world) {
+    run_tick(world, false);
+}
+
+core::Span<ecs::EntityId> HierarchySystem::sorted_ids() const {
+    return _ids;
+}
+
+usize HierarchySystem::depth() const {
+    return _levels.is_empty() ? 0 : _levels.size() - 1;
+}
+
+void HierarchySystem::run_tick(ecs::EntityWorld& world, bool update_all) {
+    y_profile();
+
+    const core::Vector<ecs::EntityId> changed = world.query<ecs::Changed<HierarchyComponent>>().ids();
+
+    if(update_all || needs_rebuild(world, changed)) {
+        rebuild(world);
+
+        // Updating the roots updates everything
+        core::Vector<u32> roots;
+        if(depth()) {
+            for(u32 slot = 0; slot != _levels[1]; ++slot) {
+                roots << slot;
+            }
+        }
+        propagate(world, roots);
+    } else if(!changed.is_empty()) {
+        auto changed_slots = core::vector_with_capacity<u32>(changed.size());
+        for(const ecs::EntityId id : changed) {
+            const u32 slot = slot_of(id);
+            y_debug_assert(slot != invalid_slot);
+            changed_slots << slot;
+        }
+
+        // Slots are sorted by depth
+        std::sort(changed_slots.begin(), changed_slots.end());
+        propagate(world, changed_slots);
+    }
+}
+
+bool HierarchySystem::needs_rebuild(const ecs::EntityWorld& world, core::Span<ecs::EntityId> changed) const {
+    const auto& hierarchy = world.component_set<HierarchyComponent>();
+    if(hierarchy.version() != _version) {
+        // Entities were added or removed
+        return true;
+    }
+
+    for(const ecs::EntityId id : changed) {
+        const u32 slot = slot_of(id);
+        if(slot == invalid_slot) {
+            return true;
+        }
+
+        const ecs::EntityId parent = hierarchy[id].parent();
+        const ecs::EntityId linked_parent = hierarchy.contains(parent) ? parent : ecs::EntityId();
+        const ecs::EntityId current_parent = _parents[slot] == invalid_slot ? ecs::EntityId() : _ids[_parents[slot]];
+        if(linked_parent != current_parent) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void HierarchySystem::rebuild(const ecs::EntityWorld& world) {
+    y_profile();
+
+    const auto& hierarchy = world.component_set<HierarchyComponent>();
+    const core::Span<ecs::EntityId> ids = hierarchy.ids();
+    const core::Span<HierarchyComponent> components = hierarchy.values();
+    const usize count = ids.size();
+
+    // Parents and children are first found by dense index in the component set
+    core::Vector<u32> parents(count, invalid_slot);
+    core::Vector<u32> child_offsets(count + 1, 0);
+    for(usize i = 0; i != count; ++i) {
+        const u32 parent = hierarchy.dense_index_of(components[i].parent());
+        parents[i] = parent;
+        if(parent != invalid_slot) {
+            ++child_offsets[parent + 1];
+        }
+    }
+    for(usize i = 0; i != count; ++i) {
+        child_offsets[i + 1] += child_offsets[i];
+    }
+
+    core::Vector<u32> children(count, invalid_slot);
+    {
+        core::Vector<u32> cursors(child_offsets.begin(), child_offsets.end() - 1);
+        for(usize i = 0; i != count; ++i) {
+            if(parents[i] != invalid_slot) {
+                children[cursors[parents[i]]++] = u32(i);
+            }
+        }
+    }
+
+    // Breadth first traversal, starting from all the roots
+    auto order = core::vector_with_capacity<u32>(count);
+    for(usize i = 0; i != count; ++i) {
+        if(parents[i] == invalid_slot) {
+            order << u32(i);
+        }
+    }
+
+    _first_children.make_empty();
+    _child_counts.make_empty();
+    _levels.make_empty();
+    for(usize begin = 0, end = order.size(); begin != end; begin = end, end = order.size()) {
+        _levels << u32(begin);
+        for(usize i = begin; i != end; ++i) {
+            const u32 node = order[i];
+            _first_children << u32(order.size());
+            _child_counts << (child_offsets[node + 1] - child_offsets[node]);
+            order.push_back(children.begin() + child_offsets[node], children.begin() + child_offsets[node + 1]);
+        }
+    }
+    _levels << u32(order.size());
+
+    if(order.size() != count) {
+        log_msg(fmt("% entities are in or below a parenting cycle and will not be updated", count - order.size()), Log::Warning);
+    }
+
+    core::Vector<u32> slots(count, invalid_slot);
+    for(usize slot = 0; slot != order.size(); ++slot) {
+        slots[order[slot]] = u32(slot);
+    }
+
+    _ids.make_empty();
+    _parents.make_empty();
+    _slots.clear();
+    for(usize slot = 0; slot != order.size(); ++slot) {
+        const u32 node = order[slot];
+        _ids << ids[node];
+        _parents << (parents[node] == invalid_slot ? invalid_slot : slots[parents[node]]);
+        _slots.set(ids[node].index(), u32(slot));
+    }
+
+    _world_transforms.make_empty();
+    _world_transforms.set_min_size(order.size());
+    _stamps.make_empty();
+    _stamps.set_min_size(order.size(), u32(0));
+    _stamp = 0;
+
+    _version = hierarchy.version();
+}
+
+void HierarchySystem::propagate(ecs::EntityWorld& world, core::Span<u32> changed_slots) {
+    y_profile();
+
+    _updated.make_empty();
+    ++_stamp;
+
+    const auto visit = [this](u32 slot) {
+        if(_stamps[slot] != _stamp) {
+            _stamps[slot] = _stamp;
+            _updated << slot;
+        }
+    };
+
+    const auto& hierarchy = world.component_set<HierarchyComponent>();
+
+    usize next_changed = 0;
+    usize parent_begin = 0;
+    usize parent_end = 0;
+    for(usize level = 0; level != depth(); ++level) {
+        const usize begin = _updated.size();
+
+        // Children of the entities updated at the previous level, followed by the entities of this level that changed
+        for(usize i = parent_begin; i != parent_end; ++i) {
+            const u32 parent = _updated[i];
+            for(u32 k = 0; k != _child_counts[parent]; ++k) {
+                visit(_first_children[parent] + k);
+            }
+        }
+        for(; next_changed != changed_slots.size() && changed_slots[next_changed] < _levels[level + 1]; ++next_changed) {
+            visit(changed_slots[next_changed]);
+        }
+
+        const usize end = _updated.size();
+        if(begin == end && next_changed == changed_slots.size()) {
+            break;
+        }
+
+        // Parents all belong to the previous level, so entities of the same level can be done in any order
+        concurrent::parallel_for_chunks(begin, end, propagation_grain, [&](usize b, usize e) {
+            for(usize i = b; i != e; ++i) {
+                const u32 slot = _updated[i];
+                const u32 parent = _parents[slot];
+                const math::Transform<>& local = hierarchy[_ids[slot]].local_transform();
+                _world_transforms[slot] = parent == invalid_slot ? local : math::Transform<>(_world_transforms[parent] * local);
+            }
+        });
+
+        parent_begin = begin;
+        parent_end = end;
+    }
+
+    if(_updated.is_empty()) {
+        return;
+    }
+
+    auto updated_ids = core::vector_with_capacity<ecs::EntityId>(_updated.size());
+    for(const u32 slot : _updated) {
+        updated_ids << _ids[slot];
+    }
+
+    // TransformableComponent can't be modified in parallel: moving it touches its octree node
+    for(auto&& id_comp : world.query<ecs::Mutate<TransformableComponent>>(updated_ids)) {
+        id_comp.component<TransformableComponent>().set_transform(_world_transforms[slot_of(id_comp.id())]);
+    }
+}
+
+u32 HierarchySystem::slot_of(ecs::EntityId id) const {
+    const u32 slot = _slots[id.index()];
+    return slot != invalid_slot && _ids[slot] == id ? slot : invalid_slot;
+}
+
+}
+
@@ -0,0 +1,82 @@
+/*******************************
+Copyright (c) 2016-2022 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_SYSTEMS_HIERARCHYSYSTEM_H
+#define YAVE_SYSTEMS_HIERARCHYSYSTEM_H
+
+#include <yave/ecs/System.h>
+#include <yave/ecs/SparseComponentSet.h>
+
+#include <y/core/Vector.h>
+#include <y/math/Transform.h>
+
+namespace yave {
+
+// Computes the world transforms of entities with a HierarchyComponent.
+// Entities are kept sorted by depth in breadth first order, so that the children of an entity are contiguous
+// and each level only depends on the previous one. Only the subtrees of entities that changed since the last tick are updated,
+// one level at a time, with the entities of a level processed in parallel.
+// Systems that modify hierarchies should run before this one, changes are forgotten at the end of the tick.
+class HierarchySystem : public ecs::System {
+    public:
+        HierarchySystem();
+
+        void setup(ecs::EntityWorld& world) override;
+        void tick(ecs::EntityWorld& world) override;
+
+        // Entities of the hierarchy, sorted by depth
+        core::Span<ecs::EntityId> sorted_ids() const;
+
+        usize depth() const;
+
+    private:
+        static constexpr u32 invalid_slot = u32(-1);
+
+        void run_tick(ecs::EntityWorld& world, bool update_all);
+
+        bool needs_rebuild(const ecs::EntityWorld& world, core::Span<ecs::EntityId> changed) const;
+        void rebuild(const ecs::EntityWorld& world);
+        void propagate(ecs::EntityWorld& world, core::Span<u32> changed_slots);
+
+        u32 slot_of(ecs::EntityId id) const;
+
+        // Indexed by slot, in breadth first order
+        core::Vector<ecs::EntityId> _ids;
+        core::Vector<u32> _parents;
+        core::Vector<u32> _first_children;
+        core::Vector<u32> _child_counts;
+        core::Vector<math::Transform<>> _world_transforms;
+        core::Vector<u32> _stamps;
+
+        // First slot of each level, followed by the slot count
+        core::Vector<u32> _levels;
+
+        // Maps entity indices to slots
+        ecs::PagedSparseArray _slots;
+
+        core::Vector<u32> _updated;
+        u32 _stamp = 0;
+        u64 _version = u64(-1);
+};
+
+}
+
+#endif // YAVE_SYSTEMS_HIERARCHYSYSTEM_H
@@ -24,6 +24,9 @@ SOFTWARE.
 #include "AssetLoaderSystem.h"
 
 #include <yave/components/TransformableComponent.h>
+#include <yave/components/StaticMeshComponent.h>
+#include <yave/components/PointLightComponent.h>
+#include <yave/components/SpotLightComponent.h>
 #include <yave/ecs/EntityWorld.h>
 
 #include <yave/utils/entities.h>
@@ -51,6 +54,8 @@ static AABB find_aabb(const ecs::EntityWorld& world, ecs::EntityId id, const mat
 
 
 OctreeSystem::OctreeSystem() : ecs::System("OctreeSystem") {
+    // Reading StaticMeshComponent also keeps us after the AssetLoaderSystem (for recently_loaded)
+    declare_access<ecs::Mutate<TransformableComponent>, StaticMeshComponent, PointLightComponent, SpotLightComponent>();
 }
 
 void OctreeSystem::destroy(ecs::EntityWorld& world) {
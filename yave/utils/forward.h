@@ -82,6 +82,8 @@ class Framebuffer;
 class Frustum;
 class GenericAssetPtr;
 class GraphicPipeline;
+class HierarchyComponent;
+class HierarchySystem;
 class IBLProbe;
 class ImageBarrier;
 class ImageBase;
@@ -108,6 +110,7 @@ class Octree;
 class OctreeData;
 class OctreeNode;
 class OctreeSystem;
+class PackedAssetStore;
 class PendingOpsQueue;
 class PhysicalDevice;
 class PointLightComponent;